@@ -0,0 +1,91 @@
+#include "uint128_t.build"
+#include "int128_t.h"
+
+#include <cctype>
+
+int128_t::int128_t(const std::string & s, uint8_t base)
+    : int128_t(s.c_str(), s.size(), base)
+{}
+
+int128_t::int128_t(const char * s, std::size_t len, uint8_t base)
+    : VALUE(uint128_0)
+{
+    if (!s){
+        return;
+    }
+    while (len && *s && std::isspace(*s)){
+        ++s;
+        len--;
+    }
+    const bool minus = len && (*s == '-');
+    if (len && ((*s == '-') || (*s == '+'))){
+        ++s;
+        len--;
+    }
+    VALUE = uint128_t(s, len, base);
+    if (minus){
+        VALUE = -VALUE;
+    }
+}
+
+std::string int128_t::str(uint8_t base, const unsigned int & len) const{
+    const std::string digits = magnitude().str(base, len);
+    return negative()?("-" + digits):digits;
+}
+
+std::pair <int128_t, int128_t> int128_t::divmod(const int128_t & lhs, const int128_t & rhs){
+    const std::pair <uint128_t, uint128_t> qr = uint128_t::divmod(lhs.magnitude(), rhs.magnitude());
+    const int128_t q(qr.first);
+    const int128_t r(qr.second);
+    return std::pair <int128_t, int128_t> ((lhs.negative() != rhs.negative())?-q:q, lhs.negative()?-r:r);
+}
+
+std::pair <int128_t, int128_t> int128_t::floor_divmod(const int128_t & lhs, const int128_t & rhs){
+    std::pair <int128_t, int128_t> qr = divmod(lhs, rhs);
+    if (qr.second && (qr.second.negative() != rhs.negative())){
+        --qr.first;
+        qr.second += rhs;
+    }
+    return qr;
+}
+
+void int128_t::export_keys(const int128_t * in, std::size_t count, uint8_t * out){
+    for(std::size_t i = 0; i < count; i++, out += UINT128_KEY_SIZE){
+        in[i].export_key(out);
+    }
+}
+
+void int128_t::import_keys(const uint8_t * in, std::size_t count, int128_t * out){
+    for(std::size_t i = 0; i < count; i++, in += UINT128_KEY_SIZE){
+        out[i] = import_key(in);
+    }
+}
+
+std::size_t int128_t::export_varkeys(const int128_t * in, std::size_t count, uint8_t * out){
+    std::size_t written = 0;
+    for(std::size_t i = 0; i < count; i++){
+        written += in[i].export_varkey(out + written);
+    }
+    return written;
+}
+
+std::size_t int128_t::import_varkeys(const uint8_t * in, std::size_t len, int128_t * out, std::size_t count){
+    std::size_t read = 0;
+    for(std::size_t i = 0; i < count; i++){
+        read += import_varkey(in + read, len - read, out[i]);
+    }
+    return read;
+}
+
+std::ostream & operator<<(std::ostream & stream, const int128_t & rhs){
+    if (stream.flags() & stream.oct){
+        stream << rhs.str(8);
+    }
+    else if (stream.flags() & stream.dec){
+        stream << rhs.str(10);
+    }
+    else if (stream.flags() & stream.hex){
+        stream << rhs.str(16);
+    }
+    return stream;
+}
@@ -0,0 +1,663 @@
+/*
+int128_t.h
+A signed 128 bit integer type for C++, on top of uint128_t
+
+The value is stored as the uint128_t holding its two's complement. Addition, subtraction,
+multiplication, the bitwise operators and left shifts are the same operations on the bits
+as for uint128_t, so they call the uint128_t operators. Right shifts are arithmetic, and
+comparisons compare the upper halves as int64_t.
+
+Division runs uint128_t::divmod once on the magnitudes and then fixes the signs. operator/
+and operator% truncate toward zero like the builtin types, so a nonzero remainder has the
+sign of the dividend. floor_divmod rounds the quotient toward negative infinity instead, so
+a nonzero remainder has the sign of the divisor. str() writes a '-' and then the digits of
+the magnitude from uint128_t::str.
+
+Overflow wraps: -int128_min and int128_min / -1 are int128_min.
+
+Conversions between int128_t and uint128_t keep the bits and are explicit (uint128_t(x) or
+int128_t(u)), and so are conversions to the builtin types: with implicit conversions to both
+signed and unsigned types, most uses would be ambiguous. uint128_t specializes
+std::is_integral, so std::is_integral is deliberately not specialized for int128_t:
+otherwise the uint128_t operator templates would accept int128_t operands and silently mix
+signed and unsigned values. Mixing the two in one expression does not compile.
+
+export_bits writes the two's complement bytes. The binary keys are the uint128_t keys of the
+value with its sign bit flipped, which maps signed order onto unsigned order. After the flip
+only values near int128_min have leading zero bytes, so variable width keys of nearly all
+values take the full 17 bytes; they are there for a common format, not to save space.
+*/
+
+#ifndef __INT128_T__
+#define __INT128_T__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "uint128_t.h"
+
+class UINT128_T_EXTERN int128_t;
+
+namespace std {
+    template <> struct is_arithmetic <int128_t> : std::true_type {};
+    template <> struct is_signed     <int128_t> : std::true_type {};
+}
+
+// the builtin integer types; uint128_t also claims to be integral
+template <typename T>
+struct int128_integral : std::integral_constant <bool, std::is_integral <T>::value && !std::is_class <T>::value> {};
+
+class int128_t{
+    private:
+        uint128_t VALUE;
+
+    public:
+        // Constructors
+        int128_t() = default;
+        int128_t(const int128_t & rhs) = default;
+        int128_t(int128_t && rhs) = default;
+
+        // an optional sign, then the digits as for uint128_t (no prefixes)
+        int128_t(const std::string & s, uint8_t base);
+        int128_t(const char * s, std::size_t len, uint8_t base);
+
+        constexpr int128_t(const bool & b)
+            : VALUE(0, static_cast <uint64_t> (b))
+        {}
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        constexpr int128_t(const T & rhs)
+            : VALUE((std::is_signed <T>::value && (rhs < static_cast <T> (0)))?~0ULL:0ULL, static_cast <uint64_t> (rhs))
+        {}
+
+        template <typename S, typename T, typename = typename std::enable_if <int128_integral <S>::value && int128_integral <T>::value, void>::type>
+        constexpr int128_t(const S & upper_rhs, const T & lower_rhs)
+            : VALUE(static_cast <uint64_t> (upper_rhs), static_cast <uint64_t> (lower_rhs))
+        {}
+
+        // same bits
+        constexpr explicit int128_t(const uint128_t & rhs)
+            : VALUE(rhs)
+        {}
+
+        // Assignment Operator
+        int128_t & operator=(const int128_t & rhs) = default;
+        int128_t & operator=(int128_t && rhs) = default;
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator=(const T & rhs){
+            return *this = int128_t(rhs);
+        }
+
+        // Typecast Operators
+        explicit operator uint128_t() const{
+            return VALUE;
+        }
+
+        explicit operator bool() const{
+            return (bool) VALUE;
+        }
+
+        // the low bits, as for the builtin types
+        explicit operator int8_t()   const{ return static_cast <int8_t>   (VALUE.lower()); }
+        explicit operator int16_t()  const{ return static_cast <int16_t>  (VALUE.lower()); }
+        explicit operator int32_t()  const{ return static_cast <int32_t>  (VALUE.lower()); }
+        explicit operator int64_t()  const{ return static_cast <int64_t>  (VALUE.lower()); }
+        explicit operator uint8_t()  const{ return static_cast <uint8_t>  (VALUE.lower()); }
+        explicit operator uint16_t() const{ return static_cast <uint16_t> (VALUE.lower()); }
+        explicit operator uint32_t() const{ return static_cast <uint32_t> (VALUE.lower()); }
+        explicit operator uint64_t() const{ return VALUE.lower(); }
+
+        // Bitwise Operators
+        int128_t operator&(const int128_t & rhs) const{
+            return int128_t(VALUE & rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator&(const T & rhs) const{
+            return *this & int128_t(rhs);
+        }
+
+        int128_t & operator&=(const int128_t & rhs){
+            VALUE &= rhs.VALUE;
+            return *this;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator&=(const T & rhs){
+            return *this &= int128_t(rhs);
+        }
+
+        int128_t operator|(const int128_t & rhs) const{
+            return int128_t(VALUE | rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator|(const T & rhs) const{
+            return *this | int128_t(rhs);
+        }
+
+        int128_t & operator|=(const int128_t & rhs){
+            VALUE |= rhs.VALUE;
+            return *this;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator|=(const T & rhs){
+            return *this |= int128_t(rhs);
+        }
+
+        int128_t operator^(const int128_t & rhs) const{
+            return int128_t(VALUE ^ rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator^(const T & rhs) const{
+            return *this ^ int128_t(rhs);
+        }
+
+        int128_t & operator^=(const int128_t & rhs){
+            VALUE ^= rhs.VALUE;
+            return *this;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator^=(const T & rhs){
+            return *this ^= int128_t(rhs);
+        }
+
+        int128_t operator~() const{
+            return int128_t(~VALUE);
+        }
+
+        // Bit Shift Operators
+        // Shifts by a negative count or by 128 or more give 0, or -1 for a right shift of a
+        // negative value.
+        int128_t operator<<(const int128_t & rhs) const{
+            return int128_t(VALUE << rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator<<(const T & rhs) const{
+            return *this << int128_t(rhs);
+        }
+
+        int128_t & operator<<=(const int128_t & rhs){
+            return *this = *this << rhs;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator<<=(const T & rhs){
+            return *this = *this << int128_t(rhs);
+        }
+
+        // arithmetic
+        int128_t operator>>(const int128_t & rhs) const{
+            const uint64_t hi = VALUE.upper();
+            const uint64_t lo = VALUE.lower();
+            const uint64_t fill = (hi >> 63)?~0ULL:0ULL;
+            const uint64_t shift = rhs.VALUE.lower();
+            if (rhs.VALUE.upper() || (shift >= 128)){
+                return int128_t(fill, fill);
+            }
+            if (shift >= 64){
+                return int128_t(fill, (shift == 64)?hi:(uint64_t) (static_cast <int64_t> (hi) >> (shift - 64)));
+            }
+            if (shift == 0){
+                return *this;
+            }
+            return int128_t((uint64_t) (static_cast <int64_t> (hi) >> shift), (hi << (64 - shift)) | (lo >> shift));
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator>>(const T & rhs) const{
+            return *this >> int128_t(rhs);
+        }
+
+        int128_t & operator>>=(const int128_t & rhs){
+            return *this = *this >> rhs;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator>>=(const T & rhs){
+            return *this = *this >> int128_t(rhs);
+        }
+
+        // Logical Operators
+        bool operator!() const{
+            return !VALUE;
+        }
+
+        bool operator&&(const int128_t & rhs) const{
+            return ((bool) *this && (bool) rhs);
+        }
+
+        bool operator||(const int128_t & rhs) const{
+            return ((bool) *this || (bool) rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator&&(const T & rhs) const{
+            return ((bool) *this && rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator||(const T & rhs) const{
+            return ((bool) *this || rhs);
+        }
+
+        // Comparison Operators
+        bool operator==(const int128_t & rhs) const{
+            return ((VALUE.upper() == rhs.VALUE.upper()) && (VALUE.lower() == rhs.VALUE.lower()));
+        }
+
+        bool operator!=(const int128_t & rhs) const{
+            return !(*this == rhs);
+        }
+
+        bool operator<(const int128_t & rhs) const{
+            if (VALUE.upper() == rhs.VALUE.upper()){
+                return (VALUE.lower() < rhs.VALUE.lower());
+            }
+            return (static_cast <int64_t> (VALUE.upper()) < static_cast <int64_t> (rhs.VALUE.upper()));
+        }
+
+        bool operator>(const int128_t & rhs) const{
+            return rhs < *this;
+        }
+
+        bool operator<=(const int128_t & rhs) const{
+            return !(rhs < *this);
+        }
+
+        bool operator>=(const int128_t & rhs) const{
+            return !(*this < rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator==(const T & rhs) const{
+            return *this == int128_t(rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator!=(const T & rhs) const{
+            return *this != int128_t(rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator<(const T & rhs) const{
+            return *this < int128_t(rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator>(const T & rhs) const{
+            return *this > int128_t(rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator<=(const T & rhs) const{
+            return *this <= int128_t(rhs);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        bool operator>=(const T & rhs) const{
+            return *this >= int128_t(rhs);
+        }
+
+        // Arithmetic Operators
+        int128_t operator+(const int128_t & rhs) const{
+            return int128_t(VALUE + rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator+(const T & rhs) const{
+            return *this + int128_t(rhs);
+        }
+
+        int128_t & operator+=(const int128_t & rhs){
+            VALUE += rhs.VALUE;
+            return *this;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator+=(const T & rhs){
+            return *this += int128_t(rhs);
+        }
+
+        int128_t operator-(const int128_t & rhs) const{
+            return int128_t(VALUE - rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator-(const T & rhs) const{
+            return *this - int128_t(rhs);
+        }
+
+        int128_t & operator-=(const int128_t & rhs){
+            VALUE -= rhs.VALUE;
+            return *this;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator-=(const T & rhs){
+            return *this -= int128_t(rhs);
+        }
+
+        // the low 128 bits of the product are the same for signed and unsigned operands
+        int128_t operator*(const int128_t & rhs) const{
+            return int128_t(VALUE * rhs.VALUE);
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator*(const T & rhs) const{
+            return *this * int128_t(rhs);
+        }
+
+        int128_t & operator*=(const int128_t & rhs){
+            VALUE *= rhs.VALUE;
+            return *this;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator*=(const T & rhs){
+            return *this *= int128_t(rhs);
+        }
+
+        int128_t operator/(const int128_t & rhs) const{
+            return divmod(*this, rhs).first;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator/(const T & rhs) const{
+            return *this / int128_t(rhs);
+        }
+
+        int128_t & operator/=(const int128_t & rhs){
+            return *this = *this / rhs;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator/=(const T & rhs){
+            return *this = *this / int128_t(rhs);
+        }
+
+        int128_t operator%(const int128_t & rhs) const{
+            return divmod(*this, rhs).second;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t operator%(const T & rhs) const{
+            return *this % int128_t(rhs);
+        }
+
+        int128_t & operator%=(const int128_t & rhs){
+            return *this = *this % rhs;
+        }
+
+        template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+        int128_t & operator%=(const T & rhs){
+            return *this = *this % int128_t(rhs);
+        }
+
+        // Increment Operator
+        int128_t & operator++(){
+            ++VALUE;
+            return *this;
+        }
+
+        int128_t operator++(int){
+            const int128_t out(*this);
+            ++VALUE;
+            return out;
+        }
+
+        // Decrement Operator
+        int128_t & operator--(){
+            --VALUE;
+            return *this;
+        }
+
+        int128_t operator--(int){
+            const int128_t out(*this);
+            --VALUE;
+            return out;
+        }
+
+        int128_t operator+() const{
+            return *this;
+        }
+
+        int128_t operator-() const{
+            return int128_t(-VALUE);
+        }
+
+        // Get private values (the halves of the two's complement)
+        const uint64_t & upper() const{
+            return VALUE.upper();
+        }
+
+        const uint64_t & lower() const{
+            return VALUE.lower();
+        }
+
+        bool negative() const{
+            return VALUE.upper() >> 63;
+        }
+
+        // |value|; 2^127 for int128_min
+        uint128_t magnitude() const{
+            return negative()?-VALUE:VALUE;
+        }
+
+        // Get bitsize of the magnitude
+        uint8_t bits() const{
+            return magnitude().bits();
+        }
+
+        // Get string representation of value; len is the minimum number of digits
+        std::string str(uint8_t base = 10, const unsigned int & len = 0) const;
+
+        // quotient rounded toward 0; the remainder has the sign of lhs
+        static std::pair <int128_t, int128_t> divmod(const int128_t & lhs, const int128_t & rhs);
+
+        // quotient rounded toward negative infinity; the remainder has the sign of rhs
+        static std::pair <int128_t, int128_t> floor_divmod(const int128_t & lhs, const int128_t & rhs);
+
+        uint64_t hash(const uint64_t seed = 0) const{
+            return VALUE.hash(seed);
+        }
+
+        // Order preserving binary keys: the uint128_t key of the value with the sign bit flipped
+        void export_key(uint8_t * out) const{
+            (VALUE ^ uint128_t(0x8000000000000000ULL, 0)).export_key(out);
+        }
+
+        static int128_t import_key(const uint8_t * in){
+            return int128_t(uint128_t::import_key(in) ^ uint128_t(0x8000000000000000ULL, 0));
+        }
+
+        std::size_t export_varkey(uint8_t * out) const{
+            return (VALUE ^ uint128_t(0x8000000000000000ULL, 0)).export_varkey(out);
+        }
+
+        static std::size_t import_varkey(const uint8_t * in, std::size_t len, int128_t & out){
+            uint128_t flipped;
+            const std::size_t read = uint128_t::import_varkey(in, len, flipped);
+            out = int128_t(flipped ^ uint128_t(0x8000000000000000ULL, 0));
+            return read;
+        }
+
+        // batch versions
+        // out must hold count * UINT128_KEY_SIZE bytes
+        static void export_keys(const int128_t * in, std::size_t count, uint8_t * out);
+        static void import_keys(const uint8_t * in, std::size_t count, int128_t * out);
+        // out must hold count * UINT128_VARKEY_MAX_SIZE bytes; returns the number of bytes written
+        static std::size_t export_varkeys(const int128_t * in, std::size_t count, uint8_t * out);
+        // decodes count keys; returns the number of bytes consumed
+        static std::size_t import_varkeys(const uint8_t * in, std::size_t len, int128_t * out, std::size_t count);
+
+        // the two's complement, big endian
+        void export_bits(std::vector <uint8_t> & ret) const{
+            VALUE.export_bits(ret);
+        }
+};
+
+// useful values
+static constexpr int128_t int128_0 = int128_t(0);
+static constexpr int128_t int128_1 = int128_t(1);
+static constexpr int128_t int128_min = int128_t(0x8000000000000000ULL, 0);
+static constexpr int128_t int128_max = int128_t(0x7fffffffffffffffULL, ~0ULL);
+
+// lhs type T as first argument
+// If the output is not a bool, casts to type T
+
+// Bitwise Operators
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator&(const T & lhs, const int128_t & rhs){
+    return rhs & lhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator&=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((rhs & lhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator|(const T & lhs, const int128_t & rhs){
+    return rhs | lhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator|=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((rhs | lhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator^(const T & lhs, const int128_t & rhs){
+    return rhs ^ lhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator^=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((rhs ^ lhs).lower());
+}
+
+// Bitshift operators
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator<<(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) << rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator<<=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) << rhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator>>(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) >> rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator>>=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) >> rhs).lower());
+}
+
+// Comparison Operators
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+bool operator==(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) == rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+bool operator!=(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) != rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+bool operator>(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) > rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+bool operator<(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) < rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+bool operator>=(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) >= rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+bool operator<=(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) <= rhs;
+}
+
+// Arithmetic Operators
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator+(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) + rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator+=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) + rhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator-(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) - rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator-=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) - rhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator*(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) * rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator*=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) * rhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator/(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) / rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator/=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) / rhs).lower());
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+int128_t operator%(const T & lhs, const int128_t & rhs){
+    return int128_t(lhs) % rhs;
+}
+
+template <typename T, typename = typename std::enable_if <int128_integral <T>::value, T>::type>
+T & operator%=(T & lhs, const int128_t & rhs){
+    return lhs = static_cast <T> ((int128_t(lhs) % rhs).lower());
+}
+
+namespace std {
+    template <> struct hash <int128_t>{
+        size_t operator()(const int128_t & rhs) const noexcept{
+            return static_cast <size_t> (rhs.hash());
+        }
+    };
+}
+
+// IO Operator
+UINT128_T_EXTERN std::ostream & operator<<(std::ostream & stream, const int128_t & rhs);
+
+#endif
@@ -0,0 +1,48 @@
+#include <atomic>
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_atomic.h"
+
+// every thread increments the same value
+
+static std::atomic <uint128_t> std_counter;
+static atomic_uint128 counter;
+static uint128_t locked_counter;
+static std::mutex lock;
+
+static void BM_std_atomic_fetch_add(benchmark::State & state){
+    uint128_t expected = std_counter.load();
+    for(auto _ : state){
+        while (!std_counter.compare_exchange_weak(expected, expected + uint128_1)){}
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_atomic_uint128_fetch_add(benchmark::State & state){
+    for(auto _ : state){
+        benchmark::DoNotOptimize(counter.fetch_add(uint128_1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_mutex_add(benchmark::State & state){
+    for(auto _ : state){
+        std::lock_guard <std::mutex> guard(lock);
+        locked_counter += uint128_1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_atomic_uint128_load(benchmark::State & state){
+    for(auto _ : state){
+        benchmark::DoNotOptimize(counter.load());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_std_atomic_fetch_add)->ThreadRange(1, 8);
+BENCHMARK(BM_atomic_uint128_fetch_add)->ThreadRange(1, 8);
+BENCHMARK(BM_mutex_add)->ThreadRange(1, 8);
+BENCHMARK(BM_atomic_uint128_load)->ThreadRange(1, 8);
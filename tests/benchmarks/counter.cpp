@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include "uint128_atomic.h"
+#include "uint128_counter.h"
+
+// every thread increments the same counter
+
+static atomic_uint128 single;
+static sharded_counter128 sharded;
+
+static void BM_single_counter_add(benchmark::State & state){
+    for(auto _ : state){
+        single.fetch_add(uint128_1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_sharded_counter_add(benchmark::State & state){
+    for(auto _ : state){
+        sharded.add(uint128_1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_sharded_counter_read(benchmark::State & state){
+    for(auto _ : state){
+        benchmark::DoNotOptimize(sharded.read());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_single_counter_add)->ThreadRange(1, 8);
+BENCHMARK(BM_sharded_counter_add)->ThreadRange(1, 8);
+BENCHMARK(BM_sharded_counter_read);
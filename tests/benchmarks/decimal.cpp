@@ -0,0 +1,132 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_decimal.h"
+
+typedef fixed_decimal <6> amount;
+
+// amounts below 2^50 units, so that products also fit in 128 bits for the divmod baseline
+static std::vector <amount> amounts(const std::size_t count){
+    std::mt19937_64 gen(1);
+    std::vector <amount> out(count);
+    for(amount & x : out){
+        x = amount::from_raw(gen() >> 14);
+    }
+    return out;
+}
+
+static void BM_decimal_multiply(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    std::vector <amount> out(a.size());
+    const amount rate = amount::from_raw(1234567);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i] * rate;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_multiply);
+
+// the same product, divided by 10^6 with divmod and rounded
+static void BM_decimal_multiply_divmod(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    std::vector <amount> out(a.size());
+    const uint128_t rate(1234567), scale(1000000);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            const std::pair <uint128_t, uint128_t> qr = uint128_t::divmod(a[i].raw() * rate, scale);
+            const uint128_t half = scale - qr.second;
+            out[i] = amount::from_raw(((qr.second > half) || ((qr.second == half) && (qr.first & 1)))?qr.first + 1:qr.first);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_multiply_divmod);
+
+static void BM_decimal_divide(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    std::vector <amount> out(a.size());
+    const amount rate = amount::from_raw(1234567);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i] / rate;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_divide);
+
+static void BM_decimal_rescale(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    std::vector <fixed_decimal <2> > out(a.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i].rescale <2> ();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_rescale);
+
+static void BM_decimal_rescale_divmod(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    std::vector <uint128_t> out(a.size());
+    const uint128_t scale(10000);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i].raw() / scale;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_rescale_divmod);
+
+static void BM_decimal_format(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    char text[FIXED_DECIMAL_MAX_SIZE];
+    for(auto _ : state){
+        for(const amount & x : a){
+            benchmark::DoNotOptimize(x.format(text));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_format);
+
+static void BM_decimal_format_str(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    for(auto _ : state){
+        for(const amount & x : a){
+            benchmark::DoNotOptimize(x.raw().str(10));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_format_str);
+
+static void BM_decimal_parse(benchmark::State & state){
+    const std::vector <amount> a = amounts(1 << 12);
+    std::vector <char> text(a.size() * FIXED_DECIMAL_MAX_SIZE);
+    std::vector <std::size_t> len(a.size());
+    for(std::size_t i = 0; i < a.size(); i++){
+        len[i] = a[i].format(&text[i * FIXED_DECIMAL_MAX_SIZE]);
+    }
+    std::vector <amount> out(a.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            amount::try_parse(&text[i * FIXED_DECIMAL_MAX_SIZE], len[i], out[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_decimal_parse);
@@ -0,0 +1,104 @@
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "keys.h"
+#include "uint128_filter.h"
+#include "uint128_flat_map.h"
+
+// half of the queries are keys that were inserted
+static std::vector <uint128_t> queries(const std::vector <uint128_t> & keys){
+    std::vector <uint128_t> out = make_keys(UUIDV4, keys.size(), 2);
+    for(std::size_t i = 0; i < out.size(); i += 2){
+        out[i] = keys[i];
+    }
+    return out;
+}
+
+static void BM_flat_set_contains(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    const std::vector <uint128_t> x = queries(keys);
+    uint128_flat_set set(keys.size());
+    for(uint128_t const & key : keys){
+        set.insert(key);
+    }
+    for(auto _ : state){
+        std::size_t found = 0;
+        for(uint128_t const & key : x){
+            found += set.contains(key);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+static void BM_bloom_contains(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    const std::vector <uint128_t> x = queries(keys);
+    uint128_bloom_filter filter(keys.size());
+    filter.insert(keys.data(), keys.size());
+    for(auto _ : state){
+        std::size_t found = 0;
+        for(uint128_t const & key : x){
+            found += filter.contains(key);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+static void BM_bloom_contains_bulk(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    const std::vector <uint128_t> x = queries(keys);
+    uint128_bloom_filter filter(keys.size());
+    filter.insert(keys.data(), keys.size());
+    std::unique_ptr <bool []> out(new bool[x.size()]);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(filter.contains(x.data(), x.size(), out.get()));
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+static void BM_bloom_insert_bulk(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    uint128_bloom_filter filter(keys.size());
+    for(auto _ : state){
+        filter.insert(keys.data(), keys.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_cuckoo_contains(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    const std::vector <uint128_t> x = queries(keys);
+    uint128_cuckoo_filter filter(keys.size());
+    filter.insert(keys.data(), keys.size());
+    for(auto _ : state){
+        std::size_t found = 0;
+        for(uint128_t const & key : x){
+            found += filter.contains(key);
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+static void BM_cuckoo_contains_bulk(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    const std::vector <uint128_t> x = queries(keys);
+    uint128_cuckoo_filter filter(keys.size());
+    filter.insert(keys.data(), keys.size());
+    std::unique_ptr <bool []> out(new bool[x.size()]);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(filter.contains(x.data(), x.size(), out.get()));
+    }
+    state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+BENCHMARK(BM_flat_set_contains)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_bloom_contains)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_bloom_contains_bulk)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_bloom_insert_bulk)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_cuckoo_contains)->Range(1 << 12, 1 << 22);
+BENCHMARK(BM_cuckoo_contains_bulk)->Range(1 << 12, 1 << 22);
@@ -0,0 +1,42 @@
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "keys.h"
+#include "uint128_flat_map.h"
+
+template <typename Map>
+static void BM_map_find(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    Map map;
+    for(std::size_t i = 0; i < keys.size(); i++){
+        map[keys[i]] = i;
+    }
+    for(auto _ : state){
+        std::size_t acc = 0;
+        for(uint128_t const & key : keys){
+            acc += map.find(key) -> second;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map>
+static void BM_map_insert(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, state.range(0));
+    for(auto _ : state){
+        Map map;
+        for(std::size_t i = 0; i < keys.size(); i++){
+            map[keys[i]] = i;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK_TEMPLATE(BM_map_find, std::unordered_map <uint128_t, std::size_t>)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_map_find, uint128_flat_map <std::size_t>)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_map_insert, std::unordered_map <uint128_t, std::size_t>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_map_insert, uint128_flat_map <std::size_t>)->Range(1 << 10, 1 << 20);
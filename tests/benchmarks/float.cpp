@@ -0,0 +1,91 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_float.h"
+
+// values of every width from 1 to 128 bits
+static std::vector <uint128_t> values(const std::size_t count){
+    std::mt19937_64 gen(1);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & x : out){
+        x = uint128_t(gen(), gen() | 1) >> (gen() % 128);
+    }
+    return out;
+}
+
+static void BM_to_double(benchmark::State & state){
+    const std::vector <uint128_t> in = values(1 << 12);
+    std::vector <double> out(in.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < in.size(); i++){
+            out[i] = to_double(in[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_to_double);
+
+static void BM_to_double_batch(benchmark::State & state){
+    const std::vector <uint128_t> in = values(1 << 12);
+    std::vector <double> out(in.size());
+    for(auto _ : state){
+        to_double(in.data(), out.data(), in.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_to_double_batch);
+
+// baseline: converting the halves separately, which rounds twice
+static void BM_to_double_halves(benchmark::State & state){
+    const std::vector <uint128_t> in = values(1 << 12);
+    std::vector <double> out(in.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < in.size(); i++){
+            out[i] = static_cast <double> (in[i].upper()) * 18446744073709551616.0 + static_cast <double> (in[i].lower());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_to_double_halves);
+
+static void BM_to_float_batch(benchmark::State & state){
+    const std::vector <uint128_t> in = values(1 << 12);
+    std::vector <float> out(in.size());
+    for(auto _ : state){
+        to_float(in.data(), out.data(), in.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_to_float_batch);
+
+static void BM_from_double(benchmark::State & state){
+    std::vector <double> in(1 << 12);
+    std::vector <uint128_t> out(in.size());
+    to_double(values(in.size()).data(), in.data(), in.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < in.size(); i++){
+            out[i] = from_double(in[i], UINT128_FLOAT_SATURATE);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_from_double);
+
+static void BM_from_double_batch(benchmark::State & state){
+    std::vector <double> in(1 << 12);
+    std::vector <uint128_t> out(in.size());
+    to_double(values(in.size()).data(), in.data(), in.size());
+    for(auto _ : state){
+        from_double(in.data(), out.data(), in.size(), UINT128_FLOAT_SATURATE);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_from_double_batch);
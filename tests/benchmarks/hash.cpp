@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "keys.h"
+#include "uint128_t.h"
+
+// The hash that shipped before the multiply-fold mixer, for comparison
+struct legacy_hash{
+    std::size_t operator()(const uint128_t & rhs) const{
+        uint64_t max = rhs.upper() > rhs.lower() ? rhs.upper():rhs.lower();
+        uint64_t min = rhs.upper() < rhs.upper() ? rhs.upper():rhs.lower();
+        return min + ((max - min) >> 1);
+    }
+};
+
+static const std::size_t KEYS = 1 << 16;
+
+template <typename Hash>
+static void BM_hash(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(static_cast <KeyDistribution> (state.range(0)), KEYS);
+    const Hash hash;
+    for(auto _ : state){
+        std::size_t acc = 0;
+        for(uint128_t const & key : keys){
+            acc += hash(key);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.SetLabel(KeyDistributionNames[state.range(0)]);
+}
+
+// Collision quality: place every key in a power of 2 table using the low bits of the hash and report
+// how many keys landed in an already used bucket relative to an ideal random function
+// (1 / e of the keys for a table that is as large as the key count), plus full-width collisions.
+template <typename Hash>
+static void BM_hash_collisions(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(static_cast <KeyDistribution> (state.range(0)), KEYS);
+    const Hash hash;
+    for(auto _ : state){
+        std::vector <uint8_t> buckets(KEYS, 0);
+        std::vector <std::size_t> full;
+        full.reserve(keys.size());
+        std::size_t bucket_collisions = 0;
+        for(uint128_t const & key : keys){
+            const std::size_t h = hash(key);
+            bucket_collisions += buckets[h & (KEYS - 1)];
+            buckets[h & (KEYS - 1)] = 1;
+            full.push_back(h);
+        }
+        std::sort(full.begin(), full.end());
+        const std::size_t unique = std::unique(full.begin(), full.end()) - full.begin();
+
+        state.counters["bucket_collisions_vs_ideal"] = bucket_collisions / (KEYS * 0.36787944117144233);
+        state.counters["full_collisions"] = static_cast <double> (keys.size() - unique);
+    }
+    state.SetLabel(KeyDistributionNames[state.range(0)]);
+}
+
+template <typename Hash>
+static void BM_unordered_map_find(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(static_cast <KeyDistribution> (state.range(0)), KEYS);
+    std::unordered_map <uint128_t, std::size_t, Hash> map;
+    for(std::size_t i = 0; i < keys.size(); i++){
+        map[keys[i]] = i;
+    }
+    for(auto _ : state){
+        std::size_t acc = 0;
+        for(uint128_t const & key : keys){
+            acc += map.find(key)->second;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.SetLabel(KeyDistributionNames[state.range(0)]);
+}
+
+#define HASH_BENCHMARKS(hash)                                                   \
+    BENCHMARK_TEMPLATE(BM_hash, hash)->DenseRange(SEQUENTIAL, EQUAL_HALVES);    \
+    BENCHMARK_TEMPLATE(BM_hash_collisions, hash)->DenseRange(SEQUENTIAL, EQUAL_HALVES)->Iterations(1); \
+    BENCHMARK_TEMPLATE(BM_unordered_map_find, hash)->DenseRange(SEQUENTIAL, EQUAL_HALVES);
+
+HASH_BENCHMARKS(legacy_hash)
+HASH_BENCHMARKS(std::hash <uint128_t>)
+HASH_BENCHMARKS(uint128_hash <uint128_fmix_mixer>)
@@ -0,0 +1,50 @@
+#ifndef _UINT128_T_BENCH_KEYS_H_
+#define _UINT128_T_BENCH_KEYS_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "uint128_t.h"
+
+// Key distributions seen in practice
+enum KeyDistribution{
+    SEQUENTIAL = 0,     // 0, 1, 2, ...
+    UUIDV4,             // random, with the version and variant bits fixed
+    IPV6,               // hosts numbered sequentially inside a handful of /64 subnets
+    EQUAL_HALVES,       // (i, i)
+};
+
+static const char * const KeyDistributionNames[] = {
+    "sequential",
+    "uuidv4",
+    "ipv6",
+    "equal_halves",
+};
+
+inline std::vector <uint128_t> make_keys(const KeyDistribution dist, const std::size_t count, const uint64_t seed = 1){
+    std::mt19937_64 gen(seed);
+    std::vector <uint128_t> keys;
+    keys.reserve(count);
+    for(std::size_t i = 0; i < count; i++){
+        switch (dist){
+            case SEQUENTIAL:
+                keys.push_back(uint128_t(i));
+                break;
+            case UUIDV4:
+                keys.push_back(uint128_t((gen() & 0xffffffffffff0fffULL) | 0x0000000000004000ULL,
+                                         (gen() & 0x3fffffffffffffffULL) | 0x8000000000000000ULL));
+                break;
+            case IPV6:
+                // 2001:db8:0:subnet::host
+                keys.push_back(uint128_t(0x20010db800000000ULL | (i & 0xf), i >> 4));
+                break;
+            case EQUAL_HALVES:
+                keys.push_back(uint128_t(i, i));
+                break;
+        }
+    }
+    return keys;
+}
+
+#endif
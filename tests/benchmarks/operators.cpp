@@ -0,0 +1,326 @@
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_t.h"
+
+// Every operator of uint128_t next to the compiler's unsigned __int128 and a plain two word struct
+// with the textbook algorithms (carry compares, 32-bit partial products, shift-subtract division),
+// so that a regression shows up against both a floor and a ceiling.
+//
+// BM_latency feeds each result into the next operation, BM_throughput runs independent operations
+// over arrays. The right hand operands have range(0) bits, which matters for / and %.
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 native128;
+#endif
+
+struct two_word{
+    uint64_t hi, lo;
+
+    two_word(const uint64_t h = 0, const uint64_t l = 0)
+        : hi(h), lo(l)
+    {}
+
+    two_word operator+(const two_word & rhs) const{
+        const uint64_t l = lo + rhs.lo;
+        return two_word(hi + rhs.hi + (l < lo), l);
+    }
+
+    two_word operator-(const two_word & rhs) const{
+        return two_word(hi - rhs.hi - (lo < rhs.lo), lo - rhs.lo);
+    }
+
+    two_word operator-() const{
+        return two_word() - *this;
+    }
+
+    two_word operator~() const{
+        return two_word(~hi, ~lo);
+    }
+
+    two_word operator&(const two_word & rhs) const{
+        return two_word(hi & rhs.hi, lo & rhs.lo);
+    }
+
+    two_word operator|(const two_word & rhs) const{
+        return two_word(hi | rhs.hi, lo | rhs.lo);
+    }
+
+    two_word operator^(const two_word & rhs) const{
+        return two_word(hi ^ rhs.hi, lo ^ rhs.lo);
+    }
+
+    two_word operator<<(const unsigned s) const{
+        if (s >= 64){
+            return two_word(lo << (s - 64), 0);
+        }
+        if (!s){
+            return *this;
+        }
+        return two_word((hi << s) | (lo >> (64 - s)), lo << s);
+    }
+
+    two_word operator>>(const unsigned s) const{
+        if (s >= 64){
+            return two_word(0, hi >> (s - 64));
+        }
+        if (!s){
+            return *this;
+        }
+        return two_word(hi >> s, (lo >> s) | (hi << (64 - s)));
+    }
+
+    bool operator==(const two_word & rhs) const{
+        return (hi == rhs.hi) && (lo == rhs.lo);
+    }
+
+    bool operator<(const two_word & rhs) const{
+        return (hi < rhs.hi) || ((hi == rhs.hi) && (lo < rhs.lo));
+    }
+
+    // 64 x 64 -> 128 from 32-bit halves
+    static two_word mul64(const uint64_t a, const uint64_t b){
+        const uint64_t a0 = a & 0xffffffff, a1 = a >> 32;
+        const uint64_t b0 = b & 0xffffffff, b1 = b >> 32;
+        const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        const uint64_t mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+        return two_word(p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32), (mid << 32) | (p00 & 0xffffffff));
+    }
+
+    two_word operator*(const two_word & rhs) const{
+        two_word out = mul64(lo, rhs.lo);
+        out.hi += lo * rhs.hi + hi * rhs.lo;
+        return out;
+    }
+
+    // one quotient bit per step
+    static void divmod(const two_word & a, const two_word & b, two_word & q, two_word & r){
+        q = r = two_word();
+        for(unsigned i = 128; i-- > 0;){
+            r = r << 1;
+            r.lo |= ((i >= 64?(a.hi >> (i - 64)):(a.lo >> i)) & 1);
+            q = q << 1;
+            if (!(r < b)){
+                r = r - b;
+                q.lo |= 1;
+            }
+        }
+    }
+
+    two_word operator/(const two_word & rhs) const{
+        two_word q, r;
+        divmod(*this, rhs, q, r);
+        return q;
+    }
+
+    two_word operator%(const two_word & rhs) const{
+        two_word q, r;
+        divmod(*this, rhs, q, r);
+        return r;
+    }
+};
+
+template <typename T> static T make(const uint64_t hi, const uint64_t lo);
+template <> uint128_t make <uint128_t> (const uint64_t hi, const uint64_t lo){ return uint128_t(hi, lo); }
+template <> two_word make <two_word> (const uint64_t hi, const uint64_t lo){ return two_word(hi, lo); }
+
+static unsigned low_bits(const uint128_t & x){ return static_cast <unsigned> (x.lower()); }
+static unsigned low_bits(const two_word & x){ return static_cast <unsigned> (x.lo); }
+
+#if defined(__SIZEOF_INT128__)
+template <> native128 make <native128> (const uint64_t hi, const uint64_t lo){ return (static_cast <native128> (hi) << 64) | lo; }
+static unsigned low_bits(const native128 x){ return static_cast <unsigned> (x); }
+#endif
+
+// uniformly random values of up to bits bits, never 0
+template <typename T>
+static std::vector <T> operands(const std::size_t count, const unsigned bits, const uint64_t seed){
+    std::mt19937_64 gen(seed);
+    std::vector <T> out;
+    out.reserve(count);
+    for(std::size_t i = 0; i < count; i++){
+        uint64_t hi = gen(), lo = gen();
+        if (bits <= 64){
+            hi = 0;
+            lo = (bits == 64)?lo:(lo >> (64 - bits));
+        }
+        else{
+            hi = (bits == 128)?hi:(hi >> (128 - bits));
+        }
+        out.push_back(make <T> (hi, lo | 1));
+    }
+    return out;
+}
+
+// The operators, as function objects over any of the three types. Compares turn their result into
+// a value with ^ so that they can be chained like the others.
+#define BINARY_OPERATOR(name, expr)                                         \
+    struct name{                                                            \
+        template <typename T>                                               \
+        T operator()(const T & a, const T & b) const{                       \
+            return expr;                                                    \
+        }                                                                   \
+    };
+
+BINARY_OPERATOR(op_add, a + b)
+BINARY_OPERATOR(op_sub, a - b)
+BINARY_OPERATOR(op_mul, a * b)
+BINARY_OPERATOR(op_div, a / b)
+BINARY_OPERATOR(op_mod, a % b)
+BINARY_OPERATOR(op_and, a & b)
+BINARY_OPERATOR(op_or, a | b)
+BINARY_OPERATOR(op_xor, a ^ b)
+BINARY_OPERATOR(op_shl, a << (low_bits(b) & 127))
+BINARY_OPERATOR(op_shr, a >> (low_bits(b) & 127))
+BINARY_OPERATOR(op_eq, a ^ make <T> (0, a == b))
+BINARY_OPERATOR(op_lt, a ^ make <T> (0, a < b))
+BINARY_OPERATOR(op_not, ~a)
+BINARY_OPERATOR(op_neg, -a)
+
+#undef BINARY_OPERATOR
+
+static const std::size_t COUNT = 1 << 10;
+
+template <typename T, typename Op>
+static void BM_latency(benchmark::State & state){
+    const std::vector <T> a = operands <T> (COUNT, 128, 1);
+    const std::vector <T> b = operands <T> (COUNT, state.range(0), 2);
+    const T one = make <T> (0, 1);
+    const Op op;
+    T x = a[0];
+    for(auto _ : state){
+        for(std::size_t i = 0; i < COUNT; i++){
+            // the low bit of the last result picks the next left hand operand
+            x = op(a[i] ^ (x & one), b[i]);
+        }
+    }
+    benchmark::DoNotOptimize(x);
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+
+template <typename T, typename Op>
+static void BM_throughput(benchmark::State & state){
+    const std::vector <T> a = operands <T> (COUNT, 128, 1);
+    const std::vector <T> b = operands <T> (COUNT, state.range(0), 2);
+    std::vector <T> out(COUNT);
+    const Op op;
+    for(auto _ : state){
+        for(std::size_t i = 0; i < COUNT; i++){
+            out[i] = op(a[i], b[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+
+#define TYPE_BENCHMARKS(type, op, widths)                                   \
+    BENCHMARK_TEMPLATE(BM_latency, type, op)->widths;                       \
+    BENCHMARK_TEMPLATE(BM_throughput, type, op)->widths;
+
+#if defined(__SIZEOF_INT128__)
+#define OPERATOR_BENCHMARKS(op, widths)                                     \
+    TYPE_BENCHMARKS(uint128_t, op, widths)                                  \
+    TYPE_BENCHMARKS(native128, op, widths)                                  \
+    TYPE_BENCHMARKS(two_word, op, widths)
+#else
+#define OPERATOR_BENCHMARKS(op, widths)                                     \
+    TYPE_BENCHMARKS(uint128_t, op, widths)                                  \
+    TYPE_BENCHMARKS(two_word, op, widths)
+#endif
+
+#define FULL_WIDTH Arg(128)
+#define DIVISOR_WIDTHS Arg(16)->Arg(32)->Arg(64)->Arg(96)->Arg(128)
+
+OPERATOR_BENCHMARKS(op_add, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_sub, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_mul, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_div, DIVISOR_WIDTHS)
+OPERATOR_BENCHMARKS(op_mod, DIVISOR_WIDTHS)
+OPERATOR_BENCHMARKS(op_and, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_or, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_xor, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_shl, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_shr, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_eq, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_lt, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_not, FULL_WIDTH)
+OPERATOR_BENCHMARKS(op_neg, FULL_WIDTH)
+
+// divmod returns both halves of the division at once
+static void BM_uint128_divmod(benchmark::State & state){
+    const std::vector <uint128_t> a = operands <uint128_t> (COUNT, 128, 1);
+    const std::vector <uint128_t> b = operands <uint128_t> (COUNT, state.range(0), 2);
+    std::vector <std::pair <uint128_t, uint128_t> > out(COUNT);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < COUNT; i++){
+            out[i] = uint128_t::divmod(a[i], b[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_uint128_divmod)->DIVISOR_WIDTHS;
+
+// Text and byte conversions, per base
+
+static void BM_uint128_str(benchmark::State & state){
+    const std::vector <uint128_t> a = operands <uint128_t> (COUNT, 128, 1);
+    const uint8_t base = static_cast <uint8_t> (state.range(0));
+    for(auto _ : state){
+        for(const uint128_t & x : a){
+            benchmark::DoNotOptimize(x.str(base));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_uint128_str)->Arg(2)->Arg(8)->Arg(10)->Arg(16);
+
+static void BM_uint128_from_string(benchmark::State & state){
+    const uint8_t base = static_cast <uint8_t> (state.range(0));
+    std::vector <std::string> text;
+    for(const uint128_t & x : operands <uint128_t> (COUNT, 128, 1)){
+        text.push_back(x.str(base));
+    }
+    for(auto _ : state){
+        for(const std::string & s : text){
+            benchmark::DoNotOptimize(uint128_t(s, base));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_uint128_from_string)->Arg(2)->Arg(8)->Arg(10)->Arg(16);
+
+static void BM_uint128_export_bits(benchmark::State & state){
+    const std::vector <uint128_t> a = operands <uint128_t> (COUNT, 128, 1);
+    std::vector <uint8_t> bytes;
+    for(auto _ : state){
+        for(const uint128_t & x : a){
+            bytes.clear();
+            x.export_bits(bytes);
+            benchmark::DoNotOptimize(bytes.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_uint128_export_bits);
+
+static void BM_uint128_std_hash(benchmark::State & state){
+    const std::vector <uint128_t> a = operands <uint128_t> (COUNT, 128, 1);
+    const std::hash <uint128_t> hash;
+    for(auto _ : state){
+        std::size_t acc = 0;
+        for(const uint128_t & x : a){
+            acc += hash(x);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * COUNT);
+}
+BENCHMARK(BM_uint128_std_hash);
@@ -0,0 +1,164 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "perf_counters.h"
+#include "uint128_t.h"
+
+// Hardware counters per call of the uint128_t kernels, registered only when UINT128_T_PERF is set
+// (make run-bench-perf). Each benchmark reports, per operation:
+//
+//     instructions, cycles, CPI, branch_misses, branch_miss_rate, l1d_misses
+//
+// as user counters, so they land in the JSON output next to the times. The counts include the
+// few instructions of the loop around each call. Where the counters cannot be opened the label
+// says why and only the times are reported.
+
+static const std::size_t COUNT = 1 << 10;
+
+struct perf_inputs{
+    std::vector <uint128_t> a;          // 128 bit
+    std::vector <uint128_t> b;          // 128 bit
+    std::vector <uint128_t> b64;        // 64 bit, for the single word division path
+    std::vector <unsigned> shift;
+    std::vector <std::string> text;     // a in base 10
+    std::vector <uint128_t> out;
+
+    perf_inputs()
+        : out(COUNT)
+    {
+        std::mt19937_64 gen(1);
+        for(std::size_t i = 0; i < COUNT; i++){
+            a.push_back(uint128_t(gen(), gen()) >> (gen() % 128));
+            b.push_back((uint128_t(gen(), gen()) >> (gen() % 64)) | 1);
+            b64.push_back(uint128_t(gen() | 1));
+            shift.push_back(gen() % 128);
+            text.push_back(a.back().str());
+        }
+    }
+};
+
+typedef void (*perf_kernel)(perf_inputs & in);
+
+static void add(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] + in.b[i];
+    }
+}
+
+static void mul(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] * in.b[i];
+    }
+}
+
+static void div128(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] / in.b[i];
+    }
+}
+
+static void div64(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] / in.b64[i];
+    }
+}
+
+static void mod128(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] % in.b[i];
+    }
+}
+
+static void shl(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] << in.shift[i];
+    }
+}
+
+static void shr(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i] >> in.shift[i];
+    }
+}
+
+static void bits(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = in.a[i].bits();
+    }
+}
+
+static void str10(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        benchmark::DoNotOptimize(in.a[i].str(10));
+    }
+}
+
+static void str16(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        benchmark::DoNotOptimize(in.a[i].str(16));
+    }
+}
+
+static void parse10(perf_inputs & in){
+    for(std::size_t i = 0; i < COUNT; i++){
+        in.out[i] = uint128_t(in.text[i], 10);
+    }
+}
+
+static void BM_perf(benchmark::State & state, const perf_kernel kernel){
+    perf_inputs in;
+    perf_counters perf;
+    perf.start();
+    for(auto _ : state){
+        kernel(in);
+        benchmark::DoNotOptimize(in.out.data());
+        benchmark::ClobberMemory();
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * COUNT);
+
+    if (!perf.available()){
+        state.SetLabel("no counters: " + perf.why());
+        return;
+    }
+    const double ops = static_cast <double> (state.iterations()) * COUNT;
+    state.counters["cycles"] = perf[perf_counters::CYCLES] / ops;
+    if (perf.has(perf_counters::INSTRUCTIONS)){
+        state.counters["instructions"] = perf[perf_counters::INSTRUCTIONS] / ops;
+        state.counters["CPI"] = perf[perf_counters::INSTRUCTIONS]?static_cast <double> (perf[perf_counters::CYCLES]) / perf[perf_counters::INSTRUCTIONS]:0;
+    }
+    if (perf.has(perf_counters::BRANCH_MISSES)){
+        state.counters["branch_misses"] = perf[perf_counters::BRANCH_MISSES] / ops;
+        if (perf.has(perf_counters::BRANCHES) && perf[perf_counters::BRANCHES]){
+            state.counters["branch_miss_rate"] = static_cast <double> (perf[perf_counters::BRANCH_MISSES]) / perf[perf_counters::BRANCHES];
+        }
+    }
+    if (perf.has(perf_counters::L1D_MISSES)){
+        state.counters["l1d_misses"] = perf[perf_counters::L1D_MISSES] / ops;
+    }
+}
+
+void register_perf_benchmarks(){
+    static const struct{
+        const char * name;
+        perf_kernel kernel;
+    } kernels[] = {
+        {"perf/add", add},
+        {"perf/mul", mul},
+        {"perf/div128", div128},
+        {"perf/div64", div64},
+        {"perf/mod128", mod128},
+        {"perf/shl", shl},
+        {"perf/shr", shr},
+        {"perf/bits", bits},
+        {"perf/str10", str10},
+        {"perf/str16", str16},
+        {"perf/parse10", parse10},
+    };
+    for(const auto & k : kernels){
+        benchmark::RegisterBenchmark(k.name, BM_perf, k.kernel);
+    }
+}
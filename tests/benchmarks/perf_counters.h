@@ -0,0 +1,164 @@
+#ifndef _UINT128_T_BENCH_PERF_COUNTERS_H_
+#define _UINT128_T_BENCH_PERF_COUNTERS_H_
+
+// Hardware counters through perf_event_open, for the UINT128_T_PERF benchmarks.
+//
+// The events are opened as one group so that they count over the same instructions. Events the
+// host does not have (common in virtual machines) are left out, and if not even the cycle counter
+// opens, available() is false and why() says what failed; the benchmarks then report time only.
+// Counting is restricted to user space, which perf_event_paranoid up to 2 allows.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+class perf_counters{
+    public:
+        enum event{
+            CYCLES = 0,
+            INSTRUCTIONS,
+            BRANCHES,
+            BRANCH_MISSES,
+            L1D_MISSES,
+            EVENTS,
+        };
+
+    private:
+        int fd[EVENTS];
+        uint64_t id[EVENTS];
+        uint64_t count[EVENTS];
+        std::string reason;
+
+#if defined(__linux__)
+        int open(const uint32_t type, const uint64_t config, const int group){
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = (group == -1);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast <int> (syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+        }
+#endif
+
+    public:
+        perf_counters()
+            : reason("perf_event_open is only on Linux")
+        {
+            for(unsigned e = 0; e < EVENTS; e++){
+                fd[e] = -1;
+                id[e] = 0;
+                count[e] = 0;
+            }
+#if defined(__linux__)
+            static const uint32_t type[EVENTS] = {
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HW_CACHE,
+            };
+            static const uint64_t config[EVENTS] = {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+                PERF_COUNT_HW_BRANCH_MISSES,
+                PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+            };
+            fd[CYCLES] = open(type[CYCLES], config[CYCLES], -1);
+            if (fd[CYCLES] == -1){
+                reason = std::string("perf_event_open: ") + std::strerror(errno);
+                return;
+            }
+            if (ioctl(fd[CYCLES], PERF_EVENT_IOC_ID, &id[CYCLES]) == -1){
+                reason = std::string("PERF_EVENT_IOC_ID: ") + std::strerror(errno);
+                close(fd[CYCLES]);
+                fd[CYCLES] = -1;
+                return;
+            }
+            reason.clear();
+            for(unsigned e = CYCLES + 1; e < EVENTS; e++){
+                fd[e] = open(type[e], config[e], fd[CYCLES]);
+                if ((fd[e] != -1) && (ioctl(fd[e], PERF_EVENT_IOC_ID, &id[e]) == -1)){
+                    close(fd[e]);
+                    fd[e] = -1;
+                }
+            }
+#endif
+        }
+
+        ~perf_counters(){
+#if defined(__linux__)
+            for(unsigned e = EVENTS; e-- > 0;){
+                if (fd[e] != -1){
+                    close(fd[e]);
+                }
+            }
+#endif
+        }
+
+        perf_counters(const perf_counters &) = delete;
+        perf_counters & operator=(const perf_counters &) = delete;
+
+        bool available() const{
+            return fd[CYCLES] != -1;
+        }
+
+        bool has(const event e) const{
+            return fd[e] != -1;
+        }
+
+        const std::string & why() const{
+            return reason;
+        }
+
+        void start(){
+#if defined(__linux__)
+            if (available()){
+                ioctl(fd[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(fd[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        // reads the counts since start(), scaled up if the kernel had to multiplex the group
+        void stop(){
+#if defined(__linux__)
+            if (!available()){
+                return;
+            }
+            ioctl(fd[CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            // nr, time_enabled, time_running, then (value, id) per event
+            uint64_t buf[3 + 2 * EVENTS];
+            if (read(fd[CYCLES], buf, sizeof(buf)) < static_cast <ssize_t> (3 * sizeof(uint64_t))){
+                return;
+            }
+            const double scale = buf[2]?static_cast <double> (buf[1]) / buf[2]:0;
+            for(uint64_t i = 0; (i < buf[0]) && (i < EVENTS); i++){
+                for(unsigned e = 0; e < EVENTS; e++){
+                    if ((fd[e] != -1) && (id[e] == buf[4 + 2 * i])){
+                        count[e] = static_cast <uint64_t> (buf[3 + 2 * i] * scale);
+                    }
+                }
+            }
+#endif
+        }
+
+        uint64_t operator[](const event e) const{
+            return count[e];
+        }
+};
+
+#endif
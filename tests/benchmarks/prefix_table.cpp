@@ -0,0 +1,91 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_prefix_table.h"
+
+// a rough shape of the IPv6 routing table: mostly /48s and /32s under 2000::/3
+struct routes{
+    std::vector <uint128_t> prefixes;
+    std::vector <unsigned> lens;
+    std::vector <uint32_t> values;
+    std::vector <uint128_t> addrs;
+
+    explicit routes(const std::size_t count){
+        static const unsigned LENGTHS[] = {48, 48, 48, 48, 48, 32, 32, 40, 44, 29, 36, 56, 64, 64, 128, 24};
+        std::mt19937_64 gen(7);
+        for(std::size_t i = 0; i < count; i++){
+            const unsigned len = LENGTHS[gen() & 15];
+            prefixes.push_back(uint128_t((gen() & 0x1fffffffffffffffULL) | 0x2000000000000000ULL, gen()) & uint128_prefix_mask(len));
+            lens.push_back(len);
+            values.push_back(i);
+        }
+        for(std::size_t i = 0; i < (1 << 12); i++){
+            const std::size_t p = gen() % count;
+            addrs.push_back(prefixes[p] | (uint128_t(gen(), gen()) & ~uint128_prefix_mask(lens[p])));
+        }
+    }
+};
+
+static void BM_linear_scan(benchmark::State & state){
+    const routes r(state.range(0));
+    for(auto _ : state){
+        uint64_t acc = 0;
+        for(uint128_t const & addr : r.addrs){
+            unsigned best = 0;
+            uint32_t value = 0;
+            for(std::size_t p = 0; p < r.prefixes.size(); p++){
+                if (((addr & uint128_prefix_mask(r.lens[p])) == r.prefixes[p]) && (r.lens[p] >= best)){
+                    best = r.lens[p];
+                    value = r.values[p];
+                }
+            }
+            acc += value;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * r.addrs.size());
+}
+
+static void BM_prefix_table_lookup(benchmark::State & state){
+    const routes r(state.range(0));
+    uint128_prefix_table <uint32_t> table;
+    table.insert(r.prefixes.data(), r.lens.data(), r.values.data(), r.prefixes.size());
+    for(auto _ : state){
+        uint64_t acc = 0;
+        for(uint128_t const & addr : r.addrs){
+            const uint32_t * value = table.lookup(addr);
+            acc += value?*value:0;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * r.addrs.size());
+}
+
+static void BM_prefix_table_lookup_batch(benchmark::State & state){
+    const routes r(state.range(0));
+    uint128_prefix_table <uint32_t> table;
+    table.insert(r.prefixes.data(), r.lens.data(), r.values.data(), r.prefixes.size());
+    std::vector <const uint32_t *> out(r.addrs.size());
+    for(auto _ : state){
+        table.lookup(r.addrs.data(), r.addrs.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * r.addrs.size());
+}
+
+static void BM_prefix_table_build(benchmark::State & state){
+    const routes r(state.range(0));
+    for(auto _ : state){
+        uint128_prefix_table <uint32_t> table;
+        table.insert(r.prefixes.data(), r.lens.data(), r.values.data(), r.prefixes.size());
+        benchmark::DoNotOptimize(table.size());
+    }
+    state.SetItemsProcessed(state.iterations() * r.prefixes.size());
+}
+
+BENCHMARK(BM_linear_scan)->Arg(1 << 6)->Arg(1 << 10);
+BENCHMARK(BM_prefix_table_lookup)->Arg(1 << 6)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+BENCHMARK(BM_prefix_table_lookup_batch)->Arg(1 << 6)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18);
+BENCHMARK(BM_prefix_table_build)->Arg(1 << 14)->Arg(1 << 18);
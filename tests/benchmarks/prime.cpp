@@ -0,0 +1,64 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_prime.h"
+
+// random odd values below 2^bits
+static std::vector <uint128_t> odd_values(const std::size_t count, const unsigned bits){
+    std::mt19937_64 gen(1);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & x : out){
+        x = (uint128_t(gen(), gen()) >> (128 - bits)) | 1;
+    }
+    return out;
+}
+
+static void BM_is_prime(benchmark::State & state){
+    const std::vector <uint128_t> in = odd_values(1 << 10, state.range(0));
+    for(auto _ : state){
+        std::size_t count = 0;
+        for(const uint128_t & x : in){
+            count += is_prime(x);
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_is_prime)->Arg(32)->Arg(64)->Arg(80)->Arg(128);
+
+// primes take every round of the test
+static void BM_is_prime_prime(benchmark::State & state){
+    const uint128_t p = (state.range(0) == 64)?uint128_t(0xffffffffffffffc5ULL):
+                        (state.range(0) == 80)?(uint128_1 << 80) + 13:
+                                               uint128_t(~0ULL, 0xffffffffffffff61ULL);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(is_prime(p));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_is_prime_prime)->Arg(64)->Arg(80)->Arg(128);
+
+static void BM_is_prime_batch(benchmark::State & state){
+    const std::vector <uint128_t> in = odd_values(1 << 14, 128);
+    std::unique_ptr <bool []> out(new bool[in.size()]);
+    for(auto _ : state){
+        is_prime(in.data(), in.size(), out.get(), state.range(0));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_is_prime_batch)->Arg(1)->Arg(0)->UseRealTime();
+
+static void BM_factor(benchmark::State & state){
+    const std::vector <uint128_t> in = odd_values(1 << 6, state.range(0));
+    for(auto _ : state){
+        for(const uint128_t & x : in){
+            benchmark::DoNotOptimize(factor(x));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_factor)->Arg(64)->Arg(80);
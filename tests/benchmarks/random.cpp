@@ -0,0 +1,92 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_random.h"
+
+static void BM_mt19937_64(benchmark::State & state){
+    std::mt19937_64 gen(1);
+    std::vector <uint64_t> out(state.range(0));
+    for(auto _ : state){
+        for(uint64_t & x : out){
+            x = gen();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+BENCHMARK(BM_mt19937_64)->Arg(1 << 12);
+
+template <typename Engine>
+static void BM_call(benchmark::State & state){
+    Engine gen(1);
+    std::vector <uint64_t> out(state.range(0));
+    for(auto _ : state){
+        for(uint64_t & x : out){
+            x = gen();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+BENCHMARK_TEMPLATE(BM_call, uint128_pcg64)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_call, uint128_pcg64_dxsm)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_call, uint128_mcg128)->Arg(1 << 12);
+
+template <typename Engine>
+static void BM_fill(benchmark::State & state){
+    Engine gen(1);
+    std::vector <uint64_t> out(state.range(0));
+    for(auto _ : state){
+        gen.fill(out.data(), out.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+BENCHMARK_TEMPLATE(BM_fill, uint128_pcg64)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_fill, uint128_pcg64_dxsm)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_fill, uint128_mcg128)->Arg(1 << 12);
+
+static void BM_advance(benchmark::State & state){
+    uint128_pcg64 gen(1);
+    uint128_t delta(0x123456789abcdefULL, 0xfedcba9876543210ULL);
+    for(auto _ : state){
+        gen.advance(delta);
+        benchmark::DoNotOptimize(gen);
+    }
+}
+BENCHMARK(BM_advance);
+
+// the biased way: random bits modulo the bound
+static void BM_uniform_modulo(benchmark::State & state){
+    uint128_pcg64 gen(1);
+    const uint128_t bound(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(uint128_t(gen(), gen()) % bound);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_uniform_modulo);
+
+static void BM_uniform(benchmark::State & state){
+    uint128_pcg64 gen(1);
+    const uint128_t bound = state.range(0)?uint128_t(0x0123456789abcdefULL, 0xfedcba9876543210ULL):uint128_t(1000000007);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(uniform_uint128(gen, bound));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_uniform)->Arg(0)->Arg(1);
+
+static void BM_uniform_batch(benchmark::State & state){
+    uint128_pcg64 gen(1);
+    const uint128_t bound(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    std::vector <uint128_t> out(1 << 12);
+    for(auto _ : state){
+        uniform_uint128(gen, bound, out.data(), out.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+BENCHMARK(BM_uniform_batch);
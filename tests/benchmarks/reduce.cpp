@@ -0,0 +1,86 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_reduce.h"
+
+static std::vector <uint128_t> random_values(const std::size_t count, const uint64_t seed){
+    std::mt19937_64 gen(seed);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & value : out){
+        value = uint128_t(gen() >> 16, gen());
+    }
+    return out;
+}
+
+// a serial operator+= loop, which wraps at 128 bits
+static void BM_sum_loop(benchmark::State & state){
+    const std::vector <uint128_t> in = random_values(state.range(0), 1);
+    for(auto _ : state){
+        uint128_t sum = 0;
+        for(uint128_t const & x : in){
+            sum += x;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_sum_loop)->Arg(1 << 12)->Arg(1 << 20);
+
+static void BM_sum(benchmark::State & state){
+    const std::vector <uint128_t> in = random_values(state.range(0), 1);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(uint128_sum(in.data(), in.size(), state.range(1)));
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_sum)->Args({1 << 12, 1})->Args({1 << 20, 1})->Args({1 << 22, 0})->UseRealTime();
+
+// a serial loop of full 128 x 128 -> 256 bit products added into a 256-bit total
+static void BM_dot_loop(benchmark::State & state){
+    const std::vector <uint128_t> a = random_values(state.range(0), 1);
+    const std::vector <uint128_t> b = random_values(state.range(0), 2);
+    for(auto _ : state){
+        uint128_t high = 0, low = 0;
+        for(std::size_t i = 0; i < a.size(); i++){
+            uint64_t ll_hi, lh_hi, hl_hi, hh_hi;
+            const uint64_t ll = uint128_t::multlong64(a[i].lower(), b[i].lower(), &ll_hi);
+            const uint64_t lh = uint128_t::multlong64(a[i].lower(), b[i].upper(), &lh_hi);
+            const uint64_t hl = uint128_t::multlong64(a[i].upper(), b[i].lower(), &hl_hi);
+            const uint64_t hh = uint128_t::multlong64(a[i].upper(), b[i].upper(), &hh_hi);
+            const uint128_t mid = uint128_t(lh_hi, lh) + uint128_t(hl_hi, hl);
+            const uint128_t product_low = uint128_t(ll_hi, ll) + (mid << 64);
+            const uint128_t product_high = uint128_t(hh_hi, hh) + (mid >> 64) + uint128_t((mid < uint128_t(lh_hi, lh))?1:0, 0) + ((product_low < uint128_t(ll_hi, ll))?1:0);
+            low += product_low;
+            high += product_high + ((low < product_low)?1:0);
+        }
+        benchmark::DoNotOptimize(low);
+        benchmark::DoNotOptimize(high);
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_dot_loop)->Arg(1 << 12);
+
+static void BM_dot(benchmark::State & state){
+    const std::vector <uint128_t> a = random_values(state.range(0), 1);
+    const std::vector <uint128_t> b = random_values(state.range(0), 2);
+    for(auto _ : state){
+        benchmark::DoNotOptimize(uint128_dot(a.data(), b.data(), a.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_dot)->Arg(1 << 12);
+
+static void BM_sum_squares_u64(benchmark::State & state){
+    std::vector <uint64_t> in(state.range(0));
+    std::mt19937_64 gen(3);
+    for(uint64_t & x : in){
+        x = gen();
+    }
+    for(auto _ : state){
+        benchmark::DoNotOptimize(uint128_sum_squares(in.data(), in.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_sum_squares_u64)->Arg(1 << 12);
@@ -0,0 +1,62 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_scan.h"
+
+static std::vector <uint128_t> random_values(const std::size_t count){
+    std::mt19937_64 gen(1);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & value : out){
+        value = uint128_t(gen() >> 32, gen());
+    }
+    return out;
+}
+
+// a loop over operator+=
+static void BM_scan_loop(benchmark::State & state){
+    const std::vector <uint128_t> in = random_values(state.range(0));
+    std::vector <uint128_t> out(in.size());
+    for(auto _ : state){
+        uint128_t total = 0;
+        for(std::size_t i = 0; i < in.size(); i++){
+            total += in[i];
+            out[i] = total;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_scan_loop)->Arg(1 << 12)->Arg(1 << 20);
+
+static void BM_inclusive_scan(benchmark::State & state){
+    const std::vector <uint128_t> in = random_values(state.range(0));
+    std::vector <uint128_t> out(in.size());
+    for(auto _ : state){
+        uint128_inclusive_scan(in.data(), out.data(), in.size(), static_cast <uint128_scan_mode> (state.range(1)), state.range(2));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_inclusive_scan)
+    ->Args({1 << 12, UINT128_SCAN_WRAP, 1})
+    ->Args({1 << 12, UINT128_SCAN_CHECKED, 1})
+    ->Args({1 << 20, UINT128_SCAN_WRAP, 1})
+    ->Args({1 << 22, UINT128_SCAN_WRAP, 0})
+    ->UseRealTime();
+
+static void BM_segmented_scan(benchmark::State & state){
+    const std::vector <uint128_t> in = random_values(state.range(0));
+    std::vector <uint8_t> heads(in.size());
+    for(std::size_t i = 0; i < heads.size(); i += 64){
+        heads[i] = 1;
+    }
+    std::vector <uint128_t> out(in.size());
+    for(auto _ : state){
+        uint128_segmented_exclusive_scan(in.data(), heads.data(), out.data(), in.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * in.size());
+}
+BENCHMARK(BM_segmented_scan)->Arg(1 << 12);
@@ -0,0 +1,115 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint128_soa_vector.h"
+
+static std::vector <uint128_t> random_values(const std::size_t count, const uint64_t seed){
+    std::mt19937_64 gen(seed);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & value : out){
+        value = uint128_t(gen(), gen());
+    }
+    return out;
+}
+
+// the same operations on an array of uint128_t
+
+static void BM_aos_add(benchmark::State & state){
+    std::vector <uint128_t> a = random_values(state.range(0), 1);
+    const std::vector <uint128_t> b = random_values(state.range(0), 2);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            a[i] += b[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_aos_add)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_soa_add(benchmark::State & state){
+    uint128_soa_vector a(random_values(state.range(0), 1));
+    const uint128_soa_vector b(random_values(state.range(0), 2));
+    for(auto _ : state){
+        a += b;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_soa_add)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_aos_mult(benchmark::State & state){
+    std::vector <uint128_t> a = random_values(state.range(0), 1);
+    const uint128_t scalar(3, 0x9e3779b97f4a7c15ULL);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            a[i] *= scalar;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_aos_mult)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_soa_mult(benchmark::State & state){
+    uint128_soa_vector a(random_values(state.range(0), 1));
+    const uint128_t scalar(3, 0x9e3779b97f4a7c15ULL);
+    for(auto _ : state){
+        a *= scalar;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_soa_mult)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_aos_less(benchmark::State & state){
+    const std::vector <uint128_t> a = random_values(state.range(0), 1);
+    const std::vector <uint128_t> b = random_values(state.range(0), 2);
+    std::vector <uint8_t> out(a.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i] < b[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_aos_less)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_soa_less(benchmark::State & state){
+    const uint128_soa_vector a(random_values(state.range(0), 1));
+    const uint128_soa_vector b(random_values(state.range(0), 2));
+    std::vector <uint8_t> out(a.size());
+    for(auto _ : state){
+        a.less(b, out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_soa_less)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_aos_max(benchmark::State & state){
+    std::vector <uint128_t> a = random_values(state.range(0), 1);
+    const std::vector <uint128_t> b = random_values(state.range(0), 2);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            a[i] = (a[i] < b[i])?b[i]:a[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_aos_max)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_soa_max(benchmark::State & state){
+    uint128_soa_vector a(random_values(state.range(0), 1));
+    const uint128_soa_vector b(random_values(state.range(0), 2));
+    for(auto _ : state){
+        a.assign_max(b);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_soa_max)->Arg(1 << 10)->Arg(1 << 16);
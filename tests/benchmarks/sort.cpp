@@ -0,0 +1,32 @@
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "keys.h"
+#include "uint128_sort.h"
+
+static void BM_std_sort(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(static_cast <KeyDistribution> (state.range(0)), state.range(1));
+    for(auto _ : state){
+        std::vector <uint128_t> copy = keys;
+        std::sort(copy.begin(), copy.end());
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.SetLabel(KeyDistributionNames[state.range(0)]);
+}
+
+static void BM_radix_sort(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(static_cast <KeyDistribution> (state.range(0)), state.range(1));
+    for(auto _ : state){
+        std::vector <uint128_t> copy = keys;
+        radix_sort(copy, state.range(2));
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.SetLabel(KeyDistributionNames[state.range(0)]);
+}
+
+BENCHMARK(BM_std_sort)->ArgsProduct({{UUIDV4, IPV6}, {1 << 20}});
+BENCHMARK(BM_radix_sort)->ArgsProduct({{UUIDV4, IPV6}, {1 << 20}, {1, 0}})->UseRealTime();
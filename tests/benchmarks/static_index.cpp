@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "keys.h"
+#include "uint128_static_index.h"
+
+static std::vector <uint128_t> sorted_keys(const std::size_t n){
+    std::vector <uint128_t> keys = make_keys(UUIDV4, n);
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+static void BM_std_lower_bound(benchmark::State & state){
+    const std::vector <uint128_t> keys = sorted_keys(state.range(0));
+    const std::vector <uint128_t> queries = make_keys(UUIDV4, 1 << 12, 2);
+    for(auto _ : state){
+        std::size_t acc = 0;
+        for(uint128_t const & x : queries){
+            acc += std::lower_bound(keys.begin(), keys.end(), x) - keys.begin();
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_static_index_lower_bound(benchmark::State & state){
+    const uint128_static_index index(sorted_keys(state.range(0)));
+    const std::vector <uint128_t> queries = make_keys(UUIDV4, 1 << 12, 2);
+    for(auto _ : state){
+        std::size_t acc = 0;
+        for(uint128_t const & x : queries){
+            acc += index.lower_bound(x);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_static_index_lower_bound_batch(benchmark::State & state){
+    const uint128_static_index index(sorted_keys(state.range(0)));
+    const std::vector <uint128_t> queries = make_keys(UUIDV4, 1 << 12, 2);
+    std::vector <std::size_t> out(queries.size());
+    for(auto _ : state){
+        index.lower_bound(queries.data(), queries.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_std_lower_bound)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_static_index_lower_bound)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_static_index_lower_bound_batch)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,103 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "keys.h"
+#include "uint128_text.h"
+
+static std::vector <std::string> uuid_texts(){
+    std::vector <std::string> out;
+    char buf[UINT128_UUID_SIZE];
+    for(uint128_t const & key : make_keys(UUIDV4, 1 << 10)){
+        out.push_back(std::string(buf, uint128_format_uuid(key, buf)));
+    }
+    return out;
+}
+
+static std::vector <std::string> ipv6_texts(){
+    std::vector <std::string> out;
+    char buf[UINT128_IPV6_MAX_SIZE];
+    for(uint128_t const & key : make_keys(IPV6, 1 << 10)){
+        out.push_back(std::string(buf, uint128_format_ipv6(key, buf)));
+    }
+    return out;
+}
+
+// what callers did before: drop the separators and parse the hex digits
+static void BM_uuid_parse_strip_hex(benchmark::State & state){
+    const std::vector <std::string> texts = uuid_texts();
+    for(auto _ : state){
+        for(std::string const & text : texts){
+            std::string hex;
+            for(char c : text){
+                if (c != '-'){
+                    hex += c;
+                }
+            }
+            benchmark::DoNotOptimize(uint128_t(hex, 16));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * texts.size());
+}
+
+static void BM_uuid_parse(benchmark::State & state){
+    const std::vector <std::string> texts = uuid_texts();
+    for(auto _ : state){
+        for(std::string const & text : texts){
+            benchmark::DoNotOptimize(uint128_parse_uuid(text.data(), text.size()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * texts.size());
+}
+
+static void BM_uuid_format_str(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, 1 << 10);
+    for(auto _ : state){
+        for(uint128_t const & key : keys){
+            benchmark::DoNotOptimize(key.str(16, 32));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_uuid_format(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(UUIDV4, 1 << 10);
+    char buf[UINT128_UUID_SIZE];
+    for(auto _ : state){
+        for(uint128_t const & key : keys){
+            benchmark::DoNotOptimize(uint128_format_uuid(key, buf));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_ipv6_parse(benchmark::State & state){
+    const std::vector <std::string> texts = ipv6_texts();
+    for(auto _ : state){
+        for(std::string const & text : texts){
+            benchmark::DoNotOptimize(uint128_parse_ipv6(text.data(), text.size()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * texts.size());
+}
+
+static void BM_ipv6_format(benchmark::State & state){
+    const std::vector <uint128_t> keys = make_keys(IPV6, 1 << 10);
+    char buf[UINT128_IPV6_MAX_SIZE];
+    for(auto _ : state){
+        for(uint128_t const & key : keys){
+            benchmark::DoNotOptimize(uint128_format_ipv6(key, buf));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+BENCHMARK(BM_uuid_parse_strip_hex);
+BENCHMARK(BM_uuid_parse);
+BENCHMARK(BM_uuid_format_str);
+BENCHMARK(BM_uuid_format);
+BENCHMARK(BM_ipv6_parse);
+BENCHMARK(BM_ipv6_format);
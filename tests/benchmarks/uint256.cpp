@@ -0,0 +1,69 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "uint256_t.h"
+
+// operands of every width from 1 to 256 bits
+static std::vector <uint256_t> values(const std::size_t count, const unsigned max_bits = 256){
+    std::mt19937_64 gen(1);
+    std::vector <uint256_t> out(count);
+    for(uint256_t & x : out){
+        x = (uint256_t(uint128_t(gen(), gen()), uint128_t(gen(), gen())) >> (256 - 1 - gen() % max_bits)) | 1;
+    }
+    return out;
+}
+
+static void BM_multiply(benchmark::State & state){
+    const std::vector <uint256_t> a = values(1 << 10);
+    std::vector <uint256_t> out(a.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i] * a[a.size() - 1 - i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_multiply);
+
+static void BM_mul_wide(benchmark::State & state){
+    const std::vector <uint256_t> a = values(1 << 10);
+    std::vector <uint256_t> low(a.size());
+    std::vector <uint256_t> high(a.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            low[i] = uint256_t::mul_wide(a[i], a[a.size() - 1 - i], &high[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_mul_wide);
+
+// divisors of up to range(0) bits
+static void BM_divmod(benchmark::State & state){
+    const std::vector <uint256_t> a = values(1 << 10);
+    const std::vector <uint256_t> b = values(1 << 10, state.range(0));
+    std::vector <uint256_t> out(a.size());
+    for(auto _ : state){
+        for(std::size_t i = 0; i < a.size(); i++){
+            out[i] = a[i] % b[b.size() - 1 - i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_divmod)->Arg(64)->Arg(128)->Arg(256);
+
+static void BM_str(benchmark::State & state){
+    const std::vector <uint256_t> a = values(1 << 8);
+    for(auto _ : state){
+        for(const uint256_t & x : a){
+            benchmark::DoNotOptimize(x.str(state.range(0)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * a.size());
+}
+BENCHMARK(BM_str)->Arg(10)->Arg(16);
@@ -26,7 +26,7 @@ THE SOFTWARE.
 
 #include <gtest/gtest.h>
 
-int main(int argc, const char ** argv){
+int main(int argc, char ** argv){
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
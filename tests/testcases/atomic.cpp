@@ -0,0 +1,98 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_atomic.h"
+
+static const uint128_t ALL_ONES(0xffffffffffffffffULL, 0xffffffffffffffffULL);
+
+TEST(Atomic, operations){
+    atomic_uint128 a;
+    EXPECT_EQ(a.load(), uint128_0);
+
+    a.store(uint128_t(1, 0xffffffffffffffffULL));
+    EXPECT_EQ(a.fetch_add(1), uint128_t(1, 0xffffffffffffffffULL));
+    EXPECT_EQ(a.load(), uint128_t(2, 0));
+    EXPECT_EQ(a.fetch_sub(1), uint128_t(2, 0));
+    EXPECT_EQ((uint128_t) a, uint128_t(1, 0xffffffffffffffffULL));
+
+    EXPECT_EQ(a.exchange(uint128_t(0xf0f0, 0xff00)), uint128_t(1, 0xffffffffffffffffULL));
+    EXPECT_EQ(a.fetch_and(uint128_t(0xff00, 0x0ff0)), uint128_t(0xf0f0, 0xff00));
+    EXPECT_EQ(a.fetch_or(uint128_t(1, 1)), uint128_t(0xf000, 0x0f00));
+    EXPECT_EQ(a.fetch_xor(ALL_ONES), uint128_t(0xf001, 0x0f01));
+    EXPECT_EQ(a.load(), ~uint128_t(0xf001, 0x0f01));
+
+    a = uint128_0;
+    EXPECT_EQ(a -= 1, ALL_ONES);
+    EXPECT_EQ(a += 2, uint128_1);
+    EXPECT_EQ(a |= uint128_t(4, 0), uint128_t(4, 1));
+    EXPECT_EQ(a &= uint128_t(4, 0), uint128_t(4, 0));
+    EXPECT_EQ(a ^= uint128_t(4, 4), uint128_t(0, 4));
+}
+
+TEST(Atomic, compare_exchange){
+    atomic_uint128 a(uint128_t(5, 6));
+
+    uint128_t expected(5, 7);
+    EXPECT_FALSE(a.compare_exchange_strong(expected, uint128_t(8, 9)));
+    EXPECT_EQ(expected, uint128_t(5, 6));
+    EXPECT_EQ(a.load(), uint128_t(5, 6));
+
+    EXPECT_TRUE(a.compare_exchange_strong(expected, uint128_t(8, 9)));
+    EXPECT_EQ(expected, uint128_t(5, 6));
+    EXPECT_EQ(a.load(), uint128_t(8, 9));
+
+    // only one half matching is still a mismatch
+    expected = uint128_t(8, 0);
+    EXPECT_FALSE(a.compare_exchange_weak(expected, uint128_0));
+    EXPECT_EQ(expected, uint128_t(8, 9));
+}
+
+TEST(Atomic, lock_free){
+#if ((defined(__GNUC__) && defined(__x86_64__)) || (defined(_MSC_VER) && defined(_M_X64))) && !defined(UINT128_ATOMIC_USE_LOCKS)
+    EXPECT_TRUE(atomic_uint128().is_lock_free());
+#endif
+    EXPECT_EQ(atomic_uint128().is_lock_free(), atomic_uint128::is_always_lock_free);
+    EXPECT_EQ(alignof(atomic_uint128), 16U);
+}
+
+TEST(Atomic, concurrent_add){
+    // every increment carries into the upper half at some point
+    const uint128_t start(0, 0xffffffffffffffffULL - 5000);
+    atomic_uint128 a(start);
+
+    const unsigned threads = 4;
+    const unsigned adds = 20000;
+    std::vector <std::thread> workers;
+    for(unsigned t = 0; t < threads; t++){
+        workers.emplace_back([&a](){
+            for(unsigned i = 0; i < adds; i++){
+                a.fetch_add(uint128_t(1, 1));
+            }
+        });
+    }
+    for(std::thread & worker : workers){
+        worker.join();
+    }
+    EXPECT_EQ(a.load(), start + uint128_t(threads * adds) * uint128_t(1, 1));
+}
+
+TEST(Atomic, no_torn_reads){
+    // the writer only ever stores values whose halves are equal
+    atomic_uint128 a;
+    std::thread writer([&a](){
+        for(uint64_t i = 1; i <= 50000; i++){
+            a.store(uint128_t(i, i));
+        }
+    });
+
+    bool torn = false;
+    for(int i = 0; i < 50000; i++){
+        const uint128_t x = a.load();
+        torn |= x.upper() != x.lower();
+    }
+    writer.join();
+    EXPECT_FALSE(torn);
+    EXPECT_EQ(a.load(), uint128_t(50000, 50000));
+}
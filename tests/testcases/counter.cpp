@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_counter.h"
+
+TEST(ShardedCounter, shards){
+    EXPECT_EQ(sharded_counter128(1).shards(), 1U);
+    EXPECT_EQ(sharded_counter128(5).shards(), 8U);
+    EXPECT_GE(sharded_counter128().shards(), 1U);
+}
+
+TEST(ShardedCounter, add_read_reset){
+    sharded_counter128 counter(4);
+    EXPECT_EQ(counter.read(), uint128_0);
+
+    counter.add(uint128_t(0, 0xffffffffffffffffULL));
+    counter += uint128_1;
+    ++counter;
+    EXPECT_EQ(counter.read(), uint128_t(1, 1));
+    EXPECT_EQ((uint128_t) counter, uint128_t(1, 1));
+
+    EXPECT_EQ(counter.reset(), uint128_t(1, 1));
+    EXPECT_EQ(counter.read(), uint128_0);
+}
+
+TEST(ShardedCounter, concurrent_add){
+    sharded_counter128 counter(2);
+    const unsigned threads = 4;
+    const unsigned adds = 20000;
+    const uint128_t step(1, 0xffffffffffff0000ULL);
+
+    std::vector <std::thread> workers;
+    for(unsigned t = 0; t < threads; t++){
+        workers.emplace_back([&](){
+            for(unsigned i = 0; i < adds; i++){
+                counter.add(step);
+            }
+        });
+    }
+    for(std::thread & worker : workers){
+        worker.join();
+    }
+    EXPECT_EQ(counter.read(), step * uint128_t(threads * adds));
+}
+
+TEST(ShardedCounter, reserve){
+    sharded_counter128 counter;
+    EXPECT_EQ(counter.reserve(10), uint128_0);
+    EXPECT_EQ(counter.reserve(uint128_t(1, 0)), uint128_t(10));
+    EXPECT_EQ(counter.reserved(), uint128_t(1, 10));
+    // reserving does not count as adding
+    EXPECT_EQ(counter.read(), uint128_0);
+
+    // blocks reserved by different threads never overlap
+    const unsigned threads = 4;
+    const unsigned blocks = 1000;
+    std::vector <std::vector <uint128_t> > firsts(threads);
+    std::vector <std::thread> workers;
+    for(unsigned t = 0; t < threads; t++){
+        workers.emplace_back([&, t](){
+            for(unsigned i = 0; i < blocks; i++){
+                firsts[t].push_back(counter.reserve(16));
+            }
+        });
+    }
+    for(std::thread & worker : workers){
+        worker.join();
+    }
+
+    std::vector <uint128_t> all;
+    for(std::vector <uint128_t> const & f : firsts){
+        EXPECT_TRUE(std::is_sorted(f.begin(), f.end()));
+        all.insert(all.end(), f.begin(), f.end());
+    }
+    std::sort(all.begin(), all.end());
+    for(std::size_t i = 0; i < all.size(); i++){
+        EXPECT_EQ(all[i], uint128_t(1, 10) + uint128_t(16 * i));
+    }
+    EXPECT_EQ(counter.reserved(), uint128_t(1, 10) + uint128_t(16 * threads * blocks));
+}
+
+TEST(ShardedCounter, ordinals){
+    // ordinals of finished threads are handed out again, so live threads stay on distinct shards
+    unsigned first = 0;
+    std::thread a([&](){ first = uint128_thread_ordinal(); });
+    a.join();
+    unsigned second = 0;
+    std::thread b([&](){ second = uint128_thread_ordinal(); });
+    b.join();
+    EXPECT_EQ(first, second);
+
+    unsigned inner = 0;
+    std::thread c([&](){
+        const unsigned outer = uint128_thread_ordinal();
+        std::thread d([&](){ inner = uint128_thread_ordinal(); });
+        d.join();
+        EXPECT_NE(inner, outer);
+    });
+    c.join();
+    EXPECT_NE(inner, uint128_thread_ordinal());
+}
+
+TEST(ShardedCounter, move){
+    sharded_counter128 counter(4);
+    counter.add(uint128_t(1, 2));
+    counter.reserve(5);
+
+    sharded_counter128 moved(std::move(counter));
+    EXPECT_EQ(moved.read(), uint128_t(1, 2));
+    EXPECT_EQ(moved.reserved(), uint128_t(5));
+
+    sharded_counter128 assigned(1);
+    assigned = std::move(moved);
+    assigned.add(uint128_1);
+    EXPECT_EQ(assigned.shards(), 4U);
+    EXPECT_EQ(assigned.read(), uint128_t(1, 3));
+    EXPECT_EQ(assigned.reserved(), uint128_t(5));
+}
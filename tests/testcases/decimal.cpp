@@ -0,0 +1,205 @@
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "uint128_decimal.h"
+
+typedef fixed_decimal <2> money;
+typedef signed_fixed_decimal <2> signed_money;
+
+static money parse_money(const char * s){
+    return money::parse(s, std::strlen(s));
+}
+
+static signed_money parse_signed(const char * s){
+    return signed_money::parse(s, std::strlen(s));
+}
+
+// round(n / d), ties to even, with the existing uint128_t division
+static uint128_t reference_round(const uint128_t & n, const uint128_t & d){
+    const std::pair <uint128_t, uint128_t> qr = uint128_t::divmod(n, d);
+    const uint128_t half = d - qr.second;
+    if ((qr.second > half) || ((qr.second == half) && (qr.first & 1))){
+        return qr.first + 1;
+    }
+    return qr.first;
+}
+
+// uint128_decimal::divide <P> against the shift and subtract division
+template <unsigned P>
+static void check_divide(std::mt19937_64 & gen){
+    const uint128_decimal::word d = uint128_decimal::power(P);
+    for(unsigned i = 0; i < 100; i++){
+        uint128_decimal::word u1{gen(), gen()};
+        const uint128_decimal::word u0{gen(), gen()};
+        // u1 < d, and sometimes right below it
+        u1 = uint128_decimal::long_divide(uint128_decimal::word{0, 0}, u1, d).remainder;
+        if (i & 1){
+            u1 = uint128_decimal::subtract(d, uint128_decimal::word{0, 1});
+        }
+        const uint128_decimal::division expected = uint128_decimal::long_divide(u1, u0, d);
+        const uint128_decimal::division qr = uint128_decimal::divide <P> (u1, u0);
+        EXPECT_TRUE(uint128_decimal::equal(qr.quotient, expected.quotient)) << P;
+        EXPECT_TRUE(uint128_decimal::equal(qr.remainder, expected.remainder)) << P;
+    }
+    check_divide <P - 1> (gen);
+}
+
+template <>
+void check_divide <0> (std::mt19937_64 &){}
+
+TEST(Decimal, divide_by_power){
+    std::mt19937_64 gen(1);
+    check_divide <38> (gen);
+}
+
+TEST(Decimal, format_parse){
+    EXPECT_EQ(parse_money("123.45").raw(), uint128_t(12345));
+    EXPECT_EQ(parse_money("123.45").str(), "123.45");
+    EXPECT_EQ(parse_money("0.05").str(), "0.05");
+    EXPECT_EQ(parse_money("7").str(), "7.00");
+    EXPECT_EQ(parse_money("7.").str(), "7.00");
+    EXPECT_EQ(parse_money(".5").str(), "0.50");
+    EXPECT_EQ(parse_money("001.230").str(), "1.23");
+    EXPECT_EQ(money().str(), "0.00");
+    EXPECT_EQ(fixed_decimal <0>::from_raw(42).str(), "42");
+
+    // the whole range
+    EXPECT_EQ(fixed_decimal <0>::from_raw(~uint128_0).str(), "340282366920938463463374607431768211455");
+    EXPECT_EQ(fixed_decimal <38>::from_raw(~uint128_0).str(), "3.40282366920938463463374607431768211455");
+    EXPECT_EQ(fixed_decimal <38>::from_raw(1).str(), "0.00000000000000000000000000000000000001");
+    EXPECT_EQ(fixed_decimal <0>::parse("340282366920938463463374607431768211455", 39).raw(), ~uint128_0);
+
+    for(const char * bad : {"", ".", "-1", "+1", "1.2.3", "1,5", "abc", "1.234", "12 ", "340282366920938463.463374607431768211456"}){
+        money out = money::from_raw(99);
+        EXPECT_FALSE(money::try_parse(bad, std::strlen(bad), out)) << bad;
+        EXPECT_EQ(out.raw(), uint128_t(99));
+        EXPECT_THROW(money::parse(bad, std::strlen(bad)), std::invalid_argument);
+    }
+    fixed_decimal <0> out;
+    EXPECT_FALSE(fixed_decimal <0>::try_parse("340282366920938463463374607431768211456", 39, out));
+
+    // random round trips
+    std::mt19937_64 gen(2);
+    for(unsigned i = 0; i < 1000; i++){
+        const fixed_decimal <7> x = fixed_decimal <7>::from_raw(uint128_t(gen(), gen()) >> (gen() & 127));
+        char text[FIXED_DECIMAL_MAX_SIZE];
+        const std::size_t len = x.format(text);
+        EXPECT_EQ(fixed_decimal <7>::parse(text, len), x);
+        EXPECT_EQ(std::string(text, len), x.raw().str(10, 8).insert(x.raw().str(10, 8).size() - 7, "."));
+    }
+}
+
+TEST(Decimal, add_sub){
+    EXPECT_EQ(parse_money("1.25") + parse_money("2.80"), parse_money("4.05"));
+    EXPECT_EQ(parse_money("4.05") - parse_money("2.80"), parse_money("1.25"));
+    money x = parse_money("1");
+    x += parse_money("0.01");
+    x -= parse_money("0.02");
+    EXPECT_EQ(x, parse_money("0.99"));
+
+    EXPECT_THROW(money::from_raw(~uint128_0) + money::from_raw(1), std::overflow_error);
+    EXPECT_THROW(parse_money("1") - parse_money("1.01"), std::overflow_error);
+}
+
+TEST(Decimal, multiply){
+    // ties go to the even neighbour
+    EXPECT_EQ(parse_money("1.25") * parse_money("0.5"), parse_money("0.62"));
+    EXPECT_EQ(parse_money("1.35") * parse_money("0.5"), parse_money("0.68"));
+    EXPECT_EQ(parse_money("0.01") * parse_money("0.01"), money());
+    EXPECT_EQ(parse_money("0.07") * parse_money("0.07"), parse_money("0.00"));
+    EXPECT_EQ(parse_money("0.08") * parse_money("0.08"), parse_money("0.01"));
+    EXPECT_EQ(parse_money("12.34") * parse_money("100"), parse_money("1234"));
+
+    // the 256-bit product: (2^127 + 12345) * (10^30 + 7) / 10^38
+    const fixed_decimal <38> a = fixed_decimal <38>::from_raw(uint128_t(0x8000000000000000ULL, 0x3039));
+    const fixed_decimal <38> b = fixed_decimal <38>::from_raw(uint128_t(0xc9f2c9cd0ULL, 0x4674edea40000007ULL));
+    EXPECT_EQ((a * b).raw(), uint128_t(0x15798ee230ULL, 0x8c39df9fb841a573ULL));
+    EXPECT_THROW(fixed_decimal <20>::from_raw(a.raw()) * fixed_decimal <20>::from_raw(b.raw()), std::overflow_error);
+    EXPECT_THROW(fixed_decimal <0>::from_raw(uint128_1 << 64) * fixed_decimal <0>::from_raw(uint128_1 << 64), std::overflow_error);
+
+    // against divmod on products that fit in 128 bits
+    std::mt19937_64 gen(3);
+    for(unsigned i = 0; i < 1000; i++){
+        const uint128_t x = gen(), y = gen() >> (gen() & 63);
+        EXPECT_EQ((money::from_raw(x) * money::from_raw(y)).raw(), reference_round(x * y, 100));
+        EXPECT_EQ((fixed_decimal <17>::from_raw(x) * fixed_decimal <17>::from_raw(y)).raw(), reference_round(x * y, uint128_t(100000000000000000ULL)));
+    }
+}
+
+TEST(Decimal, divide){
+    EXPECT_EQ(parse_money("1") / parse_money("3"), parse_money("0.33"));
+    EXPECT_EQ(parse_money("2") / parse_money("3"), parse_money("0.67"));
+    EXPECT_EQ(parse_money("1") / parse_money("8"), parse_money("0.12"));
+    EXPECT_EQ(parse_money("3") / parse_money("8"), parse_money("0.38"));
+    EXPECT_EQ(parse_money("100") / parse_money("0.01"), parse_money("10000"));
+    EXPECT_THROW(parse_money("1") / money(), std::domain_error);
+    EXPECT_THROW(money::from_raw(~uint128_0) / parse_money("0.5"), std::overflow_error);
+
+    // (2^127 + 12345) * 10^20 / (10^30 + 7) needs the 256-bit dividend
+    const fixed_decimal <20> a = fixed_decimal <20>::from_raw(uint128_t(0x8000000000000000ULL, 0x3039));
+    const fixed_decimal <20> b = fixed_decimal <20>::from_raw(uint128_t(0xc9f2c9cd0ULL, 0x4674edea40000007ULL));
+    EXPECT_EQ((a / b).raw(), uint128_t(0x36f9bfb3ULL, 0xaf7b756fad5cd103ULL));
+
+    // against divmod
+    std::mt19937_64 gen(4);
+    for(unsigned i = 0; i < 1000; i++){
+        const uint128_t x = gen() >> 8, y = (gen() >> (gen() & 63)) | 1;
+        EXPECT_EQ((money::from_raw(x) / money::from_raw(y)).raw(), reference_round(x * 100, y));
+        const uint128_t wide = uint128_t(gen() >> 1, gen()), narrow = uint128_t(gen(), gen()) | 1;
+        EXPECT_EQ((fixed_decimal <0>::from_raw(wide) / fixed_decimal <0>::from_raw(narrow)).raw(), reference_round(wide, narrow));
+    }
+}
+
+TEST(Decimal, rescale){
+    EXPECT_EQ(fixed_decimal <3>::from_raw(1005).rescale <2> (), parse_money("1.00"));
+    EXPECT_EQ(fixed_decimal <3>::from_raw(1015).rescale <2> (), parse_money("1.02"));
+    EXPECT_EQ(fixed_decimal <3>::from_raw(1016).rescale <2> (), parse_money("1.02"));
+    EXPECT_EQ(parse_money("1.5").rescale <5> ().str(), "1.50000");
+    EXPECT_EQ(parse_money("1.5").rescale <2> (), parse_money("1.5"));
+    EXPECT_EQ(parse_money("2.5").rescale <0> ().raw(), uint128_t(2));
+    EXPECT_EQ(parse_money("3.5").rescale <0> ().raw(), uint128_t(4));
+    EXPECT_EQ(fixed_decimal <38>::from_raw(~uint128_0).rescale <0> ().raw(), uint128_t(3));
+    EXPECT_THROW(money::from_raw(~uint128_0).rescale <3> (), std::overflow_error);
+
+    EXPECT_EQ(parse_money("123.99").integer(), uint128_t(123));
+    EXPECT_EQ(money::from_integer(123), parse_money("123"));
+    EXPECT_THROW(fixed_decimal <38>::from_integer(4), std::overflow_error);
+}
+
+TEST(Decimal, compare){
+    EXPECT_LT(parse_money("1.01"), parse_money("1.1"));
+    EXPECT_GT(parse_money("10"), parse_money("9.99"));
+    EXPECT_LE(parse_money("1"), parse_money("1.00"));
+    EXPECT_GE(parse_money("1"), parse_money("1.00"));
+    EXPECT_NE(parse_money("1"), parse_money("1.01"));
+
+    EXPECT_LT(parse_signed("-2"), parse_signed("-1"));
+    EXPECT_LT(parse_signed("-1"), parse_signed("0"));
+    EXPECT_LT(parse_signed("0"), parse_signed("0.01"));
+    EXPECT_EQ(parse_signed("-0"), parse_signed("0"));
+}
+
+TEST(Decimal, signed){
+    EXPECT_EQ(parse_signed("-1.50") + parse_signed("1.25"), parse_signed("-0.25"));
+    EXPECT_EQ(parse_signed("1.50") - parse_signed("1.75"), parse_signed("-0.25"));
+    EXPECT_EQ(parse_signed("-1.50") - parse_signed("-1.50"), signed_money());
+    EXPECT_FALSE((parse_signed("-1.50") + parse_signed("1.50")).negative());
+    EXPECT_EQ(parse_signed("-1.5") * parse_signed("-2"), parse_signed("3"));
+    EXPECT_EQ(parse_signed("-1.5") * parse_signed("2"), parse_signed("-3"));
+    EXPECT_EQ(parse_signed("1") / parse_signed("-3"), parse_signed("-0.33"));
+    EXPECT_EQ(-parse_signed("2.5"), parse_signed("-2.5"));
+    EXPECT_EQ(parse_signed("-1.25").rescale <1> (), signed_fixed_decimal <1>::parse("-1.2", 4));
+
+    EXPECT_EQ(parse_signed("-0.25").str(), "-0.25");
+    EXPECT_EQ(parse_signed("+7").str(), "7.00");
+    EXPECT_EQ(parse_signed("-0.00").str(), "0.00");
+    EXPECT_EQ(signed_fixed_decimal <38>(fixed_decimal <38>::from_raw(~uint128_0), true).str(), "-3.40282366920938463463374607431768211455");
+    EXPECT_EQ(signed_fixed_decimal <38>(fixed_decimal <38>::from_raw(1), true).str().size(), FIXED_DECIMAL_MAX_SIZE);
+    for(const char * bad : {"", "-", "+", "--1", "-+1", "1-"}){
+        EXPECT_THROW(signed_money::parse(bad, std::strlen(bad)), std::invalid_argument) << bad;
+    }
+}
@@ -0,0 +1,130 @@
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t.h"
+#include "uint128_float.h"
+#include "uint128_soa_vector.h"
+#include "uint128_text.h"
+#include "uint256_t.h"
+
+// each level the library can be switched to, lowest first
+static const unsigned LEVELS[] = {
+    0,
+    UINT128_CPU_POPCNT | UINT128_CPU_LZCNT | UINT128_CPU_BMI2 | UINT128_CPU_ADX,
+    UINT128_CPU_SSSE3 | UINT128_CPU_POPCNT | UINT128_CPU_LZCNT | UINT128_CPU_BMI2 | UINT128_CPU_ADX | UINT128_CPU_AVX2,
+    ~0U,
+};
+
+// operands with words of all sizes, including runs of zeros and ones
+static uint128_t random(std::mt19937_64 & gen){
+    uint64_t w[2];
+    for(uint64_t & x : w){
+        switch (gen() % 4){
+            case 0: x = 0; break;
+            case 1: x = ~0ULL; break;
+            default: x = gen(); break;
+        }
+    }
+    return uint128_t(w[1], w[0]) >> (gen() % 128);
+}
+
+TEST(Dispatch, features){
+    const unsigned cpu = uint128_cpu_features();
+    EXPECT_EQ(uint128_dispatch_features() & ~cpu, 0U);
+
+    for(const unsigned level : LEVELS){
+        EXPECT_EQ(uint128_set_dispatch(level), level & cpu);
+        EXPECT_EQ(uint128_dispatch_features(), level & cpu);
+        const std::string name = uint128_dispatch_name();
+        EXPECT_TRUE(name == "baseline" || name == "bmi2" || name == "avx2" || name == "avx512") << name;
+    }
+
+    uint128_set_dispatch(0);
+    EXPECT_EQ(std::string(uint128_dispatch_name()), "baseline");
+    EXPECT_FALSE(uint128_dispatch_has(UINT128_CPU_BMI2));
+    uint128_set_dispatch(~0U);
+    EXPECT_EQ(uint128_dispatch_features(), cpu);
+}
+
+TEST(Dispatch, kernels){
+    // every variant gives the same answers as the baseline one
+    std::mt19937_64 gen(1);
+    std::vector <uint128_t> a(1000), b(1000);
+    for(std::size_t i = 0; i < a.size(); i++){
+        a[i] = random(gen);
+        b[i] = random(gen) | 1;
+    }
+    std::vector <double> doubles(a.size());
+    for(std::size_t i = 0; i < doubles.size(); i++){
+        doubles[i] = std::ldexp(static_cast <double> (gen() >> 11), static_cast <int> (gen() % 76));
+    }
+
+    std::vector <std::string> str;
+    std::vector <uint128_t> quot, rem, from;
+    std::vector <uint256_t> prod;
+    std::vector <double> to;
+    std::vector <uint8_t> less;
+    std::string text;
+    for(const unsigned level : LEVELS){
+        uint128_set_dispatch(level);
+        SCOPED_TRACE(uint128_dispatch_name());
+
+        std::vector <std::string> s;
+        std::vector <uint128_t> q, r;
+        std::vector <uint256_t> p;
+        for(std::size_t i = 0; i < a.size(); i++){
+            const std::pair <uint128_t, uint128_t> qr = uint128_t::divmod(a[i], b[i]);
+            q.push_back(qr.first);
+            r.push_back(qr.second);
+            for(const uint8_t base : {2, 7, 8, 10, 16}){
+                s.push_back(a[i].str(base));
+            }
+            uint256_t high;
+            p.push_back(uint256_t::mul_wide(uint256_t(a[i], b[i]), uint256_t(b[i], a[i]), &high));
+            p.push_back(high);
+        }
+
+        std::vector <double> t(a.size());
+        uint128_float::to_double(a.data(), t.data(), a.size());
+        std::vector <uint128_t> f(doubles.size());
+        EXPECT_FALSE(uint128_float::from_double(doubles.data(), f.data(), doubles.size()));
+
+        uint128_soa_vector soa(a);
+        soa += uint128_soa_vector(b);
+        soa -= a[7];
+        soa.assign_max(uint128_soa_vector(b));
+        std::vector <uint8_t> l(a.size());
+        soa.less(uint128_soa_vector(a), l.data());
+
+        char uuid[36];
+        std::string x(uuid, uint128_format_uuid(a[3], uuid));
+        uint128_t back;
+        EXPECT_TRUE(uint128_try_parse_uuid(uuid, sizeof(uuid), back));
+        EXPECT_EQ(back, a[3]);
+
+        if (!level){
+            str = s; quot = q; rem = r; prod = p; to = t; from = f; less = l; text = x;
+
+            // and the baseline results are checked directly
+            for(std::size_t i = 0; i < a.size(); i++){
+                EXPECT_EQ(q[i] * b[i] + r[i], a[i]);
+                EXPECT_LT(r[i], b[i]);
+                EXPECT_EQ(uint128_t(s[i * 5 + 3], 10), a[i]);
+            }
+            continue;
+        }
+        EXPECT_EQ(s, str);
+        EXPECT_EQ(q, quot);
+        EXPECT_EQ(r, rem);
+        EXPECT_EQ(p, prod);
+        EXPECT_EQ(t, to);
+        EXPECT_EQ(f, from);
+        EXPECT_EQ(l, less);
+        EXPECT_EQ(x, text);
+    }
+    uint128_set_dispatch(~0U);
+}
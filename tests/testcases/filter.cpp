@@ -0,0 +1,169 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_filter.h"
+
+static std::vector <uint128_t> random_keys(const std::size_t count, const uint64_t seed){
+    std::mt19937_64 gen(seed);
+    std::vector <uint128_t> keys;
+    for(std::size_t i = 0; i < count; i++){
+        keys.push_back(uint128_t(gen(), gen()));
+    }
+    return keys;
+}
+
+TEST(BloomFilter, no_false_negatives){
+    const std::vector <uint128_t> keys = random_keys(10000, 1);
+    uint128_bloom_filter filter(keys.size(), 0.01);
+    for(uint128_t const & key : keys){
+        filter.insert(key);
+    }
+    for(uint128_t const & key : keys){
+        EXPECT_TRUE(filter.contains(key));
+    }
+
+    // sequential keys differ in only a few bits
+    uint128_bloom_filter sequential(1000);
+    for(uint64_t i = 0; i < 1000; i++){
+        sequential.insert(uint128_t(i, i));
+    }
+    for(uint64_t i = 0; i < 1000; i++){
+        EXPECT_TRUE(sequential.contains(uint128_t(i, i)));
+    }
+}
+
+TEST(BloomFilter, false_positive_rate){
+    const std::vector <uint128_t> keys = random_keys(20000, 1);
+    const std::vector <uint128_t> others = random_keys(100000, 2);
+    uint128_bloom_filter filter(keys.size(), 0.01);
+    filter.insert(keys.data(), keys.size());
+
+    std::vector <char> out(others.size());
+    const std::size_t found = filter.contains(others.data(), others.size(), reinterpret_cast <bool *> (out.data()));
+    // sized for 1%; allow for sampling noise only
+    EXPECT_LT(found, others.size() * 11 / 1000);
+
+    std::size_t count = 0;
+    for(std::size_t i = 0; i < others.size(); i++){
+        EXPECT_EQ((bool) out[i], filter.contains(others[i]));
+        count += out[i];
+    }
+    EXPECT_EQ(count, found);
+
+    filter.clear();
+    EXPECT_EQ(filter.contains(others.data(), others.size(), reinterpret_cast <bool *> (out.data())), 0U);
+}
+
+TEST(BloomFilter, serialize){
+    const std::vector <uint128_t> keys = random_keys(5000, 3);
+    uint128_bloom_filter filter(keys.size());
+    filter.insert(keys.data(), keys.size());
+
+    const std::vector <uint8_t> bytes = filter.serialize();
+    const uint128_bloom_filter copy = uint128_bloom_filter::deserialize(bytes.data(), bytes.size());
+    EXPECT_EQ(copy.blocks(), filter.blocks());
+    EXPECT_EQ(copy.serialize(), bytes);
+    for(uint128_t const & key : random_keys(5000, 4)){
+        EXPECT_EQ(copy.contains(key), filter.contains(key));
+    }
+    for(uint128_t const & key : keys){
+        EXPECT_TRUE(copy.contains(key));
+    }
+
+    EXPECT_THROW(uint128_bloom_filter::deserialize(bytes.data(), bytes.size() - 1), std::invalid_argument);
+    EXPECT_THROW(uint128_bloom_filter::deserialize(bytes.data(), 3), std::invalid_argument);
+    std::vector <uint8_t> bad = bytes;
+    bad[0] = 'X';
+    EXPECT_THROW(uint128_bloom_filter::deserialize(bad.data(), bad.size()), std::invalid_argument);
+    EXPECT_THROW(uint128_bloom_filter(10, 0), std::invalid_argument);
+    EXPECT_THROW(uint128_bloom_filter(10, 1), std::invalid_argument);
+}
+
+TEST(CuckooFilter, insert_contains_erase){
+    const std::vector <uint128_t> keys = random_keys(10000, 5);
+    uint128_cuckoo_filter filter(keys.size());
+    EXPECT_GE(filter.capacity(), keys.size());
+    for(uint128_t const & key : keys){
+        EXPECT_TRUE(filter.insert(key));
+    }
+    EXPECT_EQ(filter.size(), keys.size());
+    for(uint128_t const & key : keys){
+        EXPECT_TRUE(filter.contains(key));
+    }
+
+    for(std::size_t i = 0; i < keys.size(); i += 2){
+        EXPECT_TRUE(filter.erase(keys[i]));
+    }
+    EXPECT_EQ(filter.size(), keys.size() / 2);
+    for(std::size_t i = 1; i < keys.size(); i += 2){
+        EXPECT_TRUE(filter.contains(keys[i]));
+    }
+
+    // 16-bit fingerprints in 8 slots: about 8 / 65536 false positives
+    std::size_t found = 0;
+    for(uint128_t const & key : random_keys(100000, 6)){
+        found += filter.contains(key);
+    }
+    EXPECT_LT(found, 100U);
+}
+
+TEST(CuckooFilter, duplicates_and_full){
+    uint128_cuckoo_filter filter(8);
+    for(int i = 0; i < 3; i++){
+        EXPECT_TRUE(filter.insert(uint128_t(7, 7)));
+    }
+    EXPECT_EQ(filter.size(), 3U);
+    for(int i = 0; i < 3; i++){
+        EXPECT_TRUE(filter.erase(uint128_t(7, 7)));
+    }
+    EXPECT_FALSE(filter.contains(uint128_t(7, 7)));
+    EXPECT_FALSE(filter.erase(uint128_t(7, 7)));
+
+    // once full, inserts fail but every key that was added is still found
+    std::vector <uint128_t> added;
+    for(uint128_t const & key : random_keys(1000, 7)){
+        if (filter.insert(key)){
+            added.push_back(key);
+        }
+    }
+    EXPECT_EQ(filter.size(), added.size());
+    EXPECT_LE(added.size(), filter.capacity() + 1);
+    for(uint128_t const & key : added){
+        EXPECT_TRUE(filter.contains(key));
+    }
+
+    // erasing makes room again
+    for(uint128_t const & key : added){
+        EXPECT_TRUE(filter.erase(key));
+    }
+    EXPECT_EQ(filter.size(), 0U);
+    EXPECT_TRUE(filter.insert(uint128_t(1)));
+}
+
+TEST(CuckooFilter, bulk_serialize){
+    const std::vector <uint128_t> keys = random_keys(20000, 8);
+    uint128_cuckoo_filter filter(keys.size());
+    EXPECT_EQ(filter.insert(keys.data(), keys.size()), keys.size());
+
+    std::vector <char> out(keys.size());
+    EXPECT_EQ(filter.contains(keys.data(), keys.size(), reinterpret_cast <bool *> (out.data())), keys.size());
+
+    const std::vector <uint8_t> bytes = filter.serialize();
+    uint128_cuckoo_filter copy = uint128_cuckoo_filter::deserialize(bytes.data(), bytes.size());
+    EXPECT_EQ(copy.size(), filter.size());
+    EXPECT_EQ(copy.capacity(), filter.capacity());
+    EXPECT_EQ(copy.serialize(), bytes);
+    for(uint128_t const & key : keys){
+        EXPECT_TRUE(copy.contains(key));
+    }
+    EXPECT_TRUE(copy.erase(keys[0]));
+
+    EXPECT_THROW(uint128_cuckoo_filter::deserialize(bytes.data(), bytes.size() - 16), std::invalid_argument);
+    std::vector <uint8_t> bad = bytes;
+    bad[5] ^= 1;    // bucket count
+    EXPECT_THROW(uint128_cuckoo_filter::deserialize(bad.data(), bad.size()), std::invalid_argument);
+    EXPECT_THROW(uint128_cuckoo_filter::deserialize(nullptr, 0), std::invalid_argument);
+}
@@ -0,0 +1,162 @@
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "uint128_flat_map.h"
+
+// allocations of at least this many bytes fail while it is nonzero
+static std::size_t fail_from = 0;
+
+void * operator new(std::size_t size){
+    if (fail_from && (size >= fail_from)){
+        throw std::bad_alloc();
+    }
+    if (void * ptr = std::malloc(size ? size : 1)){
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept{
+    std::free(ptr);
+}
+
+TEST(FlatMap, insert_find){
+    uint128_flat_map <std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(1), map.end());
+
+    EXPECT_TRUE(map.insert(std::make_pair(uint128_t(1), std::string("one"))).second);
+    EXPECT_FALSE(map.insert(std::make_pair(uint128_t(1), std::string("uno"))).second);
+    map[uint128_t(2, 3)] = "two three";
+
+    EXPECT_EQ(map.size(), 2U);
+    EXPECT_EQ(map.at(1), "one");
+    EXPECT_EQ(map.find(2, 3) -> second, "two three");
+    EXPECT_TRUE(map.contains(uint128_t(2, 3)));
+    EXPECT_FALSE(map.contains(3, 2));
+    EXPECT_EQ(map.count(1), 1U);
+    EXPECT_THROW(map.at(5), std::out_of_range);
+}
+
+TEST(FlatMap, every_value_is_a_key){
+    uint128_flat_map <int> map;
+    map[uint128_0] = 1;
+    map[uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)] = 2;
+    EXPECT_EQ(map.size(), 2U);
+    EXPECT_EQ(map[uint128_0], 1);
+    EXPECT_EQ(map[uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL)], 2);
+}
+
+TEST(FlatMap, against_std_map){
+    std::mt19937_64 gen(42);
+    uint128_flat_map <uint64_t> map;
+    std::map <uint128_t, uint64_t> reference;
+
+    // small key space so that inserts, overwrites and erases all hit
+    for(int i = 0; i < 20000; i++){
+        const uint128_t key(gen() & 3, gen() & 1023);
+        const uint64_t op = gen() % 3;
+        if (op == 0){
+            EXPECT_EQ(map.erase(key), reference.erase(key));
+        }
+        else{
+            map[key] = i;
+            reference[key] = i;
+        }
+    }
+
+    EXPECT_EQ(map.size(), reference.size());
+    for(std::pair <const uint128_t, uint64_t> const & kv : reference){
+        ASSERT_TRUE(map.contains(kv.first));
+        EXPECT_EQ(map.at(kv.first), kv.second);
+    }
+
+    std::size_t seen = 0;
+    for(std::pair <const uint128_t, uint64_t> const & kv : map){
+        EXPECT_EQ(reference.at(kv.first), kv.second);
+        seen++;
+    }
+    EXPECT_EQ(seen, reference.size());
+}
+
+TEST(FlatMap, copy_move_clear){
+    uint128_flat_map <int> map(100);
+    EXPECT_GE(map.capacity(), 100U);
+    for(int i = 0; i < 100; i++){
+        map[uint128_t(i, i)] = i;
+    }
+
+    uint128_flat_map <int> copy(map);
+    EXPECT_EQ(copy.size(), 100U);
+    EXPECT_EQ(copy[uint128_t(50, 50)], 50);
+
+    uint128_flat_map <int> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 100U);
+    EXPECT_EQ(moved.at(uint128_t(99, 99)), 99);
+
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(moved.find(uint128_t(1, 1)), moved.end());
+    EXPECT_EQ(copy.size(), 100U);
+}
+
+TEST(FlatMap, erase_iterator){
+    uint128_flat_map <int> map;
+    for(int i = 0; i < 10; i++){
+        map[i] = i;
+    }
+    map.erase(map.find(5));
+    EXPECT_EQ(map.size(), 9U);
+    EXPECT_FALSE(map.contains(5));
+}
+
+TEST(FlatSet, insert_find_erase){
+    uint128_flat_set set;
+    for(uint64_t i = 0; i < 1000; i++){
+        EXPECT_TRUE(set.insert(i, ~i).second);
+    }
+    EXPECT_FALSE(set.insert(uint128_t(5, ~5ULL)).second);
+    EXPECT_EQ(set.size(), 1000U);
+
+    for(uint64_t i = 0; i < 1000; i += 2){
+        EXPECT_EQ(set.erase(uint128_t(i, ~i)), 1U);
+    }
+    EXPECT_EQ(set.size(), 500U);
+    for(uint64_t i = 0; i < 1000; i++){
+        EXPECT_EQ(set.contains(i, ~i), (bool) (i & 1));
+    }
+    EXPECT_EQ(*set.find(uint128_t(1, ~1ULL)), uint128_t(1, ~1ULL));
+}
+
+TEST(FlatSet, rehash_out_of_memory){
+    uint128_flat_set set;
+    for(uint64_t i = 0; i < 100; i++){
+        set.insert(i, i);
+    }
+    const std::size_t capacity = set.capacity();
+
+    // growing to 2^17 slots allocates 128 KiB of control bytes, then 2 MiB of keys, which fails
+    fail_from = 1 << 20;
+    EXPECT_THROW(set.reserve(100000), std::bad_alloc);
+    fail_from = 0;
+
+    // the old table is untouched
+    EXPECT_EQ(set.capacity(), capacity);
+    EXPECT_EQ(set.size(), 100U);
+    for(uint64_t i = 0; i < 100; i++){
+        EXPECT_TRUE(set.contains(i, i));
+    }
+    EXPECT_FALSE(set.contains(100, 100));
+    set.reserve(100000);
+    EXPECT_EQ(set.size(), 100U);
+    EXPECT_TRUE(set.contains(99, 99));
+}
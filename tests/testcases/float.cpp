@@ -0,0 +1,195 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_float.h"
+
+static const uint128_t MAX(~0ULL, ~0ULL);
+
+// values with every bit width, and runs of ones that round up
+static std::vector <uint128_t> samples(){
+    std::mt19937_64 gen(1);
+    std::vector <uint128_t> out;
+    for(unsigned bits = 0; bits <= 128; bits++){
+        for(unsigned i = 0; i < 20; i++){
+            uint128_t x(gen(), gen());
+            x >>= 128 - bits;
+            if ((i & 1) && bits){
+                x |= (uint128_1 << (bits - 1)) - 1;
+            }
+            out.push_back(x);
+        }
+    }
+    return out;
+}
+
+// |x - r| must be at most the distance to either neighbour of r, and on a tie r must be even
+template <typename T>
+static void expect_nearest(const uint128_t & x, const T r){
+    const uint128_t value = from_long_double(r, UINT128_FLOAT_SATURATE);
+    const uint128_t diff = (value > x)?(value - x):(x - value);
+    for(const T n : {std::nextafter(r, static_cast <T> (0)), std::nextafter(r, std::numeric_limits <T>::infinity())}){
+        if ((n < 1) || (n >= std::ldexp(static_cast <T> (1), 128))){
+            continue;
+        }
+        const uint128_t neighbour = from_long_double(n);
+        const uint128_t d = (neighbour > x)?(neighbour - x):(x - neighbour);
+        EXPECT_FALSE(d < diff) << x;
+        if (d == diff){
+            int e;
+            const T m = std::frexp(r, &e);
+            EXPECT_EQ(std::fmod(std::ldexp(m, std::numeric_limits <T>::digits), static_cast <T> (2)), 0) << x;
+        }
+    }
+}
+
+TEST(Float, exact){
+    EXPECT_EQ(to_double(uint128_0), 0.0);
+    EXPECT_EQ(to_float(uint128_0), 0.0f);
+    EXPECT_EQ(to_long_double(uint128_0), 0.0L);
+    for(unsigned i = 0; i < 128; i++){
+        EXPECT_EQ(to_double(uint128_1 << i), std::ldexp(1.0, i));
+        EXPECT_EQ(to_float(uint128_1 << i), std::ldexp(1.0f, i));
+        EXPECT_EQ(to_long_double(uint128_1 << i), std::ldexp(1.0L, i));
+        EXPECT_EQ(from_double(std::ldexp(1.0, i)), uint128_1 << i);
+    }
+    EXPECT_EQ(to_double(uint128_t(123456789)), 123456789.0);
+    EXPECT_EQ(to_double(uint128_t(0xfffffffffffff800ULL)), 18446744073709549568.0);
+}
+
+TEST(Float, ties){
+    // halfway cases round to the even neighbour, and anything above half rounds up
+    const uint128_t two53 = uint128_1 << 53;
+    EXPECT_EQ(to_double(two53 + 1), 9007199254740992.0);
+    EXPECT_EQ(to_double(two53 + 3), 9007199254740996.0);
+    EXPECT_EQ(to_double(uint128_1 << 100 | uint128_1 << 47), std::ldexp(1.0, 100));
+    EXPECT_EQ(to_double(uint128_1 << 100 | uint128_1 << 47 | 1), std::ldexp(1.0, 100) + std::ldexp(1.0, 48));
+    EXPECT_EQ(to_double(uint128_1 << 100 | uint128_1 << 48 | uint128_1 << 47), std::ldexp(1.0, 100) + std::ldexp(2.0, 48));
+    EXPECT_EQ(to_float(uint128_t((1 << 24) + 1)), 16777216.0f);
+    EXPECT_EQ(to_float(uint128_t((1 << 24) + 3)), 16777220.0f);
+    EXPECT_EQ(to_float(uint128_1 << 70 | 1), std::ldexp(1.0f, 70));
+
+    // rounding up to the next power of 2 carries into the exponent
+    EXPECT_EQ(to_double(uint128_t(~0ULL)), 18446744073709551616.0);
+    EXPECT_EQ(to_double(MAX), std::ldexp(1.0, 128));
+    EXPECT_EQ(to_float(MAX), std::numeric_limits <float>::infinity());
+    EXPECT_EQ(to_float(MAX - (uint128_1 << 103)), std::numeric_limits <float>::max());
+    EXPECT_EQ(to_float(MAX - (uint128_1 << 103) + 1), std::numeric_limits <float>::infinity());
+}
+
+TEST(Float, nearest){
+    for(const uint128_t & x : samples()){
+        expect_nearest(x, to_double(x));
+        expect_nearest(x, to_long_double(x));
+        if (x < MAX - (uint128_1 << 103)){
+            expect_nearest(x, to_float(x));
+        }
+    }
+}
+
+TEST(Float, from_double){
+    EXPECT_EQ(from_double(0.0), uint128_0);
+    EXPECT_EQ(from_double(-0.0), uint128_0);
+    EXPECT_EQ(from_double(0.999), uint128_0);
+    EXPECT_EQ(from_double(-0.999), uint128_0);
+    EXPECT_EQ(from_double(std::numeric_limits <double>::denorm_min()), uint128_0);
+    EXPECT_EQ(from_double(1.5), uint128_1);
+    EXPECT_EQ(from_double(9007199254740993.0), uint128_t(9007199254740992ULL));
+    EXPECT_EQ(from_double(1e30), uint128_t(0xc9f2c9cd0ULL, 0x4675000000000000ULL));
+    EXPECT_EQ(from_double(std::nextafter(std::ldexp(1.0, 128), 0.0)), MAX - ((uint128_1 << 75) - 1));
+
+    EXPECT_THROW(from_double(-1.0), std::overflow_error);
+    EXPECT_THROW(from_double(std::ldexp(1.0, 128)), std::overflow_error);
+    EXPECT_THROW(from_double(std::numeric_limits <double>::infinity()), std::overflow_error);
+    EXPECT_THROW(from_double(-std::numeric_limits <double>::infinity()), std::overflow_error);
+    EXPECT_THROW(from_double(std::numeric_limits <double>::quiet_NaN()), std::domain_error);
+
+    EXPECT_EQ(from_double(-1.0, UINT128_FLOAT_SATURATE), uint128_0);
+    EXPECT_EQ(from_double(std::ldexp(1.0, 128), UINT128_FLOAT_SATURATE), MAX);
+    EXPECT_EQ(from_double(std::numeric_limits <double>::infinity(), UINT128_FLOAT_SATURATE), MAX);
+    EXPECT_EQ(from_double(std::numeric_limits <double>::quiet_NaN(), UINT128_FLOAT_SATURATE), uint128_0);
+
+    EXPECT_EQ(from_long_double(static_cast <long double> (1e30)), uint128_t(0xc9f2c9cd0ULL, 0x4675000000000000ULL));
+    EXPECT_EQ(from_long_double(2.75L), uint128_t(2));
+    EXPECT_EQ(from_long_double(-0.5L), uint128_0);
+    EXPECT_THROW(from_long_double(-1.0L), std::overflow_error);
+    EXPECT_THROW(from_long_double(std::ldexp(1.0L, 128)), std::overflow_error);
+    EXPECT_THROW(from_long_double(std::numeric_limits <long double>::quiet_NaN()), std::domain_error);
+    EXPECT_EQ(from_long_double(std::ldexp(1.0L, 128), UINT128_FLOAT_SATURATE), MAX);
+}
+
+TEST(Float, round_trip){
+    for(const uint128_t & x : samples()){
+        const double d = to_double(x);
+        if (x.bits() <= 53){
+            EXPECT_EQ(from_double(d), x);
+        }
+        EXPECT_EQ(to_double(from_double(d, UINT128_FLOAT_SATURATE)), d);
+        if (x.bits() <= std::numeric_limits <long double>::digits){
+            EXPECT_EQ(from_long_double(to_long_double(x)), x);
+        }
+    }
+}
+
+TEST(Float, batch){
+    const std::vector <uint128_t> in = samples();
+    // every length up to 37, to cover the vector loops and the tails
+    for(std::size_t count = 0; count <= 37; count++){
+        const std::size_t offset = (count * 67) % (in.size() - count);
+        std::vector <double> d(count);
+        std::vector <float> f(count);
+        to_double(in.data() + offset, d.data(), count);
+        to_float(in.data() + offset, f.data(), count);
+        for(std::size_t i = 0; i < count; i++){
+            EXPECT_EQ(d[i], to_double(in[offset + i]));
+            EXPECT_EQ(f[i], to_float(in[offset + i]));
+        }
+    }
+
+    std::vector <double> d(in.size());
+    to_double(in.data(), d.data(), in.size());
+    std::vector <float> f(in.size());
+    to_float(in.data(), f.data(), in.size());
+    for(std::size_t i = 0; i < in.size(); i++){
+        EXPECT_EQ(d[i], to_double(in[i]));
+        EXPECT_EQ(f[i], to_float(in[i]));
+    }
+}
+
+TEST(Float, batch_from_double){
+    std::mt19937_64 gen(2);
+    std::vector <double> in;
+    for(int e = -3; e < 128; e++){
+        in.push_back(std::ldexp(1.0 + std::ldexp(static_cast <double> (gen() >> 12), -52), e));
+        in.push_back(std::ldexp(1.0, e));
+    }
+    for(std::size_t count = 0; count <= 37; count++){
+        const std::size_t offset = (count * 29) % (in.size() - count);
+        std::vector <uint128_t> out(count);
+        from_double(in.data() + offset, out.data(), count);
+        for(std::size_t i = 0; i < count; i++){
+            EXPECT_EQ(out[i], from_double(in[offset + i]));
+        }
+    }
+
+    // out of range values are saturated, and in checked mode every element is written first
+    const std::vector <double> special({-0.0, -0.5, -1.0, 0.5, std::numeric_limits <double>::quiet_NaN(),
+                                        std::ldexp(1.0, 128), std::numeric_limits <double>::infinity(),
+                                        -std::numeric_limits <double>::infinity(), 3.0, std::ldexp(1.0, 127)});
+    std::vector <uint128_t> out(special.size());
+    from_double(special.data(), out.data(), special.size(), UINT128_FLOAT_SATURATE);
+    for(std::size_t i = 0; i < special.size(); i++){
+        EXPECT_EQ(out[i], from_double(special[i], UINT128_FLOAT_SATURATE)) << i;
+    }
+    std::vector <uint128_t> checked(special.size());
+    EXPECT_THROW(from_double(special.data(), checked.data(), special.size()), std::overflow_error);
+    EXPECT_EQ(checked, out);
+
+    const std::vector <double> valid(in.begin(), in.begin() + 9);
+    std::vector <uint128_t> ok(valid.size());
+    EXPECT_NO_THROW(from_double(valid.data(), ok.data(), valid.size()));
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <unordered_map>
+#include <unordered_set>
 #include "uint128_t.h"
 
 using namespace std;
@@ -10,4 +11,39 @@ TEST(Hash, BASE){
     map.insert(make_pair(a, "hello"));
     map.insert(make_pair(1, "bye"));
     ASSERT_EQ(map[a], "hello");
-}
\ No newline at end of file
+}
+
+TEST(Hash, distinct){
+    const std::hash <uint128_t> hash;
+
+    // equal halves, swapped halves and small values used to collide
+    EXPECT_NE(hash(uint128_t(1, 1)), hash(uint128_t(2, 2)));
+    EXPECT_NE(hash(uint128_t(1, 2)), hash(uint128_t(2, 1)));
+    EXPECT_NE(hash(uint128_t(0, 1)), hash(uint128_t(0, 2)));
+    EXPECT_NE(hash(uint128_t(1, 0)), hash(uint128_t(0, 1)));
+
+    unordered_set <size_t> seen;
+    for(uint64_t i = 0; i < 4096; i++){
+        seen.insert(hash(uint128_t(i, i)));
+        seen.insert(hash(uint128_t(i + 1, 0)));
+        seen.insert(hash(uint128_t(0, i + 4096)));
+    }
+    EXPECT_EQ(seen.size(), 3U * 4096U);
+}
+
+TEST(Hash, seed){
+    const uint128_t value(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    EXPECT_EQ(value.hash(), std::hash <uint128_t> ()(value));
+    EXPECT_EQ(value.hash(5), uint128_hash <> (5)(value));
+    EXPECT_NE(value.hash(0), value.hash(1));
+}
+
+TEST(Hash, mixer){
+    unordered_map <uint128_t, int, uint128_hash <uint128_fmix_mixer> > map(16, uint128_hash <uint128_fmix_mixer> (42));
+    for(int i = 0; i < 100; i++){
+        map[uint128_t(i, i)] = i;
+    }
+    ASSERT_EQ(map.size(), 100U);
+    EXPECT_EQ(map[uint128_t(7, 7)], 7);
+    EXPECT_NE(uint128_fmix_mixer()(uint128_t(1, 2), 0), uint128_fmix_mixer()(uint128_t(2, 1), 0));
+}
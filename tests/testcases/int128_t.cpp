@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "int128_t.h"
+
+TEST(Int128, constructor){
+    EXPECT_EQ(int128_t(-1).upper(), ~0ULL);
+    EXPECT_EQ(int128_t(-1).lower(), ~0ULL);
+    EXPECT_EQ(int128_t(5U).upper(), 0ULL);
+    EXPECT_EQ(int128_t(true), int128_1);
+    EXPECT_EQ(int128_t(uint128_t(~0ULL, ~0ULL)), int128_t(-1));
+    EXPECT_EQ(uint128_t(int128_t(-1)), uint128_t(~0ULL, ~0ULL));
+    EXPECT_EQ(static_cast <int64_t> (int128_t(-7)), -7);
+    EXPECT_EQ(static_cast <uint32_t> (int128_t(-1)), 0xffffffffU);
+
+    EXPECT_EQ(int128_t("-170141183460469231731687303715884105728", 10), int128_min);
+    EXPECT_EQ(int128_t("170141183460469231731687303715884105727", 10), int128_max);
+    EXPECT_EQ(int128_t("  -ff", 16), int128_t(-255));
+    EXPECT_EQ(int128_t("+101", 2), int128_t(5));
+    EXPECT_EQ(int128_t("", 10), int128_0);
+}
+
+TEST(Int128, str){
+    EXPECT_EQ(int128_0.str(), "0");
+    EXPECT_EQ(int128_t(-42).str(), "-42");
+    EXPECT_EQ(int128_t(-42).str(16, 4), "-002a");
+    EXPECT_EQ(int128_min.str(), "-170141183460469231731687303715884105728");
+    EXPECT_EQ(int128_max.str(16), "7fffffffffffffffffffffffffffffff");
+
+    std::stringstream s;
+    s << int128_t(-255) << " " << std::hex << int128_t(-255);
+    EXPECT_EQ(s.str(), "-255 -ff");
+}
+
+TEST(Int128, compare){
+    EXPECT_LT(int128_min, int128_t(-1));
+    EXPECT_LT(int128_t(-1), int128_0);
+    EXPECT_LT(int128_0, int128_max);
+    EXPECT_GT(int128_t(1, 0), int128_t(0, ~0ULL));
+    EXPECT_LT(int128_t(-1, 0), int128_t(0, 0));
+    EXPECT_TRUE(int128_t(-3) < -2);
+    EXPECT_TRUE(-4 < int128_t(-3));
+    EXPECT_TRUE(int128_t(-3) == -3);
+    EXPECT_TRUE(int128_t(-3) >= -3);
+    EXPECT_FALSE(int128_t(-3) > 0U);
+}
+
+TEST(Int128, shift){
+    EXPECT_EQ(int128_t(-8) >> 1, int128_t(-4));
+    EXPECT_EQ(int128_t(-1) >> 100, int128_t(-1));
+    EXPECT_EQ(int128_min >> 127, int128_t(-1));
+    EXPECT_EQ(int128_min >> 64, int128_t(~0ULL, 0x8000000000000000ULL));
+    EXPECT_EQ(int128_min >> 200, int128_t(-1));
+    EXPECT_EQ(int128_max >> 200, int128_0);
+    EXPECT_EQ(int128_max >> 126, int128_1);
+    EXPECT_EQ(int128_t(-1) << 127, int128_min);
+    EXPECT_EQ(int128_t(-1) << 128, int128_0);
+}
+
+TEST(Int128, divide){
+    // truncation toward 0
+    EXPECT_EQ(int128_t(7) / -2, int128_t(-3));
+    EXPECT_EQ(int128_t(7) % -2, int128_1);
+    EXPECT_EQ(int128_t(-7) / 2, int128_t(-3));
+    EXPECT_EQ(int128_t(-7) % 2, int128_t(-1));
+    EXPECT_EQ(int128_t(-7) / -2, int128_t(3));
+    EXPECT_EQ(int128_t(-7) % -2, int128_t(-1));
+
+    // floor
+    EXPECT_EQ(int128_t::floor_divmod(7, -2), std::make_pair(int128_t(-4), int128_t(-1)));
+    EXPECT_EQ(int128_t::floor_divmod(-7, 2), std::make_pair(int128_t(-4), int128_t(1)));
+    EXPECT_EQ(int128_t::floor_divmod(-7, -2), std::make_pair(int128_t(3), int128_t(-1)));
+    EXPECT_EQ(int128_t::floor_divmod(-8, 2), std::make_pair(int128_t(-4), int128_0));
+
+    // wraps like the builtin types do in two's complement
+    EXPECT_EQ(int128_min / -1, int128_min);
+    EXPECT_EQ(int128_min % -1, int128_0);
+    EXPECT_EQ(-int128_min, int128_min);
+
+    EXPECT_THROW(int128_t(1) / int128_0, std::domain_error);
+    EXPECT_THROW(int128_t::floor_divmod(1, 0), std::domain_error);
+}
+
+TEST(Int128, mixed){
+    int64_t x = -10;
+    x += int128_t(3);
+    EXPECT_EQ(x, -7);
+    x *= int128_t(-2);
+    EXPECT_EQ(x, 14);
+    EXPECT_EQ(3 - int128_t(5), int128_t(-2));
+    EXPECT_EQ(-9 / int128_t(2), int128_t(-4));
+    EXPECT_EQ(1 << int128_t(100), int128_1 << 100);
+
+    EXPECT_TRUE((std::is_signed <int128_t>::value));
+    EXPECT_FALSE((std::is_integral <int128_t>::value));
+    EXPECT_FALSE((std::is_convertible <int128_t, uint128_t>::value));
+    EXPECT_FALSE((std::is_convertible <uint128_t, int128_t>::value));
+}
+
+TEST(Int128, keys){
+    const int128_t values[] = {int128_min, int128_t(-1, 0), int128_t(-2), int128_t(-1), int128_0, int128_1, int128_t(1, 0), int128_max};
+    uint8_t prev[UINT128_KEY_SIZE];
+    for(std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++){
+        uint8_t key[UINT128_KEY_SIZE];
+        values[i].export_key(key);
+        EXPECT_EQ(int128_t::import_key(key), values[i]);
+        if (i){
+            EXPECT_LT(std::memcmp(prev, key, UINT128_KEY_SIZE), 0);
+        }
+        std::memcpy(prev, key, UINT128_KEY_SIZE);
+    }
+
+    std::unordered_set <int128_t> set({int128_t(-1), int128_1, int128_t(-1)});
+    EXPECT_EQ(set.size(), 2U);
+}
+
+TEST(Int128, varkeys){
+    const int128_t values[] = {int128_min, int128_min + 1, int128_t(-1, 0), int128_t(-1), int128_0, int128_1, int128_max};
+    const std::size_t count = sizeof(values) / sizeof(values[0]);
+
+    // variable width keys order like the values
+    std::vector <uint8_t> prev;
+    for(const int128_t & x : values){
+        uint8_t key[UINT128_VARKEY_MAX_SIZE];
+        const std::size_t len = x.export_varkey(key);
+        int128_t back;
+        EXPECT_EQ(int128_t::import_varkey(key, len, back), len);
+        EXPECT_EQ(back, x);
+        const std::vector <uint8_t> current(key, key + len);
+        EXPECT_LT(prev, current);
+        prev = current;
+    }
+
+    uint8_t fixed[count * UINT128_KEY_SIZE];
+    int128_t out[count];
+    int128_t::export_keys(values, count, fixed);
+    int128_t::import_keys(fixed, count, out);
+    EXPECT_TRUE(std::equal(values, values + count, out));
+
+    uint8_t var[count * UINT128_VARKEY_MAX_SIZE];
+    const std::size_t written = int128_t::export_varkeys(values, count, var);
+    EXPECT_EQ(int128_t::import_varkeys(var, written, out, count), written);
+    EXPECT_TRUE(std::equal(values, values + count, out));
+    EXPECT_THROW(int128_t::import_varkeys(var, written - 1, out, count), std::invalid_argument);
+}
+
+TEST(Int128, export_bits){
+    std::vector <uint8_t> bits;
+    int128_t(-2).export_bits(bits);
+    ASSERT_EQ(bits.size(), 16U);
+    EXPECT_EQ(bits.front(), 0xff);
+    EXPECT_EQ(bits.back(), 0xfe);
+}
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 builtin_int128;
+__extension__ typedef unsigned __int128 builtin_uint128;
+
+static builtin_int128 builtin(const int128_t & x){
+    return static_cast <builtin_int128> ((static_cast <builtin_uint128> (x.upper()) << 64) | x.lower());
+}
+
+TEST(Int128, builtin){
+    std::mt19937_64 gen(1);
+    for(unsigned i = 0; i < 20000; i++){
+        // mostly small magnitudes of either sign, so that divisions do not all give 0
+        const int128_t a(gen(), gen());
+        const int128_t b = int128_t(gen(), gen()) >> (gen() % 128);
+        const builtin_int128 x = builtin(a);
+        const builtin_int128 y = builtin(b);
+        EXPECT_EQ(builtin(a + b), x + y);
+        EXPECT_EQ(builtin(a - b), x - y);
+        EXPECT_EQ(builtin(a * b), static_cast <builtin_int128> (static_cast <builtin_uint128> (x) * static_cast <builtin_uint128> (y)));
+        EXPECT_EQ(a < b, x < y);
+        EXPECT_EQ(a >= b, x >= y);
+        const unsigned s = gen() % 128;
+        EXPECT_EQ(builtin(a >> s), x >> s);
+        if (b && ((a != int128_min) || (b != -1))){
+            EXPECT_EQ(builtin(a / b), x / y);
+            EXPECT_EQ(builtin(a % b), x % y);
+            const std::pair <int128_t, int128_t> qr = int128_t::floor_divmod(a, b);
+            EXPECT_EQ(qr.first * b + qr.second, a);
+            EXPECT_TRUE(!qr.second || (qr.second.negative() == b.negative()));
+            EXPECT_LT(qr.second.magnitude(), b.magnitude());
+        }
+    }
+}
+#endif
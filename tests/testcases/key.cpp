@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t.h"
+
+static const std::vector <uint128_t> values = {
+    uint128_t(0),
+    uint128_t(1),
+    uint128_t(0xffULL),
+    uint128_t(0x100ULL),
+    uint128_t(0x0123456789abcdefULL),
+    uint128_t(0xffffffffffffffffULL),
+    uint128_t(1, 0),
+    uint128_t(0x0123456789abcdefULL, 0xfedcba9876543210ULL),
+    uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL),
+};
+
+TEST(Key, fixed){
+    const uint128_t value(0x0123456789abcdefULL, 0xfedcba9876543210ULL);
+    const uint8_t expected[UINT128_KEY_SIZE] = {
+        0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+        0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10,
+    };
+
+    uint8_t key[UINT128_KEY_SIZE];
+    value.export_key(key);
+    EXPECT_EQ(std::memcmp(key, expected, UINT128_KEY_SIZE), 0);
+    EXPECT_EQ(uint128_t::import_key(key), value);
+
+    // same bytes as export_bits
+    std::vector <uint8_t> bits;
+    value.export_bits(bits);
+    EXPECT_EQ(std::memcmp(key, bits.data(), UINT128_KEY_SIZE), 0);
+}
+
+TEST(Key, variable){
+    uint8_t key[UINT128_VARKEY_MAX_SIZE];
+    uint128_t out;
+
+    EXPECT_EQ(uint128_t(0).export_varkey(key), 1U);
+    EXPECT_EQ(key[0], 0);
+
+    EXPECT_EQ(uint128_t(0x1234).export_varkey(key), 3U);
+    EXPECT_EQ(key[0], 2);
+    EXPECT_EQ(key[1], 0x12);
+    EXPECT_EQ(key[2], 0x34);
+
+    for(uint128_t const & value : values){
+        const std::size_t len = value.export_varkey(key);
+        EXPECT_LE(len, UINT128_VARKEY_MAX_SIZE);
+        EXPECT_EQ(uint128_t::import_varkey(key, len, out), len);
+        EXPECT_EQ(out, value);
+    }
+}
+
+TEST(Key, variable_invalid){
+    uint128_t out;
+    const uint8_t too_long[] = {17};
+    const uint8_t truncated[] = {2, 0x12};
+    const uint8_t leading_zero[] = {2, 0x00, 0x12};
+
+    EXPECT_THROW(uint128_t::import_varkey(nullptr, 0, out), std::invalid_argument);
+    EXPECT_THROW(uint128_t::import_varkey(too_long, sizeof(too_long), out), std::invalid_argument);
+    EXPECT_THROW(uint128_t::import_varkey(truncated, sizeof(truncated), out), std::invalid_argument);
+    EXPECT_THROW(uint128_t::import_varkey(leading_zero, sizeof(leading_zero), out), std::invalid_argument);
+}
+
+TEST(Key, order){
+    for(uint128_t const & lhs : values){
+        for(uint128_t const & rhs : values){
+            uint8_t lkey[UINT128_KEY_SIZE], rkey[UINT128_KEY_SIZE];
+            lhs.export_key(lkey);
+            rhs.export_key(rkey);
+            EXPECT_EQ(std::memcmp(lkey, rkey, UINT128_KEY_SIZE) < 0, lhs < rhs);
+
+            uint8_t lvar[UINT128_VARKEY_MAX_SIZE], rvar[UINT128_VARKEY_MAX_SIZE];
+            const std::size_t llen = lhs.export_varkey(lvar);
+            const std::size_t rlen = rhs.export_varkey(rvar);
+            const int cmp = std::memcmp(lvar, rvar, std::min(llen, rlen));
+            EXPECT_EQ((cmp < 0) || (!cmp && (llen < rlen)), lhs < rhs);
+            EXPECT_EQ(!cmp && (llen == rlen), lhs == rhs);
+        }
+    }
+}
+
+TEST(Key, batch){
+    std::vector <uint8_t> fixed(values.size() * UINT128_KEY_SIZE);
+    uint128_t::export_keys(values.data(), values.size(), fixed.data());
+
+    std::vector <uint128_t> out(values.size());
+    uint128_t::import_keys(fixed.data(), values.size(), out.data());
+    EXPECT_EQ(out, values);
+
+    std::vector <uint8_t> variable(values.size() * UINT128_VARKEY_MAX_SIZE);
+    const std::size_t written = uint128_t::export_varkeys(values.data(), values.size(), variable.data());
+    EXPECT_LT(written, values.size() * UINT128_VARKEY_MAX_SIZE);
+
+    std::fill(out.begin(), out.end(), uint128_0);
+    EXPECT_EQ(uint128_t::import_varkeys(variable.data(), written, out.data(), out.size()), written);
+    EXPECT_EQ(out, values);
+}
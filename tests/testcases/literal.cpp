@@ -0,0 +1,76 @@
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t.h"
+
+// evaluated by the compiler
+static constexpr uint128_t MAX = 340282366920938463463374607431768211455_u128;
+static_assert(MAX.upper() == ~0ULL && MAX.lower() == ~0ULL, "decimal");
+static_assert((0xffff'ffff'ffff'ffff'0000'0000'0000'0001_u128).upper() == ~0ULL, "hex");
+static_assert((0xffff'ffff'ffff'ffff'0000'0000'0000'0001_u128).lower() == 1, "hex");
+static_assert((0b1'0000000000000000000000000000000000000000000000000000000000000000_u128).upper() == 1, "binary");
+static_assert((0777_u128).lower() == 511, "octal");
+static_assert((0_u128).lower() == 0, "zero");
+static_assert((18'446'744'073'709'551'616_u128).upper() == 1, "separators");
+static_assert(uint128_parse("0o17", 4).lower() == 15, "0o prefix");
+static_assert(uint128_parse("ff", 2, 16).lower() == 255, "base");
+
+// values in a table are constants, not initialized at startup
+static constexpr uint128_t TABLE[] = {1_u128, 0x10_u128, 100'000'000'000'000'000'000_u128};
+static_assert(TABLE[2].upper() == 5 && TABLE[2].lower() == 0x6bc75e2d63100000ULL, "table");
+
+static uint128_t parse(const std::string & s, const uint8_t base = 0){
+    return uint128_parse(s.data(), s.size(), base);
+}
+
+TEST(Literal, values){
+    EXPECT_EQ(MAX, uint128_t(~0ULL, ~0ULL));
+    EXPECT_EQ(0x0123456789abcdefFEDCBA9876543210_u128, uint128_t(0x0123456789abcdefULL, 0xfedcba9876543210ULL));
+    EXPECT_EQ(1'000'000_u128, uint128_t(1000000));
+    EXPECT_EQ(0b1010_u128, uint128_t(10));
+    EXPECT_EQ(010_u128, uint128_t(8));
+    EXPECT_EQ(0x1'0000'0000'0000'0000_u128, uint128_t(1, 0));
+    EXPECT_EQ(TABLE[1], uint128_t(16));
+}
+
+TEST(Literal, parse){
+    EXPECT_EQ(parse("340282366920938463463374607431768211455"), MAX);
+    EXPECT_EQ(parse("0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"), MAX);
+    EXPECT_EQ(parse("0O3" + std::string(42, '7')), MAX);
+    EXPECT_EQ(parse("0b" + std::string(128, '1')), MAX);
+    EXPECT_EQ(parse("0010"), uint128_t(10));
+    EXPECT_EQ(parse("0"), uint128_0);
+    EXPECT_EQ(parse("1'2'3"), uint128_t(123));
+}
+
+TEST(Literal, errors){
+    EXPECT_THROW(parse("340282366920938463463374607431768211456"), std::overflow_error);
+    EXPECT_THROW(parse("0x1" + std::string(32, '0')), std::overflow_error);
+    EXPECT_THROW(parse("0b1" + std::string(128, '0')), std::overflow_error);
+    EXPECT_THROW(parse("0o4" + std::string(42, '0')), std::overflow_error);
+    EXPECT_THROW(parse(""), std::invalid_argument);
+    EXPECT_THROW(parse("0x"), std::invalid_argument);
+    EXPECT_THROW(parse("0x'1"), std::invalid_argument);
+    EXPECT_THROW(parse("1'"), std::invalid_argument);
+    EXPECT_THROW(parse("1''2"), std::invalid_argument);
+    EXPECT_THROW(parse("12a"), std::invalid_argument);
+    EXPECT_THROW(parse(" 1"), std::invalid_argument);
+    EXPECT_THROW(parse("19", 8), std::invalid_argument);
+    EXPECT_THROW(parse("1", 17), std::invalid_argument);
+    EXPECT_THROW(parse("1", 1), std::invalid_argument);
+}
+
+TEST(Literal, str){
+    // agrees with str() in every base, near every power of 2
+    std::mt19937_64 gen(1);
+    for(unsigned bits = 0; bits <= 128; bits++){
+        const uint128_t x = uint128_t(gen(), gen()) >> (128 - bits);
+        for(const uint8_t base : {2, 3, 7, 8, 10, 16}){
+            EXPECT_EQ(parse(x.str(base), base), x);
+        }
+        EXPECT_EQ(parse("0x" + x.str(16)), x);
+    }
+}
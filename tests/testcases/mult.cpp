@@ -16,6 +16,31 @@ TEST(Arithmetic, multiply){
     EXPECT_EQ(one * val, val);
 }
 
+TEST(Arithmetic, mul_wide){
+    const uint128_t max = ~uint128_t(0);
+    uint128_t high;
+
+    // (2^128 - 1)^2 = 2^256 - 2^129 + 1
+    EXPECT_EQ(uint128_t::mul_wide(max, max, &high), uint128_t(1));
+    EXPECT_EQ(high, max - 1);
+
+    // (2^128 - 2^64)(2^128 - 1) = (2^128 - 2^64 - 1) 2^128 + 2^64
+    EXPECT_EQ(uint128_t::mul_wide(uint128_t(0xffffffffffffffffULL, 0), max, &high), uint128_t(1, 0));
+    EXPECT_EQ(high, uint128_t(0xfffffffffffffffeULL, 0xffffffffffffffffULL));
+
+    const uint128_t val(0xfedbca9876543210ULL, 0x0123456789abcdefULL);
+    for(unsigned shift = 0; shift < 128; shift += 7){
+        const uint128_t low = uint128_t::mul_wide(val, uint128_t(1) << shift, &high);
+        EXPECT_EQ(low, val << shift);
+        EXPECT_EQ(high, shift?(val >> (128 - shift)):uint128_t(0));
+    }
+
+    // the lower half is the wrapping product
+    EXPECT_EQ(uint128_t::mul_wide(val, val, &high), val * val);
+    EXPECT_EQ(uint128_t::mul_wide(val, 0, &high), uint128_t(0));
+    EXPECT_EQ(high, uint128_t(0));
+}
+
 TEST(External, multiply){
     bool     t   = true;
     bool     f   = false;
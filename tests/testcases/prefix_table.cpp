@@ -0,0 +1,132 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_prefix_table.h"
+
+TEST(PrefixTable, mask){
+    EXPECT_EQ(uint128_prefix_mask(0), uint128_0);
+    EXPECT_EQ(uint128_prefix_mask(1), uint128_t(0x8000000000000000ULL, 0));
+    EXPECT_EQ(uint128_prefix_mask(64), uint128_t(0xffffffffffffffffULL, 0));
+    EXPECT_EQ(uint128_prefix_mask(65), uint128_t(0xffffffffffffffffULL, 0x8000000000000000ULL));
+    EXPECT_EQ(uint128_prefix_mask(128), ~uint128_0);
+}
+
+TEST(PrefixTable, longest_match){
+    uint128_prefix_table <int> table;
+    EXPECT_EQ(table.lookup(uint128_t(0x20010db800000000ULL, 1)), nullptr);
+
+    table.insert(uint128_t(0x2000000000000000ULL, 0), 3, 1);              // 2000::/3
+    table.insert(uint128_t(0x20010db800000000ULL, 0), 32, 2);             // 2001:db8::/32
+    table.insert(uint128_t(0x20010db800010000ULL, 0), 48, 3);             // 2001:db8:1::/48
+    table.insert(uint128_t(0x20010db800010000ULL, 5), 128, 4);            // 2001:db8:1::5/128
+    table.insert(uint128_t(0x20010db800010000ULL, 0xff), 20, 5);          // 2001::/20, host bits are ignored
+    EXPECT_EQ(table.size(), 5U);
+
+    EXPECT_EQ(*table.lookup(uint128_t(0x20010db800010000ULL, 5)), 4);
+    EXPECT_EQ(*table.lookup(uint128_t(0x20010db800010000ULL, 6)), 3);
+    EXPECT_EQ(*table.lookup(uint128_t(0x20010db800020000ULL, 5)), 2);
+    EXPECT_EQ(*table.lookup(uint128_t(0x20010db900000000ULL, 0)), 5);
+    EXPECT_EQ(*table.lookup(uint128_t(0x3fffffffffffffffULL, 0)), 1);
+    EXPECT_EQ(table.lookup(uint128_t(0xfe80000000000000ULL, 1)), nullptr);
+    EXPECT_FALSE(table.contains(uint128_1));
+
+    // replacing a value does not add a prefix
+    table.insert(uint128_t(0x20010db800000000ULL, 0), 32, 6);
+    EXPECT_EQ(table.size(), 5U);
+    EXPECT_EQ(*table.lookup(uint128_t(0x20010db800020000ULL, 5)), 6);
+
+    // the default route matches everything else
+    table.insert(uint128_0, 0, 0);
+    EXPECT_EQ(*table.lookup(uint128_t(0xfe80000000000000ULL, 1)), 0);
+
+    EXPECT_THROW(table.insert(uint128_0, 129, 0), std::invalid_argument);
+
+    table.clear();
+    EXPECT_EQ(table.size(), 0U);
+    EXPECT_EQ(table.lookup(uint128_t(0x20010db800010000ULL, 5)), nullptr);
+}
+
+TEST(PrefixTable, replace_under_longer){
+    // a prefix whose entries were all taken over by longer prefixes is still replaced, not added again
+    const uint128_t p(0x20010db800000000ULL, 0);
+    uint128_prefix_table <int> table;
+    table.insert(p, 17, 1);
+    table.insert(p, 18, 2);
+    table.insert(p, 17, 3);
+    EXPECT_EQ(table.size(), 2U);
+    EXPECT_EQ(*table.lookup(p), 2);
+    EXPECT_EQ(*table.lookup(p | (uint128_1 << 110)), 3);
+
+    table.insert(p | (uint128_1 << 110), 18, 4);
+    table.insert(p, 17, 5);
+    EXPECT_EQ(table.size(), 3U);
+    EXPECT_EQ(*table.lookup(p), 2);
+    EXPECT_EQ(*table.lookup(p | (uint128_1 << 110)), 4);
+
+    // the same for leaves and at the root level
+    table.insert(p, 64, 6);
+    table.insert(p, 64, 7);
+    table.insert(p, 8, 8);
+    table.insert(p, 9, 9);
+    table.insert(p, 8, 10);
+    EXPECT_EQ(table.size(), 6U);
+    EXPECT_EQ(*table.lookup(p), 7);
+    EXPECT_EQ(*table.lookup(uint128_t(0x2080000000000000ULL, 0)), 10);
+}
+
+TEST(PrefixTable, against_linear_scan){
+    std::mt19937_64 gen(3);
+    std::vector <uint128_t> prefixes;
+    std::vector <unsigned> lens;
+    std::vector <std::size_t> vals;
+
+    // few top bits so that prefixes nest
+    for(std::size_t i = 0; i < 2000; i++){
+        const unsigned len = gen() % 129;
+        prefixes.push_back(uint128_t((gen() & 0x0000ffff0000ffffULL) | 0x2001000000000000ULL, gen() & 0xff000000000000ffULL) & uint128_prefix_mask(len));
+        lens.push_back(len);
+        vals.push_back(i);
+    }
+
+    uint128_prefix_table <std::size_t> table;
+    table.insert(prefixes.data(), lens.data(), vals.data(), prefixes.size());
+
+    std::vector <uint128_t> addrs;
+    for(std::size_t i = 0; i < 5000; i++){
+        // half of the addresses start from a prefix so that they match something long
+        uint128_t addr((gen() & 0x0000ffff0000ffffULL) | 0x2001000000000000ULL, gen() & 0xff000000000000ffULL);
+        if (i & 1){
+            const std::size_t p = gen() % prefixes.size();
+            addr = prefixes[p] | (addr & ~uint128_prefix_mask(lens[p]));
+        }
+        addrs.push_back(addr);
+    }
+
+    std::vector <const std::size_t *> out(addrs.size());
+    table.lookup(addrs.data(), addrs.size(), out.data());
+
+    for(std::size_t i = 0; i < addrs.size(); i++){
+        // the longest match; later duplicates replace earlier ones
+        int best = -1;
+        std::size_t value = 0;
+        for(std::size_t p = 0; p < prefixes.size(); p++){
+            if (((addrs[i] & uint128_prefix_mask(lens[p])) == prefixes[p]) && ((int) lens[p] >= best)){
+                best = lens[p];
+                value = vals[p];
+            }
+        }
+
+        const std::size_t * found = table.lookup(addrs[i]);
+        EXPECT_EQ(found, out[i]);
+        if (best < 0){
+            EXPECT_EQ(found, nullptr);
+        }
+        else{
+            ASSERT_NE(found, nullptr);
+            EXPECT_EQ(*found, value);
+        }
+    }
+}
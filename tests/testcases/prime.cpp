@@ -0,0 +1,142 @@
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_prime.h"
+
+static const uint128_t MERSENNE_61((uint128_1 << 61) - 1);
+static const uint128_t MERSENNE_127((uint128_1 << 127) - 1);
+
+static uint128_t product(const std::vector <uint128_t> & factors){
+    uint128_t out = 1;
+    for(const uint128_t & f : factors){
+        out *= f;
+    }
+    return out;
+}
+
+TEST(Prime, small){
+    const std::size_t limit = 100000;
+    std::vector <bool> composite(limit);
+    composite[0] = composite[1] = true;
+    for(std::size_t p = 2; p * p < limit; p++){
+        for(std::size_t m = p * p; m < limit; m += p){
+            composite[m] = true;
+        }
+    }
+    for(std::size_t i = 0; i < limit; i++){
+        EXPECT_EQ(is_prime(uint128_t(i)), !composite[i]) << i;
+    }
+}
+
+TEST(Prime, large){
+    // largest primes below 2^64 and 2^128
+    EXPECT_TRUE(is_prime(uint128_t(0xffffffffffffffc5ULL)));
+    EXPECT_TRUE(is_prime(uint128_t(~0ULL, 0xffffffffffffff61ULL)));
+    EXPECT_FALSE(is_prime(uint128_t(~0ULL)));
+    EXPECT_FALSE(is_prime(uint128_t(~0ULL, ~0ULL)));
+
+    // Mersenne primes in each range
+    EXPECT_TRUE(is_prime(MERSENNE_61));
+    EXPECT_TRUE(is_prime((uint128_1 << 89) - 1));
+    EXPECT_TRUE(is_prime((uint128_1 << 107) - 1));
+    EXPECT_TRUE(is_prime(MERSENNE_127));
+    EXPECT_FALSE(is_prime((uint128_1 << 101) - 1));
+
+    // first primes above powers of 2
+    EXPECT_TRUE(is_prime((uint128_1 << 82) + 9));
+    EXPECT_TRUE(is_prime((uint128_1 << 90) + 0x85));
+    EXPECT_TRUE(is_prime((uint128_1 << 100) + 0x115));
+    EXPECT_TRUE(is_prime((uint128_1 << 120) + 0x1c3));
+}
+
+TEST(Prime, pseudoprimes){
+    // strong pseudoprime to the bases 2 to 23
+    EXPECT_FALSE(is_prime(uint128_t(3825123056546413051ULL)));
+    // strong pseudoprimes to the primes 2 to 37 and 2 to 41, the bounds of the base sets
+    EXPECT_FALSE(is_prime(uint128_t(0x437aULL, 0xe92817f9fc85b7e5ULL)));
+    EXPECT_FALSE(is_prime(uint128_t(0x2be69ULL, 0x51adc5b22410a5fdULL)));
+    // Carmichael number that is a strong pseudoprime to base 2, above both bounds
+    const uint128_t carmichael(0xa208727ULL, 0xdc511a1c7512bc61ULL);
+    EXPECT_FALSE(is_prime(carmichael));
+    // Carmichael numbers
+    for(const uint64_t n : {561ULL, 41041ULL, 825265ULL, 321197185ULL, 5394826801ULL, 232250619601ULL, 9746347772161ULL}){
+        EXPECT_FALSE(is_prime(uint128_t(n))) << n;
+    }
+    // square of a prime
+    EXPECT_FALSE(is_prime(MERSENNE_61 * MERSENNE_61));
+}
+
+TEST(Prime, count){
+    // 210 primes in [2^64, 2^64 + 10000) and 124 in [2^100, 2^100 + 10000)
+    std::size_t count = 0;
+    for(uint64_t i = 0; i < 10000; i++){
+        count += is_prime(uint128_t(1, i));
+    }
+    EXPECT_EQ(count, 210U);
+
+    count = 0;
+    for(uint64_t i = 0; i < 10000; i++){
+        count += is_prime(uint128_t(1ULL << 36, i));
+    }
+    EXPECT_EQ(count, 124U);
+}
+
+TEST(Prime, batch){
+    std::mt19937_64 gen(1);
+    std::vector <uint128_t> in(1000);
+    for(std::size_t i = 0; i < in.size(); i++){
+        // odd values, half of them above 2^64
+        in[i] = uint128_t((i & 1)?(gen() >> 20):0, gen() | 1);
+    }
+    for(const unsigned threads : {1U, 3U, 0U}){
+        std::unique_ptr <bool []> out(new bool[in.size()]);
+        is_prime(in.data(), in.size(), out.get(), threads);
+        for(std::size_t i = 0; i < in.size(); i++){
+            EXPECT_EQ(out[i], is_prime(in[i]));
+        }
+    }
+}
+
+TEST(Prime, factor){
+    EXPECT_THROW(factor(0), std::invalid_argument);
+    EXPECT_EQ(factor(1), std::vector <uint128_t> ());
+    EXPECT_EQ(factor(2), std::vector <uint128_t> ({2}));
+    EXPECT_EQ(factor(1ULL << 40), std::vector <uint128_t> (40, 2));
+    EXPECT_EQ(factor(360), std::vector <uint128_t> ({2, 2, 2, 3, 3, 5}));
+    EXPECT_EQ(factor(MERSENNE_127), std::vector <uint128_t> ({MERSENNE_127}));
+
+    // 2^128 - 1 = 3 * 5 * 17 * 257 * 641 * 65537 * 274177 * 6700417 * 67280421310721
+    EXPECT_EQ(factor(uint128_t(~0ULL, ~0ULL)),
+              std::vector <uint128_t> ({3, 5, 17, 257, 641, 65537, 274177, 6700417, 67280421310721ULL}));
+
+    // three primes near 2^30
+    EXPECT_EQ(factor(uint128_t(0xa208727ULL, 0xdc511a1c7512bc61ULL)),
+              std::vector <uint128_t> ({805361041ULL, 1610722081ULL, 2416083121ULL}));
+
+    // (2^40 + 15) * (2^80 + 13)
+    EXPECT_EQ(factor(uint128_t(0x1000000000f0000ULL, 0xd00000000c3ULL)),
+              std::vector <uint128_t> ({1099511627791ULL, (uint128_1 << 80) + 13}));
+
+    // repeated factors
+    EXPECT_EQ(factor(uint128_t(0x7fffffffULL * 0x7fffffffULL) * 5), std::vector <uint128_t> ({5, 0x7fffffff, 0x7fffffff}));
+    EXPECT_EQ(factor(uint128_t(1021 * 1031) * 1021 * 3), std::vector <uint128_t> ({3, 1021, 1021, 1031}));
+}
+
+TEST(Prime, factor_random){
+    std::mt19937_64 gen(2);
+    for(unsigned i = 0; i < 200; i++){
+        const uint128_t n(0, gen());
+        const std::vector <uint128_t> factors = factor(n);
+        EXPECT_EQ(product(factors), n);
+        for(std::size_t j = 0; j < factors.size(); j++){
+            EXPECT_TRUE(is_prime(factors[j])) << factors[j];
+            if (j){
+                EXPECT_FALSE(factors[j] < factors[j - 1]);
+            }
+        }
+    }
+}
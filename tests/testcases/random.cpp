@@ -0,0 +1,198 @@
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_random.h"
+
+TEST(Random, pcg64_reference){
+    // pcg64 seeded with (42, 54), from the PCG reference code's check output
+    const uint64_t expected[] = {
+        0x86b1da1d72062b68ULL, 0x1304aa46c9853d39ULL, 0xa3670e9e0dd50358ULL,
+        0xf9090e529a7dae00ULL, 0xc85b9fd837996f2cULL, 0x606121f8e3919196ULL,
+    };
+    uint128_pcg64 gen(42, 54);
+    for(const uint64_t e : expected){
+        EXPECT_EQ(gen(), e);
+    }
+}
+
+TEST(Random, dxsm_and_mcg_steps){
+    // the same steps written with uint128_t operators
+    uint128_pcg64_dxsm dxsm(1, 2);
+    uint128_t state = dxsm.state();
+    const uint128_t inc = dxsm.increment();
+    EXPECT_EQ(inc, uint128_t(5));
+    for(int i = 0; i < 100; i++){
+        uint64_t hi = state.upper();
+        hi ^= hi >> 32;
+        hi *= 0xda942042e4dd58b5ULL;
+        hi ^= hi >> 48;
+        hi *= state.lower() | 1;
+        EXPECT_EQ(dxsm(), hi);
+        state = state * uint128_t(0xda942042e4dd58b5ULL) + inc;
+    }
+
+    uint128_mcg128 mcg(7);
+    state = mcg.state();
+    EXPECT_EQ(state, uint128_t(15));
+    EXPECT_EQ(mcg.increment(), uint128_0);
+    for(int i = 0; i < 100; i++){
+        state *= uint128_t(0xda942042e4dd58b5ULL);
+        EXPECT_EQ(mcg(), state.upper());
+    }
+}
+
+template <typename Engine>
+static void check_advance_and_fill(Engine gen){
+    // advance matches stepping
+    Engine stepped = gen;
+    for(int i = 0; i < 1000; i++){
+        stepped();
+    }
+    Engine jumped = gen;
+    jumped.advance(1000);
+    EXPECT_EQ(jumped, stepped);
+    jumped = gen;
+    jumped.discard(1000);
+    EXPECT_EQ(jumped, stepped);
+
+    // and goes back with a negative delta
+    jumped.advance(~uint128_t(1000) + 1);
+    EXPECT_EQ(jumped, gen);
+
+    // fill matches calls, including the tail after the last full round
+    for(const std::size_t n : {0, 1, 3, 4, 5, 64, 103}){
+        Engine called = gen, filled = gen;
+        std::vector <uint64_t> expected(n), out(n);
+        for(uint64_t & x : expected){
+            x = called();
+        }
+        filled.fill(out.data(), n);
+        EXPECT_EQ(out, expected);
+        EXPECT_EQ(filled, called);
+        EXPECT_EQ(filled(), called());
+    }
+}
+
+TEST(Random, advance_and_fill){
+    check_advance_and_fill(uint128_pcg64(3, 4));
+    check_advance_and_fill(uint128_pcg64_dxsm(3, 4));
+    check_advance_and_fill(uint128_mcg128(3));
+}
+
+TEST(Random, streams){
+    uint128_pcg64 a(1, 1), b(1, 2), c(1, 1);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, c);
+    int same = 0;
+    for(int i = 0; i < 1000; i++){
+        same += a() == b();
+    }
+    EXPECT_EQ(same, 0);
+
+    a.seed(9);
+    b.seed(9);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(uint128_pcg64(), uint128_pcg64(0xcafef00dd15ea5e5ULL));
+}
+
+TEST(Random, distributions){
+    // usable as a UniformRandomBitGenerator
+    uint128_pcg64 gen;
+    std::uniform_int_distribution <int> die(1, 6);
+    std::vector <int> counts(7, 0);
+    for(int i = 0; i < 6000; i++){
+        counts[die(gen)]++;
+    }
+    for(int face = 1; face <= 6; face++){
+        EXPECT_GT(counts[face], 800);
+        EXPECT_LT(counts[face], 1200);
+    }
+    EXPECT_EQ(uint128_mcg128::min(), 0U);
+    EXPECT_EQ(uint128_mcg128::max(), ~0ULL);
+}
+
+// returns the given 64-bit values in order
+struct scripted_gen{
+    typedef uint64_t result_type;
+
+    std::vector <uint64_t> values;
+    std::size_t next = 0;
+
+    static constexpr result_type min(){ return 0; }
+    static constexpr result_type max(){ return ~0ULL; }
+
+    result_type operator()(){
+        return values.at(next++);
+    }
+};
+
+TEST(Random, uniform_below){
+    uint128_pcg64 gen(5);
+    const uint128_t bounds[] = {
+        1, 3, 1000, uint128_t(0, 0xffffffffffffffffULL), uint128_t(1, 0), uint128_t(1, 1),
+        uint128_t(0x8000000000000000ULL, 1), ~uint128_0,
+    };
+    for(uint128_t const & bound : bounds){
+        std::vector <uint128_t> out(1000);
+        uniform_uint128(gen, bound, out.data(), out.size());
+        uint128_t largest = 0;
+        for(uint128_t const & x : out){
+            EXPECT_LT(x, bound);
+            largest = (x > largest)?x:largest;
+            EXPECT_LT(uniform_uint128(gen, bound), bound);
+        }
+        // the values spread over the whole range
+        if (bound > 1000){
+            EXPECT_GT(largest, bound - bound / 64);
+        }
+    }
+    EXPECT_THROW(uniform_uint128(gen, uint128_0), std::invalid_argument);
+}
+
+TEST(Random, uniform_range){
+    std::mt19937 gen32(1);      // 32 bits per call
+    const uint128_t lo(5, 0), hi(5, 9);
+    for(int i = 0; i < 1000; i++){
+        const uint128_t x = uniform_uint128(gen32, lo, hi);
+        EXPECT_GE(x, lo);
+        EXPECT_LE(x, hi);
+    }
+    EXPECT_EQ(uniform_uint128(gen32, lo, lo), lo);
+    EXPECT_THROW(uniform_uint128(gen32, hi, lo), std::invalid_argument);
+
+    // the full range is just random bits
+    scripted_gen scripted;
+    scripted.values = {1, 2};
+    EXPECT_EQ(uniform_uint128(scripted, uint128_0, ~uint128_0), uint128_t(1, 2));
+}
+
+TEST(Random, uniform_rejects){
+    // bound 3: 2^64 mod 3 = 1, so x = 0 (low 0) is rejected and x = 2^63 (low 2^63) is not
+    scripted_gen small;
+    small.values = {0, 1ULL << 63};
+    EXPECT_EQ(uniform_uint128(small, 3), uint128_1);
+    EXPECT_EQ(small.next, 2U);
+
+    // bound 2^127 + 1: 2^128 mod bound = 2^127 - 1; x = 2 and x = 2^127 + 5 give low halves 2 and 5
+    scripted_gen large;
+    large.values = {0, 2, 0x8000000000000000ULL, 5, ~0ULL, ~0ULL};
+    EXPECT_EQ(uniform_uint128(large, uint128_t(0x8000000000000000ULL, 1)), uint128_t(0x8000000000000000ULL, 0));
+    EXPECT_EQ(large.next, 6U);
+}
+
+TEST(Random, uniform_unbiased){
+    // x % bound would put half of the values in the first third
+    const uint128_t third(0x4000000000000000ULL, 0);
+    uint128_mcg128 gen(11);
+    unsigned counts[3] = {0, 0, 0};
+    const unsigned draws = 30000;
+    for(unsigned i = 0; i < draws; i++){
+        counts[(uniform_uint128(gen, third * 3) / third).lower()]++;
+    }
+    for(const unsigned count : counts){
+        EXPECT_GT(count, draws / 3 - 600);
+        EXPECT_LT(count, draws / 3 + 600);
+    }
+}
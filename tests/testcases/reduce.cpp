@@ -0,0 +1,147 @@
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_reduce.h"
+
+// reference: 320-bit values as ten 32-bit limbs, least significant first
+struct limbs{
+    uint64_t limb[10] = {0};
+
+    // += a * b, both given as four 32-bit limbs
+    void multiply_add(const uint64_t * a, const uint64_t * b){
+        for(int i = 0; i < 4; i++){
+            for(int j = 0; j < 4; j++){
+                uint64_t carry = a[i] * b[j];
+                for(int k = i + j; carry && (k < 10); k++){
+                    carry += limb[k];
+                    limb[k] = carry & 0xffffffff;
+                    carry >>= 32;
+                }
+            }
+        }
+    }
+
+    void expect(const uint128_wide_sum & sum) const{
+        EXPECT_EQ(sum.low, uint128_t((limb[3] << 32) | limb[2], (limb[1] << 32) | limb[0]));
+        EXPECT_EQ(sum.high, uint128_t((limb[7] << 32) | limb[6], (limb[5] << 32) | limb[4]));
+        EXPECT_EQ(sum.overflow, (limb[8] | limb[9]) != 0);
+    }
+};
+
+static void split(const uint128_t & x, uint64_t * out){
+    out[0] = x.lower() & 0xffffffff;
+    out[1] = x.lower() >> 32;
+    out[2] = x.upper() & 0xffffffff;
+    out[3] = x.upper() >> 32;
+}
+
+static const uint64_t ONE[4] = {1, 0, 0, 0};
+
+static std::vector <uint128_t> values(const std::size_t count, const uint64_t seed, const bool large){
+    std::mt19937_64 gen(seed);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & x : out){
+        x = large?uint128_t(~(gen() & 0xff), gen()):uint128_t(gen() >> 8, gen());
+    }
+    return out;
+}
+
+static std::vector <uint64_t> lowers(const std::vector <uint128_t> & in){
+    std::vector <uint64_t> out;
+    for(uint128_t const & x : in){
+        out.push_back(x.lower());
+    }
+    return out;
+}
+
+TEST(Reduce, empty){
+    const uint128_wide_sum sum = uint128_sum(static_cast <const uint128_t *> (nullptr), 0);
+    EXPECT_EQ(sum.low, uint128_0);
+    EXPECT_EQ(sum.high, uint128_0);
+    EXPECT_FALSE(sum.overflow);
+}
+
+TEST(Reduce, sum){
+    for(const bool large : {false, true}){
+        for(const std::size_t count : {1, 3, 4, 1001}){
+            const std::vector <uint128_t> in = values(count, count, large);
+            const std::vector <uint64_t> in64 = lowers(in);
+            limbs ref, ref64;
+            for(std::size_t i = 0; i < count; i++){
+                uint64_t x[4];
+                split(in[i], x);
+                ref.multiply_add(x, ONE);
+                split(in64[i], x);
+                ref64.multiply_add(x, ONE);
+            }
+            ref.expect(uint128_sum(in.data(), count));
+            ref64.expect(uint128_sum(in64.data(), count));
+        }
+    }
+
+    // the sum carries out of 128 bits
+    const std::vector <uint128_t> max(5, ~uint128_0);
+    const uint128_wide_sum sum = uint128_sum(max.data(), max.size());
+    EXPECT_EQ(sum.high, uint128_t(4));
+    EXPECT_EQ(sum.low, ~uint128_0 - 4);
+    EXPECT_FALSE(sum.overflow);
+}
+
+TEST(Reduce, sum_squares_and_dot){
+    for(const bool large : {false, true}){
+        for(const std::size_t count : {1, 2, 5, 1001}){
+            const std::vector <uint128_t> a = values(count, count, large);
+            const std::vector <uint128_t> b = values(count, count + 1, large);
+            const std::vector <uint64_t> a64 = lowers(a);
+            const std::vector <uint64_t> b64 = lowers(b);
+            limbs squares, dot, squares64, dot64;
+            for(std::size_t i = 0; i < count; i++){
+                uint64_t x[4], y[4];
+                split(a[i], x);
+                split(b[i], y);
+                squares.multiply_add(x, x);
+                dot.multiply_add(x, y);
+                split(a64[i], x);
+                split(b64[i], y);
+                squares64.multiply_add(x, x);
+                dot64.multiply_add(x, y);
+            }
+            squares.expect(uint128_sum_squares(a.data(), count));
+            dot.expect(uint128_dot(a.data(), b.data(), count));
+            squares64.expect(uint128_sum_squares(a64.data(), count));
+            dot64.expect(uint128_dot(a64.data(), b64.data(), count));
+        }
+    }
+
+    // (2^128 - 1)^2 = 2^256 - 2^129 + 1 fits; twice that does not
+    const std::vector <uint128_t> max(2, ~uint128_0);
+    uint128_wide_sum sum = uint128_sum_squares(max.data(), 1);
+    EXPECT_EQ(sum.high, ~uint128_0 - 1);
+    EXPECT_EQ(sum.low, uint128_1);
+    EXPECT_FALSE(sum.overflow);
+
+    sum = uint128_sum_squares(max.data(), 2);
+    EXPECT_TRUE(sum.overflow);
+    EXPECT_EQ(sum.high, ~uint128_0 - 3);
+    EXPECT_EQ(sum.low, uint128_t(2));
+}
+
+TEST(Reduce, threads){
+    const std::size_t count = 5 * uint128_reduce::MIN_PER_THREAD + 3;
+    const std::vector <uint128_t> a = values(count, 1, true);
+    const std::vector <uint128_t> b = values(count, 2, true);
+    for(const unsigned threads : {2U, 3U, 0U}){
+        const uint128_wide_sum one = uint128_dot(a.data(), b.data(), count, 1);
+        const uint128_wide_sum many = uint128_dot(a.data(), b.data(), count, threads);
+        EXPECT_EQ(many.low, one.low);
+        EXPECT_EQ(many.high, one.high);
+        EXPECT_EQ(many.overflow, one.overflow);
+
+        const uint128_wide_sum sum_one = uint128_sum(a.data(), count, 1);
+        const uint128_wide_sum sum_many = uint128_sum(a.data(), count, threads);
+        EXPECT_EQ(sum_many.low, sum_one.low);
+        EXPECT_EQ(sum_many.high, sum_one.high);
+    }
+}
@@ -0,0 +1,145 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_scan.h"
+
+static std::vector <uint128_t> values(const std::size_t count, const uint64_t seed, const unsigned shift){
+    std::mt19937_64 gen(seed);
+    std::vector <uint128_t> out(count);
+    for(uint128_t & x : out){
+        x = uint128_t(gen() >> shift, gen());
+    }
+    return out;
+}
+
+static std::vector <uint8_t> random_heads(const std::size_t count, const uint64_t seed){
+    std::mt19937_64 gen(seed);
+    std::vector <uint8_t> out(count);
+    for(uint8_t & head : out){
+        head = (gen() % 100) == 0;
+    }
+    return out;
+}
+
+// the obvious loops
+static std::vector <uint128_t> reference(const std::vector <uint128_t> & in, const uint8_t * heads, const bool inclusive, const uint128_t & init){
+    std::vector <uint128_t> out(in.size());
+    uint128_t total = init;
+    for(std::size_t i = 0; i < in.size(); i++){
+        if (heads && heads[i]){
+            total = 0;
+        }
+        if (!inclusive){
+            out[i] = total;
+        }
+        total += in[i];
+        if (inclusive){
+            out[i] = total;
+        }
+    }
+    return out;
+}
+
+TEST(Scan, inclusive_exclusive){
+    for(const std::size_t count : {0, 1, 2, 1000}){
+        const std::vector <uint128_t> in = values(count, count, 0);
+        std::vector <uint128_t> out(count);
+
+        uint128_inclusive_scan(in.data(), out.data(), count);
+        EXPECT_EQ(out, reference(in, nullptr, true, 0));
+
+        const uint128_t init(5, 7);
+        uint128_exclusive_scan(in.data(), out.data(), count, init);
+        EXPECT_EQ(out, reference(in, nullptr, false, init));
+
+        // in place
+        std::vector <uint128_t> inout = in;
+        uint128_inclusive_scan(inout.data(), inout.data(), count);
+        EXPECT_EQ(inout, reference(in, nullptr, true, 0));
+    }
+}
+
+TEST(Scan, segmented){
+    const std::size_t count = 1000;
+    const std::vector <uint128_t> in = values(count, 1, 0);
+    std::vector <uint8_t> heads = random_heads(count, 2);
+    heads[0] = 0;
+    std::vector <uint128_t> out(count);
+
+    uint128_segmented_inclusive_scan(in.data(), heads.data(), out.data(), count);
+    EXPECT_EQ(out, reference(in, heads.data(), true, 0));
+
+    uint128_segmented_exclusive_scan(in.data(), heads.data(), out.data(), count);
+    EXPECT_EQ(out, reference(in, heads.data(), false, 0));
+}
+
+TEST(Scan, checked){
+    const uint128_t half = uint128_1 << 127;
+    std::vector <uint128_t> in = {half - 1, 1, 5};
+    std::vector <uint128_t> out(in.size());
+
+    // fits: 2^127 - 1, 2^127, 2^127 + 5
+    EXPECT_NO_THROW(uint128_inclusive_scan(in.data(), out.data(), in.size(), UINT128_SCAN_CHECKED));
+
+    in.push_back(half);
+    out.resize(in.size());
+    EXPECT_THROW(uint128_inclusive_scan(in.data(), out.data(), in.size(), UINT128_SCAN_CHECKED), std::overflow_error);
+    // the wrapped totals are still written
+    EXPECT_EQ(out.back(), uint128_t(5));
+    EXPECT_NO_THROW(uint128_inclusive_scan(in.data(), out.data(), in.size()));
+
+    // the last element counts towards an exclusive scan's total
+    EXPECT_THROW(uint128_exclusive_scan(in.data(), out.data(), in.size(), uint128_0, UINT128_SCAN_CHECKED), std::overflow_error);
+    EXPECT_THROW(uint128_exclusive_scan(in.data(), out.data(), 1, ~uint128_0, UINT128_SCAN_CHECKED), std::overflow_error);
+
+    // a new segment starts before the total overflows
+    const std::vector <uint8_t> heads = {0, 0, 0, 1};
+    EXPECT_NO_THROW(uint128_segmented_inclusive_scan(in.data(), heads.data(), out.data(), in.size(), UINT128_SCAN_CHECKED));
+    EXPECT_EQ(out.back(), half);
+
+    // the carry can come from either half
+    in = {~uint128_0, uint128_1};
+    EXPECT_THROW(uint128_inclusive_scan(in.data(), out.data(), in.size(), UINT128_SCAN_CHECKED), std::overflow_error);
+    in = {uint128_t(~0ULL, 0), uint128_t(1, 0)};
+    EXPECT_THROW(uint128_inclusive_scan(in.data(), out.data(), in.size(), UINT128_SCAN_CHECKED), std::overflow_error);
+}
+
+TEST(Scan, threads){
+    const std::size_t count = 3 * uint128_scan::MIN_PER_THREAD + 11;
+    const std::vector <uint128_t> in = values(count, 3, 2);
+    const std::vector <uint128_t> small_values = values(count, 5, 20);
+    std::vector <uint8_t> heads = random_heads(count, 4);
+    // one chunk without any head
+    std::fill(heads.begin() + uint128_scan::MIN_PER_THREAD, heads.begin() + 2 * uint128_scan::MIN_PER_THREAD, 0);
+    std::vector <uint128_t> out(count);
+
+    for(const unsigned threads : {2U, 3U, 0U}){
+        uint128_inclusive_scan(in.data(), out.data(), count, UINT128_SCAN_WRAP, threads);
+        EXPECT_EQ(out, reference(in, nullptr, true, 0));
+
+        uint128_exclusive_scan(in.data(), out.data(), count, uint128_t(9), UINT128_SCAN_WRAP, threads);
+        EXPECT_EQ(out, reference(in, nullptr, false, uint128_t(9)));
+
+        uint128_segmented_inclusive_scan(in.data(), heads.data(), out.data(), count, UINT128_SCAN_WRAP, threads);
+        EXPECT_EQ(out, reference(in, heads.data(), true, 0));
+
+        uint128_segmented_exclusive_scan(in.data(), heads.data(), out.data(), count, UINT128_SCAN_WRAP, threads);
+        EXPECT_EQ(out, reference(in, heads.data(), false, 0));
+
+        // values below 2^126 overflow the unsegmented total within a few elements, and the chunk without heads
+        EXPECT_THROW(uint128_inclusive_scan(in.data(), out.data(), count, UINT128_SCAN_CHECKED, threads), std::overflow_error);
+        EXPECT_THROW(uint128_segmented_inclusive_scan(in.data(), heads.data(), out.data(), count, UINT128_SCAN_CHECKED, threads), std::overflow_error);
+        // values below 2^108 fit in any segment of fewer than 2^20
+        EXPECT_NO_THROW(uint128_segmented_inclusive_scan(small_values.data(), heads.data(), out.data(), count, UINT128_SCAN_CHECKED, threads));
+        EXPECT_EQ(out, reference(small_values, heads.data(), true, 0));
+    }
+
+    // the only overflow is between chunks: each chunk total fits, their sum does not
+    std::vector <uint128_t> edges(count, uint128_0);
+    edges[0] = ~uint128_0;
+    edges[count - 1] = uint128_1;
+    EXPECT_THROW(uint128_inclusive_scan(edges.data(), out.data(), count, UINT128_SCAN_CHECKED, 3), std::overflow_error);
+}
@@ -0,0 +1,144 @@
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_soa_vector.h"
+
+// values that hit the carry and borrow edges, then random ones; 37 leaves a tail after the vector loops
+static std::vector <uint128_t> values(const uint64_t seed){
+    std::vector <uint128_t> out = {
+        uint128_0,
+        uint128_1,
+        uint128_t(0, 0xffffffffffffffffULL),
+        uint128_t(1, 0),
+        uint128_t(0xffffffffffffffffULL, 0xffffffffffffffffULL),
+        uint128_t(0x8000000000000000ULL, 0x8000000000000000ULL),
+        uint128_t(0x7fffffffffffffffULL, 0),
+    };
+    std::mt19937_64 gen(seed);
+    while (out.size() < 37){
+        out.push_back(uint128_t(gen() >> (gen() & 63), gen()));
+    }
+    return out;
+}
+
+TEST(SoaVector, container){
+    uint128_soa_vector v(3, uint128_t(1, 2));
+    EXPECT_EQ(v.size(), 3U);
+    EXPECT_EQ(v[2], uint128_t(1, 2));
+
+    v.push_back(uint128_t(3, 4));
+    v.set(0, uint128_t(5, 6));
+    EXPECT_EQ(v.to_vector(), std::vector <uint128_t>({uint128_t(5, 6), uint128_t(1, 2), uint128_t(1, 2), uint128_t(3, 4)}));
+    EXPECT_EQ(v.upper_data()[3], 3U);
+    EXPECT_EQ(v.lower_data()[3], 4U);
+    EXPECT_EQ(reinterpret_cast <uintptr_t> (v.upper_data()) % 64, 0U);
+    EXPECT_EQ(reinterpret_cast <uintptr_t> (v.lower_data()) % 64, 0U);
+
+    v.resize(1);
+    EXPECT_EQ(v.size(), 1U);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+
+    const std::vector <uint128_t> in = values(1);
+    EXPECT_EQ(uint128_soa_vector(in).to_vector(), in);
+}
+
+TEST(SoaVector, arithmetic){
+    const std::vector <uint128_t> a = values(2);
+    const std::vector <uint128_t> b = values(3);
+    const uint128_t scalar(0x123456789abcdefULL, 0xfedcba9876543210ULL);
+
+    uint128_soa_vector sum(a), diff(a), sum_scalar(a), diff_scalar(a), product(a);
+    sum += uint128_soa_vector(b);
+    diff -= uint128_soa_vector(b);
+    sum_scalar += scalar;
+    diff_scalar -= scalar;
+    product *= scalar;
+    for(std::size_t i = 0; i < a.size(); i++){
+        EXPECT_EQ(sum[i], a[i] + b[i]);
+        EXPECT_EQ(diff[i], a[i] - b[i]);
+        EXPECT_EQ(sum_scalar[i], a[i] + scalar);
+        EXPECT_EQ(diff_scalar[i], a[i] - scalar);
+        EXPECT_EQ(product[i], a[i] * scalar);
+    }
+}
+
+TEST(SoaVector, bitwise){
+    const std::vector <uint128_t> a = values(4);
+    const std::vector <uint128_t> b = values(5);
+    const uint128_t scalar(0xf0f0f0f0f0f0f0f0ULL, 0x00ff00ff00ff00ffULL);
+
+    uint128_soa_vector and_v(a), or_v(a), xor_v(a), and_s(a), or_s(a), xor_s(a);
+    and_v &= uint128_soa_vector(b);
+    or_v |= uint128_soa_vector(b);
+    xor_v ^= uint128_soa_vector(b);
+    and_s &= scalar;
+    or_s |= scalar;
+    xor_s ^= scalar;
+    for(std::size_t i = 0; i < a.size(); i++){
+        EXPECT_EQ(and_v[i], a[i] & b[i]);
+        EXPECT_EQ(or_v[i], a[i] | b[i]);
+        EXPECT_EQ(xor_v[i], a[i] ^ b[i]);
+        EXPECT_EQ(and_s[i], a[i] & scalar);
+        EXPECT_EQ(or_s[i], a[i] | scalar);
+        EXPECT_EQ(xor_s[i], a[i] ^ scalar);
+    }
+
+    for(const unsigned shift : {0U, 1U, 63U, 64U, 65U, 127U, 128U, 200U}){
+        uint128_soa_vector left(a), right(a);
+        left <<= shift;
+        right >>= shift;
+        for(std::size_t i = 0; i < a.size(); i++){
+            EXPECT_EQ(left[i], (shift < 128)?(a[i] << uint128_t(shift)):uint128_0);
+            EXPECT_EQ(right[i], (shift < 128)?(a[i] >> uint128_t(shift)):uint128_0);
+        }
+    }
+}
+
+TEST(SoaVector, compare){
+    const std::vector <uint128_t> a = values(6);
+    std::vector <uint128_t> b = values(7);
+    // equal values, and values that differ in only one half
+    b[10] = a[10];
+    b[11] = uint128_t(a[11].upper(), a[11].lower() + 1);
+    b[12] = uint128_t(a[12].upper(), a[12].lower() - 1);
+    b[13] = uint128_t(a[13].upper() + 1, a[13].lower());
+    const uint128_t scalar = a[20];
+
+    const uint128_soa_vector va(a), vb(b);
+    std::vector <uint8_t> eq(a.size()), lt(a.size()), gt(a.size()), eq_s(a.size()), lt_s(a.size()), gt_s(a.size());
+    va.equal(vb, eq.data());
+    va.less(vb, lt.data());
+    va.greater(vb, gt.data());
+    va.equal(scalar, eq_s.data());
+    va.less(scalar, lt_s.data());
+    va.greater(scalar, gt_s.data());
+
+    uint128_soa_vector min(a), max(a);
+    min.assign_min(vb);
+    max.assign_max(vb);
+
+    for(std::size_t i = 0; i < a.size(); i++){
+        EXPECT_EQ(eq[i], a[i] == b[i]);
+        EXPECT_EQ(lt[i], a[i] < b[i]);
+        EXPECT_EQ(gt[i], a[i] > b[i]);
+        EXPECT_EQ(eq_s[i], a[i] == scalar);
+        EXPECT_EQ(lt_s[i], a[i] < scalar);
+        EXPECT_EQ(gt_s[i], a[i] > scalar);
+        EXPECT_EQ(min[i], (a[i] < b[i])?a[i]:b[i]);
+        EXPECT_EQ(max[i], (a[i] < b[i])?b[i]:a[i]);
+    }
+}
+
+TEST(SoaVector, size_mismatch){
+    uint128_soa_vector a(3), b(4);
+    std::vector <uint8_t> out(4);
+    EXPECT_THROW(a += b, std::invalid_argument);
+    EXPECT_THROW(a -= b, std::invalid_argument);
+    EXPECT_THROW(a ^= b, std::invalid_argument);
+    EXPECT_THROW(a.assign_min(b), std::invalid_argument);
+    EXPECT_THROW(a.less(b, out.data()), std::invalid_argument);
+}
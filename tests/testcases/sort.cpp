@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_sort.h"
+
+static std::vector <uint128_t> random_keys(const std::size_t n, const uint64_t upper_mask, const uint64_t lower_mask){
+    std::mt19937_64 gen(n);
+    std::vector <uint128_t> keys(n);
+    for(uint128_t & key : keys){
+        key = uint128_t(gen() & upper_mask, gen() & lower_mask);
+    }
+    return keys;
+}
+
+TEST(RadixSort, random){
+    for(std::size_t n : {0, 1, 2, 17, 1000}){
+        std::vector <uint128_t> keys = random_keys(n, ~0ULL, ~0ULL);
+        std::vector <uint128_t> expected = keys;
+        std::sort(expected.begin(), expected.end());
+        radix_sort(keys);
+        EXPECT_EQ(keys, expected);
+    }
+}
+
+TEST(RadixSort, constant_digits){
+    // only a few digits vary; also covers an odd number of passes
+    std::vector <uint128_t> keys = random_keys(5000, 0x0000ff0000000000ULL, 0xff00ff);
+    std::vector <uint128_t> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(keys);
+    EXPECT_EQ(keys, expected);
+
+    // nothing varies
+    std::vector <uint128_t> same(100, uint128_t(7, 7));
+    radix_sort(same);
+    EXPECT_EQ(same, std::vector <uint128_t> (100, uint128_t(7, 7)));
+}
+
+TEST(RadixSort, key_value_stable){
+    std::vector <uint128_t> keys = random_keys(4000, 0x3, 0xf);
+    std::vector <std::size_t> values(keys.size());
+    for(std::size_t i = 0; i < values.size(); i++){
+        values[i] = i;
+    }
+
+    std::vector <std::pair <uint128_t, std::size_t> > expected;
+    for(std::size_t i = 0; i < keys.size(); i++){
+        expected.push_back(std::make_pair(keys[i], i));
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const std::pair <uint128_t, std::size_t> & lhs, const std::pair <uint128_t, std::size_t> & rhs){
+                         return lhs.first < rhs.first;
+                     });
+
+    radix_sort(keys.data(), values.data(), keys.size());
+    for(std::size_t i = 0; i < keys.size(); i++){
+        EXPECT_EQ(keys[i], expected[i].first);
+        EXPECT_EQ(values[i], expected[i].second);
+    }
+}
+
+TEST(RadixSort, threads){
+    std::vector <uint128_t> keys = random_keys(uint128_radix::MIN_PER_THREAD * 3 + 5, 0xffff, ~0ULL);
+    std::vector <uint128_t> values = keys;
+    std::vector <uint128_t> expected = keys;
+    std::sort(expected.begin(), expected.end());
+
+    radix_sort(keys.data(), values.data(), keys.size(), 4);
+    EXPECT_EQ(keys, expected);
+    EXPECT_EQ(values, expected);
+}
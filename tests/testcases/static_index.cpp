@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "uint128_static_index.h"
+
+static std::vector <uint128_t> sorted_keys(const std::size_t n){
+    std::mt19937_64 gen(n);
+    std::vector <uint128_t> keys(n);
+    for(uint128_t & key : keys){
+        // few distinct upper halves and duplicates, so both halves and equal keys matter
+        key = uint128_t(gen() % 4, (gen() % 64) * 2);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+TEST(StaticIndex, empty){
+    const uint128_static_index index;
+    EXPECT_EQ(index.size(), 0U);
+    EXPECT_EQ(index.lower_bound(5), 0U);
+    EXPECT_FALSE(index.contains(0));
+
+    const uint128_t x = 1;
+    std::size_t out = 7;
+    index.lower_bound(&x, 1, &out);
+    EXPECT_EQ(out, 0U);
+}
+
+TEST(StaticIndex, unsorted){
+    EXPECT_THROW(uint128_static_index(std::vector <uint128_t> {2, 1}), std::invalid_argument);
+}
+
+TEST(StaticIndex, against_std){
+    for(std::size_t n : {1, 2, 3, 7, 8, 100, 1000}){
+        const std::vector <uint128_t> keys = sorted_keys(n);
+        const uint128_static_index index(keys);
+        ASSERT_EQ(index.size(), n);
+
+        std::vector <uint128_t> queries;
+        for(uint64_t upper = 0; upper < 5; upper++){
+            for(uint64_t lower = 0; lower < 130; lower++){
+                queries.push_back(uint128_t(upper, lower));
+            }
+        }
+
+        std::vector <std::size_t> batch(queries.size());
+        index.lower_bound(queries.data(), queries.size(), batch.data());
+
+        for(std::size_t i = 0; i < queries.size(); i++){
+            const uint128_t & x = queries[i];
+            const std::size_t lb = std::lower_bound(keys.begin(), keys.end(), x) - keys.begin();
+            const std::size_t ub = std::upper_bound(keys.begin(), keys.end(), x) - keys.begin();
+            EXPECT_EQ(index.lower_bound(x), lb);
+            EXPECT_EQ(batch[i], lb);
+            EXPECT_EQ(index.upper_bound(x), ub);
+            EXPECT_EQ(index.contains(x), lb != ub);
+        }
+    }
+}
+
+TEST(StaticIndex, range){
+    const std::vector <uint128_t> keys = sorted_keys(500);
+    const uint128_static_index index(keys);
+
+    const uint128_t lo(1, 10);
+    const uint128_t hi(2, 100);
+    const std::vector <uint128_t>::const_iterator first = std::lower_bound(keys.begin(), keys.end(), lo);
+    const std::vector <uint128_t>::const_iterator last = std::lower_bound(keys.begin(), keys.end(), hi);
+
+    std::vector <uint128_t> out;
+    index.range(lo, hi, out);
+    EXPECT_EQ(out, std::vector <uint128_t> (first, last));
+    EXPECT_EQ(index.count(lo, hi), out.size());
+    EXPECT_EQ(index.count(hi, lo), 0U);
+
+    out.clear();
+    index.range(0, uint128_t(~0ULL, ~0ULL), out);
+    EXPECT_EQ(out, keys);
+}
+
+TEST(StaticIndex, move){
+    const std::vector <uint128_t> keys = sorted_keys(100);
+    uint128_static_index index(keys);
+
+    uint128_static_index moved(std::move(index));
+    EXPECT_EQ(moved.size(), keys.size());
+    EXPECT_TRUE(moved.contains(keys[50]));
+    // the source is left empty, not pointing into the moved storage
+    EXPECT_EQ(index.size(), 0U);
+    EXPECT_FALSE(index.contains(keys[50]));
+    EXPECT_EQ(index.lower_bound(keys[50]), 0U);
+
+    uint128_static_index assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.lower_bound(keys[50]), std::lower_bound(keys.begin(), keys.end(), keys[50]) - keys.begin());
+    EXPECT_EQ(moved.size(), 0U);
+}
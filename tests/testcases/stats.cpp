@@ -0,0 +1,84 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "uint128_t.h"
+
+// only built into the library with make STATS=1
+#if defined(UINT128_T_STATS)
+
+TEST(Stats, divmod){
+    uint128_stats_reset();
+    const uint128_t big(1, 0);
+    EXPECT_THROW(big / uint128_0, std::domain_error);
+    EXPECT_EQ(big / uint128_1, big);
+    EXPECT_EQ(big / big, uint128_1);
+    EXPECT_EQ(uint128_t(3) / big, uint128_0);
+    EXPECT_EQ(big / uint128_t(4), uint128_t(1ULL << 62));
+    EXPECT_EQ(uint128_t(100) / uint128_t(7), uint128_t(14));
+    EXPECT_EQ(big % uint128_t(7), uint128_t(2));
+    EXPECT_EQ(big % uint128_t(1000), uint128_t(616));
+
+    const uint128_stats s = uint128_stats_snapshot();
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_BY_ZERO], 1U);
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_BY_ONE], 1U);
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_EQUAL], 1U);
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_SMALLER], 1U);
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_POWER_OF_2], 1U);
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_64], 1U);
+    EXPECT_EQ(s.divmod[uint128_stats::DIVMOD_FULL], 2U);
+    EXPECT_EQ(s.divisor_bits[3], 2U);
+    EXPECT_EQ(s.divisor_bits[10], 1U);
+}
+
+TEST(Stats, text){
+    uint128_stats_reset();
+    EXPECT_EQ(uint128_t(255).str(16), "ff");
+    EXPECT_EQ(uint128_t(255).str(10, 8), "00000255");
+    EXPECT_EQ(uint128_0.str(), "0");
+    EXPECT_EQ(uint128_t("ff", 16), uint128_t(255));
+    EXPECT_EQ(uint128_t("12", 10), uint128_t(12));
+    uint128_t("12", 3);     // unsupported base
+    EXPECT_EQ(uint128_t(1, 0).bits(), 65);
+    EXPECT_EQ(uint128_0.bits(), 0);
+
+    const uint128_stats s = uint128_stats_snapshot();
+    EXPECT_EQ(s.str_digits[1], 1U);
+    EXPECT_EQ(s.str_digits[2], 1U);
+    EXPECT_EQ(s.str_digits[3], 1U);
+    EXPECT_EQ(s.parse_base[16], 1U);
+    EXPECT_EQ(s.parse_base[10], 1U);
+    EXPECT_EQ(s.parse_base[0], 1U);
+    EXPECT_EQ(s.bits[65], 1U);
+    EXPECT_EQ(s.bits[0], 1U);
+}
+
+TEST(Stats, threads){
+    uint128_stats_reset();
+    // counts of finished threads are kept
+    std::thread t([]{
+        for(unsigned i = 0; i < 1000; i++){
+            uint128_t(i).bits();
+        }
+    });
+    t.join();
+    uint128_t(1).bits();
+    EXPECT_EQ(uint128_stats_snapshot().bits[1], 2U);
+    EXPECT_EQ(uint128_stats_snapshot().bits[10], 1000U - 512U);
+
+    std::stringstream out;
+    uint128_stats_dump(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"divmod\": {\"by_zero\": 0, "), std::string::npos) << json;
+    EXPECT_NE(json.find("\"bits\": [1, 2, 2, 4, "), std::string::npos) << json;
+
+    uint128_stats_reset();
+    EXPECT_EQ(uint128_stats_snapshot().bits[10], 0U);
+}
+
+#endif
@@ -0,0 +1,130 @@
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "uint128_text.h"
+
+static std::string to_text(const uint128_t & addr){
+    char buf[UINT128_IPV6_MAX_SIZE];
+    return std::string(buf, uint128_format_ipv6(addr, buf));
+}
+
+static uint128_t from_text(const std::string & s){
+    return uint128_parse_ipv6(s.data(), s.size());
+}
+
+static bool valid_ipv6(const std::string & s){
+    uint128_t out;
+    return uint128_try_parse_ipv6(s.data(), s.size(), out);
+}
+
+TEST(IPv6, format_rfc5952){
+    EXPECT_EQ(to_text(uint128_0), "::");
+    EXPECT_EQ(to_text(uint128_1), "::1");
+    EXPECT_EQ(to_text(uint128_t(0x20010db800000000ULL, 1)), "2001:db8::1");
+    // leading zeros dropped, lowercase
+    EXPECT_EQ(to_text(uint128_t(0x20010db800aa00bbULL, 0x00cc0d0e0f000010ULL)), "2001:db8:aa:bb:cc:d0e:f00:10");
+    // a single zero group is not compressed
+    EXPECT_EQ(to_text(uint128_t(0x20010db800000001ULL, 0x0001000100010001ULL)), "2001:db8:0:1:1:1:1:1");
+    // the longest run is compressed, and the first one on a tie
+    EXPECT_EQ(to_text(uint128_t(0x2001000000000001ULL, 0x0000000000000001ULL)), "2001:0:0:1::1");
+    EXPECT_EQ(to_text(uint128_t(0x20010db800000000ULL, 0x0001000000000001ULL)), "2001:db8::1:0:0:1");
+    EXPECT_EQ(to_text(uint128_t(0xfe80000000000000ULL, 0)), "fe80::");
+    EXPECT_EQ(to_text(uint128_t(0x0001000000000000ULL, 0x0000000000000000ULL)), "1::");
+    EXPECT_EQ(to_text(~uint128_0), "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff");
+    // IPv4-mapped
+    EXPECT_EQ(to_text(uint128_t(0, 0x0000ffffc0000280ULL)), "::ffff:192.0.2.128");
+    EXPECT_EQ(to_text(uint128_t(0, 0x0000ffff00000000ULL)), "::ffff:0.0.0.0");
+}
+
+TEST(IPv6, parse){
+    EXPECT_EQ(from_text("::"), uint128_0);
+    EXPECT_EQ(from_text("::1"), uint128_1);
+    EXPECT_EQ(from_text("1::"), uint128_t(0x0001000000000000ULL, 0));
+    EXPECT_EQ(from_text("2001:DB8::1"), uint128_t(0x20010db800000000ULL, 1));
+    EXPECT_EQ(from_text("2001:0db8:0000:0000:0000:0000:0000:0001"), uint128_t(0x20010db800000000ULL, 1));
+    EXPECT_EQ(from_text("1:2:3:4:5:6:7::"), uint128_t(0x0001000200030004ULL, 0x0005000600070000ULL));
+    EXPECT_EQ(from_text("::2:3:4:5:6:7:8"), uint128_t(0x0000000200030004ULL, 0x0005000600070008ULL));
+    EXPECT_EQ(from_text("::ffff:192.0.2.128"), uint128_t(0, 0x0000ffffc0000280ULL));
+    EXPECT_EQ(from_text("64:ff9b::192.0.2.33"), uint128_t(0x0064ff9b00000000ULL, 0x00000000c0000221ULL));
+    EXPECT_EQ(from_text("1:2:3:4:5:6:1.2.3.4"), uint128_t(0x0001000200030004ULL, 0x0005000601020304ULL));
+
+    const char * bad[] = {
+        "", ":", ":::", "1", "1:2:3:4:5:6:7", "1:2:3:4:5:6:7:8:9", "1::2::3", ":1::", "1::2:",
+        "12345::", "g::", "::1%eth0", "1.2.3.4", "::1.2.3", "::1.2.3.4.5", "::256.0.0.1", "::01.2.3.4",
+        "1:2:3:4:5:6:7:1.2.3.4", " ::1", "::1 ", "1:2:3:4:5:6:7:8::",
+    };
+    for(const char * s : bad){
+        EXPECT_FALSE(valid_ipv6(s)) << s;
+    }
+    EXPECT_THROW(from_text(std::string("::g")), std::invalid_argument);
+
+    // failure leaves the output alone
+    uint128_t out(5);
+    EXPECT_FALSE(uint128_try_parse_ipv6("zz", 2, out));
+    EXPECT_EQ(out, uint128_t(5));
+}
+
+TEST(IPv6, round_trip){
+    std::mt19937_64 gen(9);
+    for(int i = 0; i < 20000; i++){
+        // zero out random groups so that every compression case comes up
+        const uint64_t keep = gen();
+        uint64_t upper = gen(), lower = gen();
+        for(int g = 0; g < 4; g++){
+            if (keep & (1ULL << g)){
+                upper &= ~(0xffffULL << (16 * g));
+            }
+            if (keep & (1ULL << (g + 4))){
+                lower &= ~(0xffffULL << (16 * g));
+            }
+        }
+        const uint128_t addr(upper, lower);
+        const std::string text = to_text(addr);
+        EXPECT_LE(text.size(), UINT128_IPV6_MAX_SIZE);
+        EXPECT_EQ(from_text(text), addr) << text;
+    }
+    const uint128_t mapped(0, 0x0000ffffffffffffULL);
+    EXPECT_EQ(from_text(to_text(mapped)), mapped);
+}
+
+TEST(UUID, format_parse){
+    const uint128_t uuid(0x123e4567e89b12d3ULL, 0xa456426614174000ULL);
+    char buf[UINT128_UUID_SIZE];
+    EXPECT_EQ(uint128_format_uuid(uuid, buf), UINT128_UUID_SIZE);
+    EXPECT_EQ(std::string(buf, UINT128_UUID_SIZE), "123e4567-e89b-12d3-a456-426614174000");
+    uint128_format_uuid(uuid, buf, true);
+    EXPECT_EQ(std::string(buf, UINT128_UUID_SIZE), "123E4567-E89B-12D3-A456-426614174000");
+
+    EXPECT_EQ(uint128_parse_uuid("123e4567-e89b-12d3-a456-426614174000", 36), uuid);
+    EXPECT_EQ(uint128_parse_uuid("123E4567-E89B-12D3-A456-426614174000", 36), uuid);
+    EXPECT_EQ(uint128_parse_uuid("ffffffff-ffff-ffff-ffff-ffffffffffff", 36), ~uint128_0);
+
+    const char * bad[] = {
+        "123e4567-e89b-12d3-a456-42661417400",
+        "123e4567-e89b-12d3-a456-4266141740000",
+        "123e4567e89b-12d3-a456-4266141740000",
+        "123e4567-e89b-12d3-a456-42661417400g",
+        "123e4567-e89b-12d3-a456-42661417400:",
+        "123e4567-e89b-12d3-a456-42661417400/",
+        "123e4567-e89b-12d3-a456-42661417400@",
+        "123e4567-e89b-12d3-a456-42661417400G",
+        "123e4567-e89b-12d3-a456-42661417400\xc0",
+        "{23e4567-e89b-12d3-a456-426614174000",
+    };
+    for(const char * s : bad){
+        uint128_t out;
+        EXPECT_FALSE(uint128_try_parse_uuid(s, std::strlen(s), out)) << s;
+    }
+    EXPECT_THROW(uint128_parse_uuid("", 0), std::invalid_argument);
+
+    std::mt19937_64 gen(10);
+    for(int i = 0; i < 10000; i++){
+        const uint128_t x(gen(), gen());
+        uint128_format_uuid(x, buf, i & 1);
+        EXPECT_EQ(uint128_parse_uuid(buf, UINT128_UUID_SIZE), x);
+    }
+}
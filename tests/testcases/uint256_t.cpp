@@ -0,0 +1,231 @@
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+
+#include "uint256_t.h"
+
+static const uint256_t MAX(uint128_t(~0ULL, ~0ULL), uint128_t(~0ULL, ~0ULL));
+
+static uint256_t words(const uint64_t w3, const uint64_t w2, const uint64_t w1, const uint64_t w0){
+    return uint256_t(uint128_t(w3, w2), uint128_t(w1, w0));
+}
+
+static const uint256_t A = words(0x0123456789abcdefULL, 0xfedcba9876543210ULL, 0x0f1e2d3c4b5a6978ULL, 0x8796a5b4c3d2e1f0ULL);
+static const uint256_t B = words(0, 0, 0xfedcba9876543210ULL, 0xfedcba9876543210ULL);
+
+// operands with words of all sizes, including runs of zeros and ones
+static uint256_t random(std::mt19937_64 & gen){
+    uint64_t w[4];
+    for(uint64_t & x : w){
+        switch (gen() % 4){
+            case 0: x = 0; break;
+            case 1: x = ~0ULL; break;
+            default: x = gen(); break;
+        }
+    }
+    return words(w[3], w[2], w[1], w[0]) >> (gen() % 256);
+}
+
+TEST(Uint256, constructor){
+    EXPECT_EQ(uint256_t(5).lower(), uint128_t(5));
+    EXPECT_EQ(uint256_t(5).upper(), uint128_0);
+    EXPECT_EQ(uint256_t(-1), MAX);
+    EXPECT_EQ(uint256_t(true), uint256_1);
+    EXPECT_EQ(uint256_t(uint128_t(1, 2)).upper(), uint128_0);
+    EXPECT_EQ(uint256_t(uint128_t(1, 2)).lower(), uint128_t(1, 2));
+
+    EXPECT_EQ(uint256_t("0123456789abcdeffedcba98765432100f1e2d3c4b5a69788796a5b4c3d2e1f0", 16), A);
+    EXPECT_EQ(uint256_t("514631507721405312519378913364952599457899916736173488040697764812573303280", 10), A);
+    EXPECT_EQ(uint256_t("  FF", 16), uint256_t(255));
+    EXPECT_EQ(uint256_t("1012", 2), uint256_t(5));
+    EXPECT_EQ(uint256_t("", 10), uint256_0);
+    EXPECT_THROW(uint256_t("1", 17), std::invalid_argument);
+
+    EXPECT_EQ(static_cast <uint64_t> (A), 0x8796a5b4c3d2e1f0ULL);
+    EXPECT_EQ(static_cast <uint8_t> (A), 0xf0);
+    EXPECT_TRUE(static_cast <bool> (uint256_1 << 255));
+    EXPECT_FALSE(static_cast <bool> (uint256_0));
+}
+
+TEST(Uint256, str){
+    EXPECT_EQ(uint256_0.str(), "0");
+    EXPECT_EQ(uint256_0.str(16, 4), "0000");
+    EXPECT_EQ(A.str(16), "123456789abcdeffedcba98765432100f1e2d3c4b5a69788796a5b4c3d2e1f0");
+    EXPECT_EQ(A.str(10), "514631507721405312519378913364952599457899916736173488040697764812573303280");
+    EXPECT_EQ(A.str(8), "44321263611527467577755627246073124144100170742647422655151361036265133230364560760");
+    EXPECT_EQ(MAX.str(), "115792089237316195423570985008687907853269984665640564039457584007913129639935");
+    EXPECT_EQ(MAX.str(2), std::string(256, '1'));
+    EXPECT_EQ((uint256_1 << 64).str(16), "10000000000000000");
+    EXPECT_EQ(uint256_t(1000000).str(10, 10), "0001000000");
+    EXPECT_THROW(A.str(1), std::invalid_argument);
+
+    std::stringstream s;
+    s << uint256_t(255) << " " << std::hex << uint256_t(255) << " " << std::oct << uint256_t(8);
+    EXPECT_EQ(s.str(), "255 ff 10");
+
+    std::mt19937_64 gen(1);
+    for(unsigned i = 0; i < 1000; i++){
+        const uint256_t x = random(gen);
+        for(const uint8_t base : {2, 3, 7, 10, 16}){
+            EXPECT_EQ(uint256_t(x.str(base), base), x);
+        }
+    }
+}
+
+TEST(Uint256, shift){
+    EXPECT_EQ(uint256_1 << 255, words(0x8000000000000000ULL, 0, 0, 0));
+    EXPECT_EQ(uint256_1 << 256, uint256_0);
+    EXPECT_EQ(MAX >> 255, uint256_1);
+    EXPECT_EQ(MAX >> 256, uint256_0);
+    EXPECT_EQ(A << 64, words(0xfedcba9876543210ULL, 0x0f1e2d3c4b5a6978ULL, 0x8796a5b4c3d2e1f0ULL, 0));
+    EXPECT_EQ(A >> 128, uint256_t(A.upper()));
+    EXPECT_EQ(A >> 4, words(0x00123456789abcdeULL, 0xffedcba987654321ULL, 0x00f1e2d3c4b5a697ULL, 0x88796a5b4c3d2e1fULL));
+    EXPECT_EQ(A << 0, A);
+    EXPECT_EQ(A << uint256_t(uint128_1, uint128_0), uint256_0);
+
+    for(unsigned s = 0; s < 256; s++){
+        EXPECT_EQ((MAX << s) >> s, MAX >> s << s >> s);
+        EXPECT_EQ((uint256_1 << s).bits(), s + 1);
+        EXPECT_EQ((uint256_1 << s) >> s, uint256_1);
+    }
+}
+
+TEST(Uint256, arithmetic){
+    EXPECT_EQ(MAX + 1, uint256_0);
+    EXPECT_EQ(uint256_0 - 1, MAX);
+    EXPECT_EQ(uint256_t(~0ULL) + 1, uint256_1 << 64);
+    EXPECT_EQ((uint256_1 << 192) - 1, words(0, ~0ULL, ~0ULL, ~0ULL));
+    EXPECT_EQ(-uint256_1, MAX);
+    EXPECT_EQ(~A + A, MAX);
+
+    uint256_t x = MAX;
+    EXPECT_EQ(++x, uint256_0);
+    EXPECT_EQ(x--, uint256_0);
+    EXPECT_EQ(x, MAX);
+
+    EXPECT_EQ(A * B, words(0x0deaffd4f2e22b57ULL, 0x0fa29765846b926fULL, 0x80a2d61a6fd64dd5ULL, 0x5ef9a562300eff00ULL));
+    uint256_t high;
+    EXPECT_EQ(uint256_t::mul_wide(A, B, &high), A * B);
+    EXPECT_EQ(high, words(0, 0, 0x0121fa00ad77d743ULL, 0x211393285bb5bf00ULL));
+    EXPECT_EQ(uint256_t::mul_wide(MAX, MAX, &high), uint256_1);
+    EXPECT_EQ(high, MAX - 1);
+    EXPECT_EQ(MAX * MAX, uint256_1);
+}
+
+TEST(Uint256, divide){
+    EXPECT_EQ(A / B, words(0, 0, 0x0124924924924924ULL, 0x7da1f58d0fac687dULL));
+    EXPECT_EQ(A % B, words(0, 0, 0x9a185936d07f1389ULL, 0x104a46e0359ff020ULL));
+    const uint256_t C = (uint256_1 << 200) + 12345;
+    EXPECT_EQ(A / C, uint256_t(0x000123456789abcdULL));
+    EXPECT_EQ(A % C, words(0xefULL, 0xfedcba9876543210ULL, 0x0f1e2d3c4b5a6978ULL, 0x50b8c7d6e5f5314bULL));
+    EXPECT_EQ(A / 12345678901234567ULL, uint256_t("41685152500600205862487677288765284116577892384696824503754", 10));
+    EXPECT_EQ(A % 12345678901234567ULL, uint256_t(1031684847238762ULL));
+    EXPECT_EQ(MAX / MAX, uint256_1);
+    EXPECT_EQ(B / A, uint256_0);
+    EXPECT_EQ(B % A, B);
+
+    EXPECT_THROW(A / uint256_0, std::domain_error);
+    EXPECT_THROW(A % uint256_0, std::domain_error);
+
+    // q * b + r == a and r < b determine the quotient and remainder
+    std::mt19937_64 gen(2);
+    for(unsigned i = 0; i < 20000; i++){
+        const uint256_t a = random(gen);
+        const uint256_t b = random(gen);
+        if (!b){
+            continue;
+        }
+        const std::pair <uint256_t, uint256_t> qr = uint256_t::divmod(a, b);
+        uint256_t high;
+        EXPECT_EQ(uint256_t::mul_wide(qr.first, b, &high) + qr.second, a) << a << " " << b;
+        EXPECT_EQ(high, uint256_0);
+        EXPECT_LT(qr.second, b);
+    }
+}
+
+TEST(Uint256, uint128_t){
+    // agrees with uint128_t on values that fit, including the high half of products
+    std::mt19937_64 gen(3);
+    for(unsigned i = 0; i < 20000; i++){
+        const uint128_t a = uint128_t(gen(), gen()) >> (gen() % 128);
+        const uint128_t b = uint128_t(gen(), gen()) >> (gen() % 128);
+        uint128_t high;
+        const uint128_t low = uint128_t::mul_wide(a, b, &high);
+        EXPECT_EQ(uint256_t(a) * uint256_t(b), uint256_t(high, low));
+        EXPECT_EQ(uint256_t(a) + uint256_t(b), uint256_t(uint128_t(a + b < a), a + b));
+        if (b){
+            EXPECT_EQ(uint256_t(a) / uint256_t(b), uint256_t(a / b));
+            EXPECT_EQ(uint256_t(a) % b, uint256_t(a % b));
+        }
+        EXPECT_EQ(uint256_t(a).bits(), a.bits());
+        EXPECT_EQ(uint256_t(a) < uint256_t(b), a < b);
+    }
+}
+
+// written once for either width
+template <typename T>
+static T power(T base, unsigned e){
+    T out = 1;
+    while (e){
+        if (e & 1){
+            out *= base;
+        }
+        base *= base;
+        e >>= 1;
+    }
+    return out;
+}
+
+template <typename T>
+static T isqrt(const T & n){
+    T x = n;
+    T y = (x >> 1) + (x & 1);
+    while (y < x){
+        x = y;
+        y = (x + n / x) / 2;
+    }
+    return x;
+}
+
+TEST(Uint256, generic){
+    EXPECT_EQ(power <uint128_t> (3, 80), uint128_t("147808829414345923316083210206383297601", 10));
+    EXPECT_EQ(power <uint256_t> (3, 80), uint256_t("147808829414345923316083210206383297601", 10));
+    EXPECT_EQ(power <uint256_t> (3, 161), uint256_t("65542350158517637872691969508970705427701150314738255642438471845988797065603", 10));
+    EXPECT_EQ(isqrt <uint128_t> (uint128_t(~0ULL, ~0ULL)), uint128_t(~0ULL));
+    EXPECT_EQ(isqrt <uint256_t> (MAX), uint256_t(uint128_t(~0ULL, ~0ULL)));
+    EXPECT_EQ(isqrt <uint256_t> (uint256_1 << 200), uint256_1 << 100);
+}
+
+TEST(Uint256, mixed){
+    EXPECT_EQ(uint256_t(7) + uint128_t(1, 0), uint256_t(uint128_t(1, 7)));
+    EXPECT_EQ(uint128_t(1, 0) + uint256_t(7), uint256_t(uint128_t(1, 7)));
+    EXPECT_EQ(5 * uint256_t(3), uint256_t(15));
+    EXPECT_EQ(1 << uint256_t(3), 8);
+    EXPECT_TRUE(3 < uint256_t(4));
+    EXPECT_TRUE(uint256_t(4) == 4U);
+
+    uint64_t x = 10;
+    x -= uint256_t(3);
+    EXPECT_EQ(x, 7U);
+    x *= MAX;
+    EXPECT_EQ(x, static_cast <uint64_t> (-7));
+
+    EXPECT_TRUE((std::is_unsigned <uint256_t>::value));
+    EXPECT_TRUE((std::is_arithmetic <uint256_t>::value));
+    EXPECT_FALSE((std::is_integral <uint256_t>::value));
+}
+
+TEST(Uint256, hash){
+    std::unordered_set <uint256_t> set({A, B, A, MAX});
+    EXPECT_EQ(set.size(), 3U);
+    EXPECT_NE(A.hash(), B.hash());
+
+    std::vector <uint8_t> bits;
+    uint256_t(uint128_1, uint128_t(2)).export_bits(bits);
+    ASSERT_EQ(bits.size(), 32U);
+    EXPECT_EQ(bits[15], 1);
+    EXPECT_EQ(bits[31], 2);
+}
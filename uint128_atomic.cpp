@@ -0,0 +1,19 @@
+#include "uint128_t.build"
+#include "uint128_atomic.h"
+
+#include <cstddef>
+
+// one mutex per cache line, so that unrelated values do not contend on the same line
+struct alignas(64) uint128_atomic_stripe{
+    std::mutex lock;
+};
+
+static const std::size_t STRIPES = 64;
+
+std::mutex & uint128_atomic_lock(const void * addr){
+    static uint128_atomic_stripe stripes[STRIPES];
+    const uintptr_t a = reinterpret_cast <uintptr_t> (addr) >> 4;
+    return stripes[(a ^ (a >> 6) ^ (a >> 12)) % STRIPES].lock;
+}
+
+const bool atomic_uint128::is_always_lock_free;
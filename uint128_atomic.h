@@ -0,0 +1,257 @@
+/*
+uint128_atomic.h
+Lock-free atomic uint128_t
+
+Every operation is a 16 byte compare and swap on the aligned value:
+    x86-64:  lock cmpxchg16b (_InterlockedCompareExchange128 on MSVC)
+    AArch64: caspal with LSE atomics (ARMv8.1+), otherwise an ldaxp/stlxp loop
+Other targets, or any target with UINT128_ATOMIC_USE_LOCKS defined, guard the value
+with one of a fixed table of mutexes picked by its address, which is not lock-free.
+
+fetch_* operations retry the compare and swap until it succeeds, so they are lock-free but
+not wait-free. A load is also a compare and swap (of the value with itself), so it needs
+write access to the cache line and should not be used on memory that is read-only.
+
+All operations are sequentially consistent.
+*/
+
+#ifndef __UINT128_ATOMIC__
+#define __UINT128_ATOMIC__
+
+#include <cstdint>
+#include <mutex>
+
+#include "uint128_t.h"
+
+#if defined(UINT128_ATOMIC_USE_LOCKS)
+  #define _UINT128_ATOMIC_LOCKS
+#elif defined(__GNUC__) && defined(__x86_64__)
+  #define _UINT128_ATOMIC_CMPXCHG16B
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+  #include <intrin.h>
+  #define _UINT128_ATOMIC_MSVC
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__AARCH64EL__)
+  #if defined(__ARM_FEATURE_ATOMICS)
+    #define _UINT128_ATOMIC_CASP
+  #else
+    #define _UINT128_ATOMIC_LLSC
+  #endif
+#else
+  #define _UINT128_ATOMIC_LOCKS
+#endif
+
+// the mutex guarding the value at addr when there is no 16 byte compare and swap
+UINT128_T_EXTERN std::mutex & uint128_atomic_lock(const void * addr);
+
+class atomic_uint128{
+    public:
+#if defined(_UINT128_ATOMIC_LOCKS)
+        static const bool is_always_lock_free = false;
+#else
+        static const bool is_always_lock_free = true;
+#endif
+
+        atomic_uint128()
+            : word{0, 0}
+        {}
+
+        atomic_uint128(const uint128_t & value){
+            split(value, word);
+        }
+
+        atomic_uint128(const atomic_uint128 & rhs) = delete;
+        atomic_uint128 & operator=(const atomic_uint128 & rhs) = delete;
+
+        bool is_lock_free() const{
+            return is_always_lock_free;
+        }
+
+        uint128_t load() const{
+            uint64_t current[2] = {0, 0};
+            const uint64_t same[2] = {0, 0};
+            cas(current, same);
+            return join(current);
+        }
+
+        void store(const uint128_t & value){
+            exchange(value);
+        }
+
+        uint128_t exchange(const uint128_t & value){
+            return update([&value](const uint128_t &){ return value; });
+        }
+
+        // on failure, expected is set to the current value
+        bool compare_exchange_strong(uint128_t & expected, const uint128_t & desired){
+            uint64_t e[2];
+            uint64_t d[2];
+            split(expected, e);
+            split(desired, d);
+            const bool ok = cas(e, d);
+            expected = join(e);
+            return ok;
+        }
+
+        // the compare and swap never fails spuriously
+        bool compare_exchange_weak(uint128_t & expected, const uint128_t & desired){
+            return compare_exchange_strong(expected, desired);
+        }
+
+        // return the old value
+        uint128_t fetch_add(const uint128_t & rhs){
+            return update([&rhs](const uint128_t & old){ return old + rhs; });
+        }
+
+        uint128_t fetch_sub(const uint128_t & rhs){
+            return update([&rhs](const uint128_t & old){ return old - rhs; });
+        }
+
+        uint128_t fetch_and(const uint128_t & rhs){
+            return update([&rhs](const uint128_t & old){ return old & rhs; });
+        }
+
+        uint128_t fetch_or(const uint128_t & rhs){
+            return update([&rhs](const uint128_t & old){ return old | rhs; });
+        }
+
+        uint128_t fetch_xor(const uint128_t & rhs){
+            return update([&rhs](const uint128_t & old){ return old ^ rhs; });
+        }
+
+        operator uint128_t() const{
+            return load();
+        }
+
+        uint128_t operator=(const uint128_t & value){
+            store(value);
+            return value;
+        }
+
+        // return the new value
+        uint128_t operator+=(const uint128_t & rhs){
+            return fetch_add(rhs) + rhs;
+        }
+
+        uint128_t operator-=(const uint128_t & rhs){
+            return fetch_sub(rhs) - rhs;
+        }
+
+        uint128_t operator&=(const uint128_t & rhs){
+            return fetch_and(rhs) & rhs;
+        }
+
+        uint128_t operator|=(const uint128_t & rhs){
+            return fetch_or(rhs) | rhs;
+        }
+
+        uint128_t operator^=(const uint128_t & rhs){
+            return fetch_xor(rhs) ^ rhs;
+        }
+
+    private:
+        // the words in memory order, as the compare and swap instructions see them
+#ifdef __BIG_ENDIAN__
+        static const unsigned HI = 0, LO = 1;
+#endif
+#ifdef __LITTLE_ENDIAN__
+        static const unsigned LO = 0, HI = 1;
+#endif
+
+        alignas(16) mutable uint64_t word[2];
+
+        static void split(const uint128_t & value, uint64_t * out){
+            out[LO] = value.lower();
+            out[HI] = value.upper();
+        }
+
+        static uint128_t join(const uint64_t * in){
+            return uint128_t(in[HI], in[LO]);
+        }
+
+        // if the value equals expected, replace it with desired and return true;
+        // otherwise copy the value into expected and return false
+        bool cas(uint64_t * expected, const uint64_t * desired) const{
+#if defined(_UINT128_ATOMIC_CMPXCHG16B)
+            bool ok;
+            __asm__ __volatile__(
+                "lock cmpxchg16b %1\n\t"
+                "sete %0"
+                : "=q" (ok), "+m" (word), "+a" (expected[0]), "+d" (expected[1])
+                : "b" (desired[0]), "c" (desired[1])
+                : "cc", "memory");
+            return ok;
+#elif defined(_UINT128_ATOMIC_MSVC)
+            return _InterlockedCompareExchange128(reinterpret_cast <volatile long long *> (word),
+                                                  static_cast <long long> (desired[1]), static_cast <long long> (desired[0]),
+                                                  reinterpret_cast <long long *> (expected)) != 0;
+#elif defined(_UINT128_ATOMIC_CASP)
+            // GCC and Clang compile this to caspal when LSE atomics are enabled
+            __extension__ typedef unsigned __int128 pair;
+            const pair e = (static_cast <pair> (expected[1]) << 64) | expected[0];
+            const pair d = (static_cast <pair> (desired[1]) << 64) | desired[0];
+            const pair seen = __sync_val_compare_and_swap(reinterpret_cast <pair *> (word), e, d);
+            expected[0] = static_cast <uint64_t> (seen);
+            expected[1] = static_cast <uint64_t> (seen >> 64);
+            return seen == e;
+#elif defined(_UINT128_ATOMIC_LLSC)
+            // a pair load is only atomic if the store exclusive after it succeeds,
+            // so a failed compare still writes back the value it read
+            uint64_t w0, w1;
+            uint32_t failed;
+            bool ok;
+            do{
+                __asm__ __volatile__("ldaxp %0, %1, %2" : "=&r" (w0), "=&r" (w1) : "Q" (word) : "memory");
+                ok = (w0 == expected[0]) && (w1 == expected[1]);
+                __asm__ __volatile__("stlxp %w0, %2, %3, %1"
+                                     : "=&r" (failed), "=Q" (word)
+                                     : "r" (ok?desired[0]:w0), "r" (ok?desired[1]:w1)
+                                     : "memory");
+            } while (failed);
+            expected[0] = w0;
+            expected[1] = w1;
+            return ok;
+#else
+            std::lock_guard <std::mutex> guard(uint128_atomic_lock(word));
+            if ((word[0] == expected[0]) && (word[1] == expected[1])){
+                word[0] = desired[0];
+                word[1] = desired[1];
+                return true;
+            }
+            expected[0] = word[0];
+            expected[1] = word[1];
+            return false;
+#endif
+        }
+
+        // replace the value with f(value) and return the old value
+        template <typename F>
+        uint128_t update(F f){
+#if defined(_UINT128_ATOMIC_LOCKS)
+            std::lock_guard <std::mutex> guard(uint128_atomic_lock(word));
+            const uint128_t old = join(word);
+            split(f(old), word);
+            return old;
+#else
+            // a torn first guess only costs a retry
+            uint64_t expected[2] = {peek(0), peek(1)};
+            uint64_t desired[2];
+            for(;;){
+                const uint128_t old = join(expected);
+                split(f(old), desired);
+                if (cas(expected, desired)){
+                    return old;
+                }
+            }
+#endif
+        }
+
+        uint64_t peek(const unsigned i) const{
+#if defined(__GNUC__)
+            return __atomic_load_n(&word[i], __ATOMIC_RELAXED);
+#else
+            return static_cast <const volatile uint64_t *> (word)[i];
+#endif
+        }
+};
+
+#endif
@@ -0,0 +1,196 @@
+/*
+uint128_counter.h
+Sharded 128-bit counter for values that many threads add to
+
+Each shard is an atomic_uint128 on its own pair of cache lines (adjacent line prefetching
+pulls lines in twos), and a thread always adds to the shard picked by its thread ordinal,
+so threads do not write to each other's lines. Ordinals of threads that have exited are
+handed out again, so with at least as many shards as live threads no two threads share a
+shard and an add() only retries its compare and swap when a reset() gets in between.
+add() is lock-free, not wait-free. read() sums all shards.
+
+reserve(n) hands out blocks of sequence numbers from a separate cursor: each call gets n
+consecutive values that no other call gets, and blocks from later calls start higher.
+Reserving large blocks and numbering from them locally keeps that shared line cold.
+*/
+
+#ifndef __UINT128_COUNTER__
+#define __UINT128_COUNTER__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "uint128_atomic.h"
+#include "uint128_t.h"
+
+// A small number unique among the live threads: the smallest one no running thread holds.
+// A thread keeps its ordinal until it exits, then the next new thread gets it.
+class uint128_thread_ordinals{
+    public:
+        static unsigned get(){
+            thread_local const holder ordinal;
+            return ordinal.value;
+        }
+
+    private:
+        struct pool{
+            std::mutex lock;
+            unsigned next;
+            std::priority_queue <unsigned, std::vector <unsigned>, std::greater <unsigned> > released;
+
+            pool()
+                : next(0)
+            {}
+        };
+
+        // constructed before the first holder, so destroyed after the last one
+        static pool & shared(){
+            static pool p;
+            return p;
+        }
+
+        struct holder{
+            unsigned value;
+
+            holder(){
+                pool & p = shared();
+                std::lock_guard <std::mutex> guard(p.lock);
+                if (p.released.empty()){
+                    value = p.next++;
+                }
+                else{
+                    value = p.released.top();
+                    p.released.pop();
+                }
+            }
+
+            ~holder(){
+                pool & p = shared();
+                std::lock_guard <std::mutex> guard(p.lock);
+                p.released.push(value);
+            }
+        };
+};
+
+inline unsigned uint128_thread_ordinal(){
+    return uint128_thread_ordinals::get();
+}
+
+class sharded_counter128{
+    public:
+        // shards is rounded up to a power of 2; 0 means one per hardware thread
+        explicit sharded_counter128(std::size_t shards = 0)
+            : mask(0), slots(nullptr)
+        {
+            if (!shards){
+                shards = std::thread::hardware_concurrency();
+            }
+            std::size_t count = 1;
+            while (count < shards){
+                count <<= 1;
+            }
+            mask = count - 1;
+
+            // the last slot is the reserve() cursor
+            storage.resize((count + 2) * sizeof(slot));
+            const uintptr_t addr = reinterpret_cast <uintptr_t> (storage.data());
+            slots = reinterpret_cast <slot *> (storage.data() + ((sizeof(slot) - (addr % sizeof(slot))) % sizeof(slot)));
+            for(std::size_t i = 0; i <= count; i++){
+                new (slots + i) slot();
+            }
+        }
+
+        // moving the vector keeps its buffer, so slots stay valid; rhs is left with no shards
+        // and may only be destroyed or assigned to
+        sharded_counter128(sharded_counter128 && rhs)
+            : mask(rhs.mask), storage(std::move(rhs.storage)), slots(rhs.slots)
+        {
+            rhs.mask = 0;
+            rhs.slots = nullptr;
+        }
+
+        sharded_counter128 & operator=(sharded_counter128 && rhs){
+            if (this != &rhs){
+                mask = rhs.mask;
+                storage = std::move(rhs.storage);
+                slots = rhs.slots;
+                rhs.mask = 0;
+                rhs.slots = nullptr;
+            }
+            return *this;
+        }
+
+        // the slots point into storage
+        sharded_counter128(const sharded_counter128 & rhs) = delete;
+        sharded_counter128 & operator=(const sharded_counter128 & rhs) = delete;
+
+        std::size_t shards() const{
+            return mask + 1;
+        }
+
+        void add(const uint128_t & x){
+            slots[uint128_thread_ordinal() & mask].value.fetch_add(x);
+        }
+
+        sharded_counter128 & operator+=(const uint128_t & x){
+            add(x);
+            return *this;
+        }
+
+        sharded_counter128 & operator++(){
+            add(uint128_1);
+            return *this;
+        }
+
+        // At least the sum of every add() that finished before the call. Adds that run
+        // at the same time may or may not be counted.
+        uint128_t read() const{
+            uint128_t sum = 0;
+            for(std::size_t i = 0; i <= mask; i++){
+                sum += slots[i].value.load();
+            }
+            return sum;
+        }
+
+        operator uint128_t() const{
+            return read();
+        }
+
+        // Sets the counter to 0 and returns what it held. Adds that run at the same time land
+        // either in the returned value or in the new count, never in both or neither.
+        uint128_t reset(){
+            uint128_t sum = 0;
+            for(std::size_t i = 0; i <= mask; i++){
+                sum += slots[i].value.exchange(uint128_0);
+            }
+            return sum;
+        }
+
+        // first value of a block of n sequence numbers [first, first + n)
+        uint128_t reserve(const uint128_t & n){
+            return slots[mask + 1].value.fetch_add(n);
+        }
+
+        // the first sequence number that has not been handed out yet
+        uint128_t reserved() const{
+            return slots[mask + 1].value.load();
+        }
+
+    private:
+        struct alignas(128) slot{
+            atomic_uint128 value;
+        };
+
+        std::size_t mask;
+        std::vector <char> storage;
+        slot * slots;
+};
+
+#endif
@@ -0,0 +1,630 @@
+/*
+uint128_decimal.h
+Fixed-point decimals stored as uint128_t values scaled by 10^Scale
+
+fixed_decimal <Scale>           raw / 10^Scale for a raw uint128_t, Scale <= 38
+signed_fixed_decimal <Scale>    the same with a sign, stored as sign and magnitude
+
+Any DECIMAL(38, Scale) value fits, and so does any raw value up to 2^128 - 1. Addition and
+subtraction are exact. Multiplication takes the full 256-bit product of the raw values and
+divides it by 10^Scale, and division multiplies the dividend by 10^Scale before dividing;
+both round the result to nearest, ties to even. rescale <To>() changes the scale, rounding
+the same way when digits are dropped. Results that do not fit in 128 bits (or, for
+fixed_decimal, that are negative) throw std::overflow_error, and dividing by zero throws
+std::domain_error.
+
+Nothing here calls uint128_t::divmod. Division by 10^p uses a reciprocal of 10^p computed at
+compile time (Moller and Granlund, "Improved division by invariant integers", 2011): the
+quotient is the high half of the 256-bit product of the reciprocal and the dividend, plus
+at most two corrections. Only division by another decimal, whose divisor is not known in
+advance, falls back to a shift and subtract loop, and to the hardware divide when both
+operands fit in 64 bits.
+
+format() writes the text into a caller supplied buffer of FIXED_DECIMAL_MAX_SIZE characters
+and returns its length, always with exactly Scale digits after the point. parse() reads
+exactly len characters: an optional sign for signed_fixed_decimal, digits and an optional
+point with more digits, with at least one digit in total. Fraction digits past Scale must be
+zeros, since anything else would have to be rounded. Neither allocates; try_parse() returns
+false instead of throwing std::invalid_argument.
+*/
+
+#ifndef __UINT128_DECIMAL__
+#define __UINT128_DECIMAL__
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "uint128_t.h"
+
+// longest text: "-0." followed by 38 digits, or a sign, 39 digits and the point
+static constexpr std::size_t FIXED_DECIMAL_MAX_SIZE = 41;
+
+class uint128_decimal{
+    public:
+        // 128-bit value as halves, usable in constant expressions
+        struct word{
+            uint64_t hi;
+            uint64_t lo;
+        };
+
+        struct division{
+            word quotient;
+            word remainder;
+        };
+
+        static word from(const uint128_t & x){
+            return word{x.upper(), x.lower()};
+        }
+
+        static uint128_t to(const word x){
+            return uint128_t(x.hi, x.lo);
+        }
+
+        static constexpr bool zero(const word x){
+            return !(x.hi | x.lo);
+        }
+
+        static constexpr bool equal(const word a, const word b){
+            return (a.hi == b.hi) && (a.lo == b.lo);
+        }
+
+        static constexpr bool less(const word a, const word b){
+            return (a.hi < b.hi) || ((a.hi == b.hi) && (a.lo < b.lo));
+        }
+
+        // modulo 2^128
+        static constexpr word add(const word a, const word b){
+            return word{a.hi + b.hi + ((a.lo + b.lo) < a.lo), a.lo + b.lo};
+        }
+
+        static constexpr word subtract(const word a, const word b){
+            return word{a.hi - b.hi - (a.lo < b.lo), a.lo - b.lo};
+        }
+
+        // shift < 128
+        static constexpr word shift_left(const word x, const unsigned shift){
+            return (shift >= 64)?word{x.lo << (shift - 64), 0}:
+                   shift?word{(x.hi << shift) | (x.lo >> (64 - shift)), x.lo << shift}:x;
+        }
+
+        static constexpr word shift_right(const word x, const unsigned shift){
+            return (shift >= 64)?word{0, x.hi >> (shift - 64)}:
+                   shift?word{x.hi >> shift, (x.lo >> shift) | (x.hi << (64 - shift))}:x;
+        }
+
+        static constexpr unsigned leading_zeros(const word x){
+            unsigned out = 0;
+            while ((out < 128) && !((out < 64)?((x.hi >> (63 - out)) & 1):((x.lo >> (127 - out)) & 1))){
+                out++;
+            }
+            return out;
+        }
+
+        // x * 10 modulo 2^128
+        static constexpr word times_10(const word x){
+            return word{x.hi * 10 + (((x.lo >> 32) * 10 + (((x.lo & 0xffffffffULL) * 10) >> 32)) >> 32), x.lo * 10};
+        }
+
+        // 10^p for p <= 38
+        static constexpr word power(const unsigned p){
+            word out{0, 1};
+            for(unsigned i = 0; i < p; i++){
+                out = times_10(out);
+            }
+            return out;
+        }
+
+        // (u1 * 2^128 + u0) / d for u1 < d, one quotient bit at a time
+        static constexpr division long_divide(word u1, const word u0, const word d){
+            word q{0, 0};
+            for(unsigned i = 128; i;){
+                i--;
+                const bool top = u1.hi >> 63;
+                u1 = word{(u1.hi << 1) | (u1.lo >> 63), (u1.lo << 1) | (((i < 64)?(u0.lo >> i):(u0.hi >> (i - 64))) & 1)};
+                q = shift_left(q, 1);
+                if (top || !less(u1, d)){
+                    u1 = subtract(u1, d);
+                    q.lo |= 1;
+                }
+            }
+            return division{q, u1};
+        }
+
+        // low 128 bits of a * b
+        static word multiply_low(const word a, const word b){
+            uint64_t high;
+            const uint64_t low = uint128_t::multlong64(a.lo, b.lo, &high);
+            return word{high + a.lo * b.hi + a.hi * b.lo, low};
+        }
+
+        // (u1 * 2^128 + u0) / 10^P for u1 < 10^P
+        template <unsigned P>
+        static division divide(const word u1, const word u0){
+            // 10^P shifted up to its top bit, and floor((2^256 - 1) / d) - 2^128
+            constexpr unsigned shift = leading_zeros(power(P));
+            constexpr word d = shift_left(power(P), shift);
+            constexpr word v = long_divide(word{~d.hi, ~d.lo}, word{~0ULL, ~0ULL}, d).quotient;
+
+            // the compiler turns a 64-bit division by a constant into a multiply as well
+            constexpr uint64_t d64 = power(P).lo;
+            if ((P < 20) && zero(u1) && !u0.hi){
+                return division{word{0, u0.lo / d64}, word{0, u0.lo % d64}};
+            }
+
+            const word n1 = shift?add(shift_left(u1, shift), shift_right(u0, 128 - shift)):u1;
+            const word n0 = shift_left(u0, shift);
+
+            // (q1, q0) = v * n1 + (n1 + 1) * 2^128 + n0
+            uint128_t high;
+            const word low = from(uint128_t::mul_wide(to(v), to(n1), &high));
+            const word q0 = add(low, n0);
+            word q1 = add(add(from(high), n1), word{0, 1 + static_cast <uint64_t> (less(q0, low))});
+
+            word r = subtract(n0, multiply_low(q1, d));
+            if (less(q0, r)){
+                q1 = subtract(q1, word{0, 1});
+                r = add(r, d);
+            }
+            if (!less(r, d)){
+                q1 = add(q1, word{0, 1});
+                r = subtract(r, d);
+            }
+            return division{q1, shift_right(r, shift)};
+        }
+
+        // quotient rounded to nearest, ties to even
+        static word round(const division & qr, const word d){
+            const word half = subtract(d, qr.remainder);
+            if (less(half, qr.remainder) || (equal(half, qr.remainder) && (qr.quotient.lo & 1))){
+                if (!~(qr.quotient.hi & qr.quotient.lo)){
+                    overflow();
+                }
+                return add(qr.quotient, word{0, 1});
+            }
+            return qr.quotient;
+        }
+
+        // (hi * 2^128 + lo) / 10^P, rounded
+        template <unsigned P>
+        static word divide_rounded(const word hi, const word lo){
+            constexpr word d = power(P);
+            if (!P){
+                if (!zero(hi)){
+                    overflow();
+                }
+                return lo;
+            }
+            if (!less(hi, d)){
+                overflow();
+            }
+            return round(divide <P> (hi, lo), d);
+        }
+
+        // (hi * 2^128 + lo) / d, rounded
+        static word divide_rounded(const word hi, const word lo, const word d){
+            if (zero(d)){
+                throw std::domain_error("Error: division or modulus by 0");
+            }
+            if (!less(hi, d)){
+                overflow();
+            }
+            if (zero(hi) && !lo.hi && !d.hi){
+                return round(division{word{0, lo.lo / d.lo}, word{0, lo.lo % d.lo}}, d);
+            }
+            return round(long_divide(hi, lo, d), d);
+        }
+
+        // a * b / 10^P, rounded
+        template <unsigned P>
+        static word multiply(const word a, const word b){
+            uint128_t high;
+            const word low = from(uint128_t::mul_wide(to(a), to(b), &high));
+            return divide_rounded <P> (from(high), low);
+        }
+
+        // a * 10^P / b, rounded
+        template <unsigned P>
+        static word divide_scaled(const word a, const word b){
+            constexpr word d = power(P);
+            uint128_t high;
+            const word low = from(uint128_t::mul_wide(to(a), to(d), &high));
+            return divide_rounded(from(high), low, b);
+        }
+
+        static word add_checked(const word a, const word b){
+            const word out = add(a, b);
+            if (less(out, a)){
+                overflow();
+            }
+            return out;
+        }
+
+        static word subtract_checked(const word a, const word b){
+            if (less(a, b)){
+                overflow();
+            }
+            return subtract(a, b);
+        }
+
+        // x * 10^P
+        template <unsigned P>
+        static word scale_up(const word x){
+            constexpr word d = power(P);
+            uint128_t high;
+            const word out = from(uint128_t::mul_wide(to(x), to(d), &high));
+            if (high.upper() | high.lower()){
+                overflow();
+            }
+            return out;
+        }
+
+        // the 39 decimal digits of x, with leading zeros
+        static void digits(const word x, char * out){
+            // x = (top * 10^19 + middle) * 10^19 + bottom, with top < 35
+            const division low = divide <19> (word{0, 0}, x);
+            const division high = divide <19> (word{0, 0}, low.quotient);
+            write_digits(high.quotient.lo, out, 1);
+            write_digits(high.remainder.lo, out + 1, 19);
+            write_digits(low.remainder.lo, out + 20, 19);
+        }
+
+        // the text of raw / 10^Scale
+        template <unsigned Scale>
+        static std::size_t format(const word raw, const bool negative, char * out){
+            char buffer[39];
+            digits(raw, buffer);
+            // at least one digit before the point
+            std::size_t first = 0;
+            while ((first + Scale + 1 < 39) && (buffer[first] == '0')){
+                first++;
+            }
+            std::size_t len = 0;
+            if (negative){
+                out[len++] = '-';
+            }
+            for(std::size_t i = first; i < 39 - Scale; i++){
+                out[len++] = buffer[i];
+            }
+            if (Scale){
+                out[len++] = '.';
+                for(std::size_t i = 39 - Scale; i < 39; i++){
+                    out[len++] = buffer[i];
+                }
+            }
+            return len;
+        }
+
+        // the raw value of the digits and point in s[0, len)
+        template <unsigned Scale>
+        static bool parse(const char * s, const std::size_t len, word & out){
+            word value{0, 0};
+            std::size_t count = 0, fraction = 0;
+            bool point = false;
+            for(std::size_t i = 0; i < len; i++){
+                if ((s[i] == '.') && !point){
+                    point = true;
+                    continue;
+                }
+                const unsigned digit = static_cast <unsigned char> (s[i]) - '0';
+                if (digit > 9){
+                    return false;
+                }
+                count++;
+                if (point && (++fraction > Scale)){
+                    // only zeros past the scale
+                    if (digit){
+                        return false;
+                    }
+                    continue;
+                }
+                if (!times_10_checked(value) || !add_small(value, digit)){
+                    return false;
+                }
+            }
+            if (!count){
+                return false;
+            }
+            for(; fraction < Scale; fraction++){
+                if (!times_10_checked(value)){
+                    return false;
+                }
+            }
+            out = value;
+            return true;
+        }
+
+        static void overflow(){
+            throw std::overflow_error("Error: fixed_decimal result does not fit");
+        }
+
+    private:
+        static void write_digits(uint64_t x, char * out, const unsigned count){
+            for(unsigned i = count; i;){
+                out[--i] = static_cast <char> ('0' + x % 10);
+                x /= 10;
+            }
+        }
+
+        static bool times_10_checked(word & x){
+            uint64_t carry;
+            const uint64_t lo = uint128_t::multlong64(x.lo, 10, &carry);
+            uint64_t high;
+            const uint64_t hi = uint128_t::multlong64(x.hi, 10, &high) + carry;
+            if (high || (hi < carry)){
+                return false;
+            }
+            x = word{hi, lo};
+            return true;
+        }
+
+        static bool add_small(word & x, const uint64_t digit){
+            const word out = add(x, word{0, digit});
+            if (less(out, x)){
+                return false;
+            }
+            x = out;
+            return true;
+        }
+};
+
+template <unsigned Scale>
+class fixed_decimal{
+    static_assert(Scale <= 38, "fixed_decimal scale is at most 38");
+
+    public:
+        fixed_decimal()
+            : value{0, 0}
+        {}
+
+        // raw / 10^Scale
+        static fixed_decimal from_raw(const uint128_t & raw){
+            return fixed_decimal(uint128_decimal::from(raw));
+        }
+
+        // integer * 10^Scale, which can overflow
+        static fixed_decimal from_integer(const uint128_t & integer){
+            return fixed_decimal(uint128_decimal::scale_up <Scale> (uint128_decimal::from(integer)));
+        }
+
+        uint128_t raw() const{
+            return uint128_decimal::to(value);
+        }
+
+        // integer part, rounded toward zero
+        uint128_t integer() const{
+            return uint128_decimal::to(uint128_decimal::divide <Scale> (uint128_decimal::word{0, 0}, value).quotient);
+        }
+
+        template <unsigned To>
+        fixed_decimal <To> rescale() const{
+            return fixed_decimal <To>::from_raw(uint128_decimal::to(
+                (To >= Scale)?uint128_decimal::scale_up <(To >= Scale)?(To - Scale):0> (value)
+                             :uint128_decimal::divide_rounded <(To >= Scale)?0:(Scale - To)> (uint128_decimal::word{0, 0}, value)));
+        }
+
+        fixed_decimal operator+(const fixed_decimal & rhs) const{
+            return fixed_decimal(uint128_decimal::add_checked(value, rhs.value));
+        }
+
+        fixed_decimal operator-(const fixed_decimal & rhs) const{
+            return fixed_decimal(uint128_decimal::subtract_checked(value, rhs.value));
+        }
+
+        fixed_decimal operator*(const fixed_decimal & rhs) const{
+            return fixed_decimal(uint128_decimal::multiply <Scale> (value, rhs.value));
+        }
+
+        fixed_decimal operator/(const fixed_decimal & rhs) const{
+            return fixed_decimal(uint128_decimal::divide_scaled <Scale> (value, rhs.value));
+        }
+
+        fixed_decimal & operator+=(const fixed_decimal & rhs){
+            return *this = *this + rhs;
+        }
+
+        fixed_decimal & operator-=(const fixed_decimal & rhs){
+            return *this = *this - rhs;
+        }
+
+        fixed_decimal & operator*=(const fixed_decimal & rhs){
+            return *this = *this * rhs;
+        }
+
+        fixed_decimal & operator/=(const fixed_decimal & rhs){
+            return *this = *this / rhs;
+        }
+
+        bool operator==(const fixed_decimal & rhs) const{
+            return uint128_decimal::equal(value, rhs.value);
+        }
+
+        bool operator!=(const fixed_decimal & rhs) const{
+            return !(*this == rhs);
+        }
+
+        bool operator<(const fixed_decimal & rhs) const{
+            return uint128_decimal::less(value, rhs.value);
+        }
+
+        bool operator>(const fixed_decimal & rhs) const{
+            return rhs < *this;
+        }
+
+        bool operator<=(const fixed_decimal & rhs) const{
+            return !(rhs < *this);
+        }
+
+        bool operator>=(const fixed_decimal & rhs) const{
+            return !(*this < rhs);
+        }
+
+        // out must hold FIXED_DECIMAL_MAX_SIZE characters
+        std::size_t format(char * out) const{
+            return uint128_decimal::format <Scale> (value, false, out);
+        }
+
+        std::string str() const{
+            char out[FIXED_DECIMAL_MAX_SIZE];
+            return std::string(out, format(out));
+        }
+
+        static bool try_parse(const char * s, const std::size_t len, fixed_decimal & out){
+            uint128_decimal::word raw;
+            if (!uint128_decimal::parse <Scale> (s, len, raw)){
+                return false;
+            }
+            out = fixed_decimal(raw);
+            return true;
+        }
+
+        static fixed_decimal parse(const char * s, const std::size_t len){
+            fixed_decimal out;
+            if (!try_parse(s, len, out)){
+                throw std::invalid_argument("Error: not a fixed_decimal");
+            }
+            return out;
+        }
+
+    private:
+        uint128_decimal::word value;
+
+        explicit fixed_decimal(const uint128_decimal::word raw)
+            : value(raw)
+        {}
+};
+
+template <unsigned Scale>
+class signed_fixed_decimal{
+    public:
+        signed_fixed_decimal()
+            : magnitude_(), negative_(false)
+        {}
+
+        // implicit, like a widening integer conversion
+        signed_fixed_decimal(const fixed_decimal <Scale> & magnitude, const bool negative = false)
+            : magnitude_(magnitude), negative_(negative && (magnitude != fixed_decimal <Scale> ()))
+        {}
+
+        const fixed_decimal <Scale> & magnitude() const{
+            return magnitude_;
+        }
+
+        bool negative() const{
+            return negative_;
+        }
+
+        template <unsigned To>
+        signed_fixed_decimal <To> rescale() const{
+            return signed_fixed_decimal <To> (magnitude_.template rescale <To> (), negative_);
+        }
+
+        signed_fixed_decimal operator-() const{
+            return signed_fixed_decimal(magnitude_, !negative_);
+        }
+
+        signed_fixed_decimal operator+(const signed_fixed_decimal & rhs) const{
+            if (negative_ == rhs.negative_){
+                return signed_fixed_decimal(magnitude_ + rhs.magnitude_, negative_);
+            }
+            // the sign of the larger magnitude
+            if (magnitude_ < rhs.magnitude_){
+                return signed_fixed_decimal(rhs.magnitude_ - magnitude_, rhs.negative_);
+            }
+            return signed_fixed_decimal(magnitude_ - rhs.magnitude_, negative_);
+        }
+
+        signed_fixed_decimal operator-(const signed_fixed_decimal & rhs) const{
+            return *this + -rhs;
+        }
+
+        signed_fixed_decimal operator*(const signed_fixed_decimal & rhs) const{
+            return signed_fixed_decimal(magnitude_ * rhs.magnitude_, negative_ != rhs.negative_);
+        }
+
+        signed_fixed_decimal operator/(const signed_fixed_decimal & rhs) const{
+            return signed_fixed_decimal(magnitude_ / rhs.magnitude_, negative_ != rhs.negative_);
+        }
+
+        signed_fixed_decimal & operator+=(const signed_fixed_decimal & rhs){
+            return *this = *this + rhs;
+        }
+
+        signed_fixed_decimal & operator-=(const signed_fixed_decimal & rhs){
+            return *this = *this - rhs;
+        }
+
+        signed_fixed_decimal & operator*=(const signed_fixed_decimal & rhs){
+            return *this = *this * rhs;
+        }
+
+        signed_fixed_decimal & operator/=(const signed_fixed_decimal & rhs){
+            return *this = *this / rhs;
+        }
+
+        bool operator==(const signed_fixed_decimal & rhs) const{
+            return (negative_ == rhs.negative_) && (magnitude_ == rhs.magnitude_);
+        }
+
+        bool operator!=(const signed_fixed_decimal & rhs) const{
+            return !(*this == rhs);
+        }
+
+        bool operator<(const signed_fixed_decimal & rhs) const{
+            if (negative_ != rhs.negative_){
+                return negative_;
+            }
+            return negative_?(rhs.magnitude_ < magnitude_):(magnitude_ < rhs.magnitude_);
+        }
+
+        bool operator>(const signed_fixed_decimal & rhs) const{
+            return rhs < *this;
+        }
+
+        bool operator<=(const signed_fixed_decimal & rhs) const{
+            return !(rhs < *this);
+        }
+
+        bool operator>=(const signed_fixed_decimal & rhs) const{
+            return !(*this < rhs);
+        }
+
+        std::size_t format(char * out) const{
+            return uint128_decimal::format <Scale> (uint128_decimal::from(magnitude_.raw()), negative_, out);
+        }
+
+        std::string str() const{
+            char out[FIXED_DECIMAL_MAX_SIZE];
+            return std::string(out, format(out));
+        }
+
+        static bool try_parse(const char * s, std::size_t len, signed_fixed_decimal & out){
+            bool negative = false;
+            if (len && ((*s == '-') || (*s == '+'))){
+                negative = (*s == '-');
+                s++;
+                len--;
+            }
+            fixed_decimal <Scale> magnitude;
+            if (!fixed_decimal <Scale>::try_parse(s, len, magnitude)){
+                return false;
+            }
+            out = signed_fixed_decimal(magnitude, negative);
+            return true;
+        }
+
+        static signed_fixed_decimal parse(const char * s, const std::size_t len){
+            signed_fixed_decimal out;
+            if (!try_parse(s, len, out)){
+                throw std::invalid_argument("Error: not a signed_fixed_decimal");
+            }
+            return out;
+        }
+
+    private:
+        fixed_decimal <Scale> magnitude_;
+        bool negative_;
+};
+
+#endif
@@ -0,0 +1,545 @@
+#include "uint128_t.build"
+#include "uint128_filter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_UINT128_T_DISPATCH) || defined(__AVX2__)
+#include <immintrin.h>
+#define _UINT128_FILTER_AVX2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static const std::size_t TAG_SIZE = 4;
+static const char BLOOM_TAG[TAG_SIZE + 1] = "SBBF";
+static const char CUCKOO_TAG[TAG_SIZE + 1] = "CUCK";
+
+static uint8_t * align64(uint8_t * ptr){
+    const uintptr_t addr = reinterpret_cast <uintptr_t> (ptr);
+    return ptr + ((64 - (addr & 63)) & 63);
+}
+
+static unsigned lowest_bit(const uint64_t x){
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return index;
+#else
+    unsigned out = 0;
+    for(uint64_t y = x; !(y & 1); y >>= 1){
+        out++;
+    }
+    return out;
+#endif
+}
+
+// reads the tag and the next count variable width keys; returns the number of bytes consumed
+static std::size_t read_header(const uint8_t * in, const std::size_t len, const char * tag, uint128_t * fields, const std::size_t count){
+    if (!in || (len < TAG_SIZE) || std::memcmp(in, tag, TAG_SIZE)){
+        throw std::invalid_argument("Error: not a serialized filter");
+    }
+    return TAG_SIZE + uint128_t::import_varkeys(in + TAG_SIZE, len - TAG_SIZE, fields, count);
+}
+
+// Split-block Bloom filter ///////////////////////////////////////////////////
+
+// odd constants that spread one 32-bit hash over the 8 words of a block
+static const uint32_t SALT[8] = {
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+// blocks are indexed with 32 bits of the hash
+static const uint64_t MAX_BLOCKS = 1ULL << 32;
+
+#if defined(_UINT128_FILTER_AVX2)
+_UINT128_T_TARGET_AVX2 static __m256i bloom_mask(const uint32_t h){
+    const __m256i salt = _mm256_loadu_si256(reinterpret_cast <const __m256i *> (SALT));
+    const __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(h), salt), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), shift);
+}
+
+_UINT128_T_TARGET_AVX2 static void bloom_set_avx2(uint32_t * block, const uint32_t h){
+    __m256i * ptr = reinterpret_cast <__m256i *> (block);
+    _mm256_store_si256(ptr, _mm256_or_si256(_mm256_load_si256(ptr), bloom_mask(h)));
+}
+
+_UINT128_T_TARGET_AVX2 static bool bloom_test_avx2(const uint32_t * block, const uint32_t h){
+    return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast <const __m256i *> (block)), bloom_mask(h));
+}
+#endif
+
+static void bloom_set(uint32_t * block, const uint32_t h){
+#if defined(_UINT128_FILTER_AVX2)
+    if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+        bloom_set_avx2(block, h);
+        return;
+    }
+#endif
+    for(std::size_t i = 0; i < 8; i++){
+        block[i] |= static_cast <uint32_t> (1) << ((h * SALT[i]) >> 27);
+    }
+}
+
+static bool bloom_test(const uint32_t * block, const uint32_t h){
+#if defined(_UINT128_FILTER_AVX2)
+    if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+        return bloom_test_avx2(block, h);
+    }
+#endif
+    uint32_t missing = 0;
+    for(std::size_t i = 0; i < 8; i++){
+        const uint32_t bit = static_cast <uint32_t> (1) << ((h * SALT[i]) >> 27);
+        missing |= bit & ~block[i];
+    }
+    return !missing;
+}
+
+// False positive rate of a split-block filter with keys / blocks keys per block on average.
+// The keys in one block follow a Poisson distribution, and a block holding j keys answers yes
+// for another key with probability (1 - (1 - 1/32)^j)^8, so the rate is the mixture of those.
+static double bloom_fpp(const double keys, const double blocks){
+    const double lambda = keys / blocks;
+    const double spread = 12 * std::sqrt(lambda) + 12;
+    const double first = std::max(0.0, std::floor(lambda - spread));
+    const double last = std::ceil(lambda + spread);
+    double fpp = 0;
+    for(double j = first; j <= last; j++){
+        const double p = std::exp(j * std::log(lambda) - lambda - std::lgamma(j + 1));
+        fpp += p * std::pow(1 - std::pow(1 - 1.0 / 32, j), 8);
+    }
+    return fpp;
+}
+
+std::size_t uint128_bloom_filter::blocks_for(std::size_t count, double fpp){
+    if (!((fpp > 0) && (fpp < 1))){
+        throw std::invalid_argument("Error: false positive rate must be between 0 and 1");
+    }
+    if (!count){
+        return 1;
+    }
+
+    // Starting point: the block count for which a block holding exactly count / blocks keys
+    // gives fpp, (1 - (1 - 1/32)^(count / blocks))^8 ~ (1 - e^(-bits per word))^8. Fuller
+    // blocks cost more than emptier ones save, so this is never enough on its own.
+    const double keys = static_cast <double> (count);
+    const double bits = -8.0 * keys / std::log(1.0 - std::pow(fpp, 1.0 / 8));
+    double lo = std::max(1.0, std::ceil(bits / 256)) - 1;
+
+    // double until the Poisson estimate meets fpp, then search for the fewest blocks that do
+    double hi = lo + 1;
+    while (bloom_fpp(keys, hi) > fpp){
+        if (hi > static_cast <double> (MAX_BLOCKS)){
+            throw std::length_error("Error: bloom filter is too large");
+        }
+        lo = hi;
+        hi *= 2;
+    }
+    while (hi - lo > 1){
+        const double mid = std::floor((lo + hi) / 2);
+        if (bloom_fpp(keys, mid) > fpp){
+            lo = mid;
+        }
+        else{
+            hi = mid;
+        }
+    }
+    if (hi > static_cast <double> (MAX_BLOCKS)){
+        throw std::length_error("Error: bloom filter is too large");
+    }
+    return static_cast <std::size_t> (hi);
+}
+
+uint128_bloom_filter::uint128_bloom_filter()
+    : uint128_bloom_filter(0)
+{}
+
+uint128_bloom_filter::uint128_bloom_filter(std::size_t count, double fpp)
+    : n_blocks(0)
+{
+    resize(blocks_for(count, fpp));
+}
+
+void uint128_bloom_filter::resize(std::size_t count){
+    n_blocks = count;
+    storage.assign(n_blocks * WORDS + 64 / sizeof(uint32_t), 0);
+}
+
+uint32_t * uint128_bloom_filter::data(){
+    return reinterpret_cast <uint32_t *> (align64(reinterpret_cast <uint8_t *> (storage.data())));
+}
+
+const uint32_t * uint128_bloom_filter::data() const{
+    return const_cast <uint128_bloom_filter *> (this) -> data();
+}
+
+std::size_t uint128_bloom_filter::block(uint64_t h) const{
+    return static_cast <std::size_t> (((h >> 32) * n_blocks) >> 32) * WORDS;
+}
+
+void uint128_bloom_filter::insert(const uint128_t & key){
+    const uint64_t h = key.hash();
+    bloom_set(data() + block(h), static_cast <uint32_t> (h));
+}
+
+bool uint128_bloom_filter::contains(const uint128_t & key) const{
+    const uint64_t h = key.hash();
+    return bloom_test(data() + block(h), static_cast <uint32_t> (h));
+}
+
+void uint128_bloom_filter::insert(const uint128_t * keys, std::size_t count){
+    uint32_t * base = data();
+    uint64_t h[BATCH];
+    for(std::size_t i = 0; i < count; i += BATCH){
+        const std::size_t m = (count - i < BATCH)?(count - i):BATCH;
+        for(std::size_t j = 0; j < m; j++){
+            h[j] = keys[i + j].hash();
+            _UINT128_T_PREFETCH(base + block(h[j]));
+        }
+        for(std::size_t j = 0; j < m; j++){
+            bloom_set(base + block(h[j]), static_cast <uint32_t> (h[j]));
+        }
+    }
+}
+
+std::size_t uint128_bloom_filter::contains(const uint128_t * keys, std::size_t count, bool * out) const{
+    const uint32_t * base = data();
+    std::size_t found = 0;
+    uint64_t h[BATCH];
+    for(std::size_t i = 0; i < count; i += BATCH){
+        const std::size_t m = (count - i < BATCH)?(count - i):BATCH;
+        for(std::size_t j = 0; j < m; j++){
+            h[j] = keys[i + j].hash();
+            _UINT128_T_PREFETCH(base + block(h[j]));
+        }
+        for(std::size_t j = 0; j < m; j++){
+            out[i + j] = bloom_test(base + block(h[j]), static_cast <uint32_t> (h[j]));
+            found += out[i + j];
+        }
+    }
+    return found;
+}
+
+void uint128_bloom_filter::clear(){
+    std::fill(storage.begin(), storage.end(), 0);
+}
+
+std::size_t uint128_bloom_filter::blocks() const{
+    return n_blocks;
+}
+
+std::size_t uint128_bloom_filter::size_in_bytes() const{
+    return n_blocks * WORDS * sizeof(uint32_t);
+}
+
+// every block is written as two fixed width keys made of its words in order
+std::vector <uint8_t> uint128_bloom_filter::serialize() const{
+    std::vector <uint8_t> out(TAG_SIZE + UINT128_VARKEY_MAX_SIZE + size_in_bytes());
+    std::memcpy(out.data(), BLOOM_TAG, TAG_SIZE);
+    std::size_t pos = TAG_SIZE + uint128_t(n_blocks).export_varkey(out.data() + TAG_SIZE);
+
+    const uint32_t * words = data();
+    for(std::size_t i = 0; i < n_blocks * WORDS; i += 4, pos += UINT128_KEY_SIZE){
+        uint128_t((static_cast <uint64_t> (words[i]) << 32) | words[i + 1],
+                  (static_cast <uint64_t> (words[i + 2]) << 32) | words[i + 3]).export_key(out.data() + pos);
+    }
+    out.resize(pos);
+    return out;
+}
+
+uint128_bloom_filter uint128_bloom_filter::deserialize(const uint8_t * in, std::size_t len){
+    uint128_t blocks;
+    const std::size_t pos = read_header(in, len, BLOOM_TAG, &blocks, 1);
+
+    const std::size_t payload = len - pos;
+    if (!blocks || (blocks > uint128_t(MAX_BLOCKS)) || (payload % (WORDS * sizeof(uint32_t))) || (blocks != uint128_t(payload / (WORDS * sizeof(uint32_t))))){
+        throw std::invalid_argument("Error: bad bloom filter size");
+    }
+
+    uint128_bloom_filter out;
+    out.resize(static_cast <std::size_t> (blocks));
+    uint32_t * words = out.data();
+    for(std::size_t i = 0; i < out.n_blocks * WORDS; i += 4){
+        const uint128_t key = uint128_t::import_key(in + pos + i * sizeof(uint32_t));
+        words[i]     = static_cast <uint32_t> (key.upper() >> 32);
+        words[i + 1] = static_cast <uint32_t> (key.upper());
+        words[i + 2] = static_cast <uint32_t> (key.lower() >> 32);
+        words[i + 3] = static_cast <uint32_t> (key.lower());
+    }
+    return out;
+}
+
+// Cuckoo filter //////////////////////////////////////////////////////////////
+
+// one bit per 16-bit lane of a bucket
+static const uint64_t LANES = 0x0001000100010001ULL;
+static const uint64_t HIGH_BITS = 0x8000800080008000ULL;
+
+// The lowest set bit marks the first lane that is 0. Higher bits may be wrong, so only
+// the lowest one is ever used to locate a lane.
+static uint64_t zero_lanes(const uint64_t x){
+    return (x - LANES) & ~x & HIGH_BITS;
+}
+
+static uint64_t matching_lanes(const uint64_t bucket, const uint16_t fp){
+    return zero_lanes(bucket ^ (fp * LANES));
+}
+
+uint128_cuckoo_filter::uint128_cuckoo_filter()
+    : uint128_cuckoo_filter(0)
+{}
+
+uint128_cuckoo_filter::uint128_cuckoo_filter(std::size_t capacity)
+    : mask(0), count(0), rng(0x9e3779b97f4a7c15ULL), stash_used(false), stash_fp(0), stash_index(0)
+{
+    // stay below 95% full, where inserts start to fail
+    std::size_t buckets = 2;
+    while (0.95 * static_cast <double> (buckets * SLOTS) < static_cast <double> (capacity)){
+        if (buckets > (static_cast <std::size_t> (-1) >> 4) / sizeof(uint64_t)){
+            throw std::length_error("Error: cuckoo filter is too large");
+        }
+        buckets <<= 1;
+    }
+    resize(buckets);
+}
+
+void uint128_cuckoo_filter::resize(std::size_t buckets){
+    table.assign(buckets, 0);
+    mask = buckets - 1;
+}
+
+// 0 marks an empty slot, so it is not a valid fingerprint
+uint16_t uint128_cuckoo_filter::fingerprint(uint64_t h){
+    const uint16_t fp = static_cast <uint16_t> (h >> 48);
+    return fp?fp:1;
+}
+
+// the other bucket of a fingerprint in bucket index; applying it twice gives back index
+std::size_t uint128_cuckoo_filter::alternate(std::size_t index, uint16_t fp) const{
+    return (index ^ static_cast <std::size_t> (fp * 0x5bd1e995ULL)) & mask;
+}
+
+bool uint128_cuckoo_filter::find(std::size_t i1, std::size_t i2, uint16_t fp) const{
+    if (stash_used && (stash_fp == fp) && ((stash_index == i1) || (stash_index == i2))){
+        return true;
+    }
+    return (matching_lanes(table[i1], fp) | matching_lanes(table[i2], fp)) != 0;
+}
+
+bool uint128_cuckoo_filter::add(std::size_t index, uint16_t fp){
+    const uint64_t empty = zero_lanes(table[index]);
+    if (!empty){
+        return false;
+    }
+    table[index] |= static_cast <uint64_t> (fp) << (lowest_bit(empty) & ~15U);
+    return true;
+}
+
+bool uint128_cuckoo_filter::remove(std::size_t index, uint16_t fp){
+    const uint64_t match = matching_lanes(table[index], fp);
+    if (!match){
+        return false;
+    }
+    table[index] &= ~(static_cast <uint64_t> (0xffff) << (lowest_bit(match) & ~15U));
+    return true;
+}
+
+bool uint128_cuckoo_filter::insert(std::size_t index, uint16_t fp){
+    if (stash_used){
+        return false;
+    }
+
+    const std::size_t other = alternate(index, fp);
+    if (add(index, fp) || add(other, fp)){
+        count++;
+        return true;
+    }
+
+    // both buckets are full: evict a random fingerprint and move it to its other bucket
+    std::size_t i = (rng & 1)?index:other;
+    for(unsigned kick = 0; kick < MAX_KICKS; kick++){
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+
+        const unsigned shift = static_cast <unsigned> (rng & (SLOTS - 1)) * 16;
+        const uint16_t victim = static_cast <uint16_t> (table[i] >> shift);
+        table[i] = (table[i] & ~(static_cast <uint64_t> (0xffff) << shift)) | (static_cast <uint64_t> (fp) << shift);
+        fp = victim;
+
+        i = alternate(i, fp);
+        if (add(i, fp)){
+            count++;
+            return true;
+        }
+    }
+
+    // the key made it in; the fingerprint that was pushed out waits in the stash
+    stash_used = true;
+    stash_fp = fp;
+    stash_index = i;
+    count++;
+    return true;
+}
+
+bool uint128_cuckoo_filter::insert(const uint128_t & key){
+    const uint64_t h = key.hash();
+    return insert(static_cast <std::size_t> (h) & mask, fingerprint(h));
+}
+
+bool uint128_cuckoo_filter::contains(const uint128_t & key) const{
+    const uint64_t h = key.hash();
+    const uint16_t fp = fingerprint(h);
+    const std::size_t index = static_cast <std::size_t> (h) & mask;
+    return find(index, alternate(index, fp), fp);
+}
+
+bool uint128_cuckoo_filter::erase(const uint128_t & key){
+    const uint64_t h = key.hash();
+    const uint16_t fp = fingerprint(h);
+    const std::size_t index = static_cast <std::size_t> (h) & mask;
+    const std::size_t other = alternate(index, fp);
+
+    if (stash_used && (stash_fp == fp) && ((stash_index == index) || (stash_index == other))){
+        stash_used = false;
+        count--;
+        return true;
+    }
+
+    if (!remove(index, fp) && !remove(other, fp)){
+        return false;
+    }
+    count--;
+
+    // there is room again; try to put the stashed fingerprint back into the table
+    if (stash_used){
+        stash_used = false;
+        count--;
+        insert(stash_index, stash_fp);
+    }
+    return true;
+}
+
+std::size_t uint128_cuckoo_filter::insert(const uint128_t * keys, std::size_t n){
+    std::size_t added = 0;
+    uint64_t h[BATCH];
+    for(std::size_t i = 0; i < n; i += BATCH){
+        const std::size_t m = (n - i < BATCH)?(n - i):BATCH;
+        for(std::size_t j = 0; j < m; j++){
+            h[j] = keys[i + j].hash();
+            const std::size_t index = static_cast <std::size_t> (h[j]) & mask;
+            _UINT128_T_PREFETCH(&table[index]);
+            _UINT128_T_PREFETCH(&table[alternate(index, fingerprint(h[j]))]);
+        }
+        for(std::size_t j = 0; j < m; j++){
+            added += insert(static_cast <std::size_t> (h[j]) & mask, fingerprint(h[j]));
+        }
+    }
+    return added;
+}
+
+std::size_t uint128_cuckoo_filter::contains(const uint128_t * keys, std::size_t n, bool * out) const{
+    std::size_t found = 0;
+    std::size_t index[BATCH];
+    std::size_t other[BATCH];
+    uint16_t fp[BATCH];
+    for(std::size_t i = 0; i < n; i += BATCH){
+        const std::size_t m = (n - i < BATCH)?(n - i):BATCH;
+        for(std::size_t j = 0; j < m; j++){
+            const uint64_t h = keys[i + j].hash();
+            fp[j] = fingerprint(h);
+            index[j] = static_cast <std::size_t> (h) & mask;
+            other[j] = alternate(index[j], fp[j]);
+            _UINT128_T_PREFETCH(&table[index[j]]);
+            _UINT128_T_PREFETCH(&table[other[j]]);
+        }
+        for(std::size_t j = 0; j < m; j++){
+            out[i + j] = find(index[j], other[j], fp[j]);
+            found += out[i + j];
+        }
+    }
+    return found;
+}
+
+void uint128_cuckoo_filter::clear(){
+    std::fill(table.begin(), table.end(), 0);
+    count = 0;
+    stash_used = false;
+}
+
+std::size_t uint128_cuckoo_filter::size() const{
+    return count;
+}
+
+std::size_t uint128_cuckoo_filter::capacity() const{
+    return table.size() * SLOTS;
+}
+
+std::size_t uint128_cuckoo_filter::size_in_bytes() const{
+    return table.size() * sizeof(uint64_t);
+}
+
+// header: buckets, size, stashed fingerprint (0 if none), stash bucket
+// every pair of buckets is written as one fixed width key
+std::vector <uint8_t> uint128_cuckoo_filter::serialize() const{
+    const uint128_t fields[4] = {
+        uint128_t(table.size()),
+        uint128_t(count),
+        uint128_t(stash_used?stash_fp:0),
+        uint128_t(stash_used?stash_index:0),
+    };
+
+    std::vector <uint8_t> out(TAG_SIZE + 4 * UINT128_VARKEY_MAX_SIZE + size_in_bytes());
+    std::memcpy(out.data(), CUCKOO_TAG, TAG_SIZE);
+    std::size_t pos = TAG_SIZE + uint128_t::export_varkeys(fields, 4, out.data() + TAG_SIZE);
+
+    for(std::size_t i = 0; i < table.size(); i += 2, pos += UINT128_KEY_SIZE){
+        uint128_t(table[i], table[i + 1]).export_key(out.data() + pos);
+    }
+    out.resize(pos);
+    return out;
+}
+
+uint128_cuckoo_filter uint128_cuckoo_filter::deserialize(const uint8_t * in, std::size_t len){
+    uint128_t fields[4];
+    const std::size_t pos = read_header(in, len, CUCKOO_TAG, fields, 4);
+
+    const uint128_t & buckets = fields[0];
+    const std::size_t payload = len - pos;
+    if ((buckets < uint128_t(2)) || (buckets & (buckets - 1)) || (payload % UINT128_KEY_SIZE) || (buckets != uint128_t(payload / sizeof(uint64_t)))){
+        throw std::invalid_argument("Error: bad cuckoo filter size");
+    }
+
+    uint128_cuckoo_filter out;
+    out.resize(static_cast <std::size_t> (buckets));
+    std::size_t used = 0;
+    for(std::size_t i = 0; i < out.table.size(); i += 2){
+        const uint128_t key = uint128_t::import_key(in + pos + i * sizeof(uint64_t));
+        out.table[i] = key.upper();
+        out.table[i + 1] = key.lower();
+        for(unsigned shift = 0; shift < 64; shift += 16){
+            used += ((out.table[i] >> shift) & 0xffff) != 0;
+            used += ((out.table[i + 1] >> shift) & 0xffff) != 0;
+        }
+    }
+
+    if ((fields[2] > uint128_t(0xffff)) || (fields[3] >= buckets)){
+        throw std::invalid_argument("Error: bad cuckoo filter stash");
+    }
+    out.stash_used = fields[2] != uint128_0;
+    out.stash_fp = static_cast <uint16_t> (fields[2]);
+    out.stash_index = static_cast <std::size_t> (fields[3]);
+
+    if (fields[1] != uint128_t(used + out.stash_used)){
+        throw std::invalid_argument("Error: bad cuckoo filter size");
+    }
+    out.count = used + out.stash_used;
+    return out;
+}
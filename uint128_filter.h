@@ -0,0 +1,122 @@
+/*
+uint128_filter.h
+Approximate membership filters with uint128_t keys
+
+Both filters take their probes from uint128_t::hash(), which folds the two 64-bit halves
+together with a single multiply, so a key is hashed exactly once per insert or query.
+
+uint128_bloom_filter is a split-block Bloom filter: the hash picks one 256-bit block, and
+8 bits are set in that block, one in each of its 32-bit words. Every operation touches a
+single cache line, and the 8 bit positions are computed at once with AVX2 when available.
+
+uint128_cuckoo_filter stores 16-bit fingerprints in buckets of 4, and each key has two
+candidate buckets. Unlike the Bloom filter it supports erase. A bucket is one 64-bit word,
+so looking for a fingerprint compares all 4 slots at once.
+
+The bulk versions hash a batch of keys first and prefetch their blocks or buckets, so the
+cache misses of the batch overlap.
+
+serialize() writes a 4 byte tag, the parameters as variable width keys, and the table as
+fixed width keys (see uint128_t::export_key). deserialize() throws std::invalid_argument
+on input that is not a valid filter.
+*/
+
+#ifndef __UINT128_FILTER__
+#define __UINT128_FILTER__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "uint128_t.h"
+
+class UINT128_T_EXTERN uint128_bloom_filter{
+    public:
+        // number of blocks needed for count keys at the given false positive rate
+        static std::size_t blocks_for(std::size_t count, double fpp);
+
+        uint128_bloom_filter();
+        // sized for count keys at the given false positive rate
+        explicit uint128_bloom_filter(std::size_t count, double fpp = 0.01);
+
+        void insert(const uint128_t & key);
+        bool contains(const uint128_t & key) const;
+
+        // bulk versions; contains returns the number of keys that may be present
+        void insert(const uint128_t * keys, std::size_t count);
+        std::size_t contains(const uint128_t * keys, std::size_t count, bool * out) const;
+
+        void clear();
+
+        std::size_t blocks() const;
+        std::size_t size_in_bytes() const;
+
+        std::vector <uint8_t> serialize() const;
+        static uint128_bloom_filter deserialize(const uint8_t * in, std::size_t len);
+
+    private:
+        static const std::size_t WORDS = 8;             // 32-bit words per block
+        static const std::size_t BATCH = 16;
+
+        std::size_t n_blocks;
+        std::vector <uint32_t> storage;                 // padded so that blocks start on a cache line
+
+        uint32_t * data();
+        const uint32_t * data() const;
+        std::size_t block(uint64_t h) const;
+
+        void resize(std::size_t count);
+};
+
+class UINT128_T_EXTERN uint128_cuckoo_filter{
+    public:
+        uint128_cuckoo_filter();
+        // sized for capacity keys
+        explicit uint128_cuckoo_filter(std::size_t capacity);
+
+        // returns false if the filter is full; the key is not added then
+        bool insert(const uint128_t & key);
+        bool contains(const uint128_t & key) const;
+        // only erase keys that were inserted, or other keys may start to be reported missing
+        bool erase(const uint128_t & key);
+
+        // bulk versions; insert returns the number of keys added, contains the number that may be present
+        std::size_t insert(const uint128_t * keys, std::size_t count);
+        std::size_t contains(const uint128_t * keys, std::size_t count, bool * out) const;
+
+        void clear();
+
+        std::size_t size() const;
+        std::size_t capacity() const;
+        std::size_t size_in_bytes() const;
+
+        std::vector <uint8_t> serialize() const;
+        static uint128_cuckoo_filter deserialize(const uint8_t * in, std::size_t len);
+
+    private:
+        static const std::size_t SLOTS = 4;             // fingerprints per bucket
+        static const unsigned MAX_KICKS = 500;
+        static const std::size_t BATCH = 16;
+
+        std::vector <uint64_t> table;                   // one bucket per word, 0 marks an empty slot
+        std::size_t mask;
+        std::size_t count;
+        uint64_t rng;
+
+        // the fingerprint left over when an insert runs out of kicks
+        bool stash_used;
+        uint16_t stash_fp;
+        std::size_t stash_index;
+
+        static uint16_t fingerprint(uint64_t h);
+        std::size_t alternate(std::size_t index, uint16_t fp) const;
+
+        bool find(std::size_t i1, std::size_t i2, uint16_t fp) const;
+        bool add(std::size_t index, uint16_t fp);
+        bool remove(std::size_t index, uint16_t fp);
+        bool insert(std::size_t index, uint16_t fp);
+
+        void resize(std::size_t buckets);
+};
+
+#endif
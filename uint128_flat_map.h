@@ -0,0 +1,641 @@
+/*
+uint128_flat_map.h
+Open addressing hash map and set with uint128_t keys
+
+Swiss table layout: every slot has a one byte control tag that is either EMPTY, DELETED, or
+the low 7 bits of the key's hash. Lookups load a group of 16 tags, compare all of them against
+the wanted tag at once (SSE2 when available, 64-bit SWAR otherwise), and only compare the keys
+whose tags match. Keys and values are stored inline, so a lookup usually touches one group of
+tags and one slot.
+
+Emptiness is recorded in the control tags instead of in a reserved key, so every uint128_t
+value, including 0 and 0xff...ff, can be stored.
+
+Lookups also accept the key as its (upper, lower) halves, so callers holding the two 64-bit
+words do not need to build a uint128_t first.
+*/
+
+#ifndef __UINT128_FLAT_MAP__
+#define __UINT128_FLAT_MAP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define _UINT128_FLAT_MAP_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "uint128_t.h"
+
+// Control tag of one group of 16 slots
+class uint128_flat_group{
+    public:
+        static const std::size_t WIDTH = 16;
+
+        // tags with the high bit set are not full
+        static const uint8_t EMPTY   = 0x80;
+        static const uint8_t DELETED = 0xfe;
+
+        explicit uint128_flat_group(const uint8_t * ctrl)
+            : ctrl(ctrl)
+        {}
+
+        // one bit per slot whose tag equals tag
+        uint32_t match(const uint8_t tag) const{
+#ifdef _UINT128_FLAT_MAP_SSE2
+            const __m128i group = _mm_loadu_si128(reinterpret_cast <const __m128i *> (ctrl));
+            return static_cast <uint32_t> (_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast <char> (tag)))));
+#else
+            // may report false positives after a real match; callers compare keys anyway
+            const uint64_t pattern = LSBS * tag;
+            return compress(has_zero(load(0) ^ pattern)) | (compress(has_zero(load(8) ^ pattern)) << 8);
+#endif
+        }
+
+        uint32_t match_empty() const{
+#ifdef _UINT128_FLAT_MAP_SSE2
+            return match(EMPTY);
+#else
+            // exact: only 0x80 has bit 7 set and bit 1 clear
+            return compress(empty(load(0))) | (compress(empty(load(8))) << 8);
+#endif
+        }
+
+        uint32_t match_empty_or_deleted() const{
+#ifdef _UINT128_FLAT_MAP_SSE2
+            return static_cast <uint32_t> (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast <const __m128i *> (ctrl))));
+#else
+            return compress(load(0) & MSBS) | (compress(load(8) & MSBS) << 8);
+#endif
+        }
+
+        static unsigned lowest(const uint32_t mask){
+#if defined(__GNUC__)
+            return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            unsigned index = 0;
+            while (!((mask >> index) & 1)){
+                index++;
+            }
+            return index;
+#endif
+        }
+
+    private:
+        const uint8_t * ctrl;
+
+#ifndef _UINT128_FLAT_MAP_SSE2
+        static const uint64_t LSBS = 0x0101010101010101ULL;
+        static const uint64_t MSBS = 0x8080808080808080ULL;
+
+        // little endian load regardless of the host, so that byte i is bits [8i, 8i + 8)
+        uint64_t load(const std::size_t offset) const{
+            uint64_t out = 0;
+            for(std::size_t i = 0; i < 8; i++){
+                out |= static_cast <uint64_t> (ctrl[offset + i]) << (8 * i);
+            }
+            return out;
+        }
+
+        static uint64_t has_zero(const uint64_t word){
+            return (word - LSBS) & ~word & MSBS;
+        }
+
+        static uint64_t empty(const uint64_t word){
+            return word & ~(word << 6) & MSBS;
+        }
+
+        // gather the high bit of each byte into the low 8 bits
+        static uint32_t compress(const uint64_t msbs){
+            return static_cast <uint32_t> (((msbs >> 7) * 0x0102040810204080ULL) >> 56);
+        }
+#endif
+};
+
+// Shared implementation of uint128_flat_map and uint128_flat_set
+// Policy provides slot_type and the static function key(const slot_type &).
+template <typename Policy, typename Hash>
+class uint128_flat_table{
+    public:
+        typedef typename Policy::slot_type value_type;
+        typedef std::size_t size_type;
+
+        template <typename Ref, typename Ptr>
+        class basic_iterator{
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef typename Policy::slot_type value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Ptr pointer;
+                typedef Ref reference;
+
+                basic_iterator()
+                    : ctrl(nullptr), end(nullptr), slot(nullptr)
+                {}
+
+                // allow iterator -> const_iterator
+                template <typename R, typename P>
+                basic_iterator(const basic_iterator <R, P> & rhs)
+                    : ctrl(rhs.ctrl), end(rhs.end), slot(rhs.slot)
+                {}
+
+                reference operator*() const{
+                    return *slot;
+                }
+
+                pointer operator->() const{
+                    return slot;
+                }
+
+                basic_iterator & operator++(){
+                    ++ctrl;
+                    ++slot;
+                    skip();
+                    return *this;
+                }
+
+                basic_iterator operator++(int){
+                    basic_iterator temp(*this);
+                    ++*this;
+                    return temp;
+                }
+
+                bool operator==(const basic_iterator & rhs) const{
+                    return slot == rhs.slot;
+                }
+
+                bool operator!=(const basic_iterator & rhs) const{
+                    return slot != rhs.slot;
+                }
+
+            private:
+                friend class uint128_flat_table;
+                template <typename R, typename P> friend class basic_iterator;
+
+                const uint8_t * ctrl;
+                const uint8_t * end;
+                Ptr slot;
+
+                basic_iterator(const uint8_t * ctrl, const uint8_t * end, Ptr slot)
+                    : ctrl(ctrl), end(end), slot(slot)
+                {}
+
+                void skip(){
+                    while ((ctrl != end) && (*ctrl & 0x80)){
+                        ++ctrl;
+                        ++slot;
+                    }
+                }
+        };
+
+        typedef basic_iterator <value_type &, value_type *> iterator;
+        typedef basic_iterator <const value_type &, const value_type *> const_iterator;
+
+        explicit uint128_flat_table(const std::size_t n = 0, const Hash & hash = Hash())
+            : ctrl(nullptr), slots(nullptr), used(0), cap(0), growth_left(0), hasher(hash)
+        {
+            reserve(n);
+        }
+
+        uint128_flat_table(const uint128_flat_table & rhs)
+            : ctrl(nullptr), slots(nullptr), used(0), cap(0), growth_left(0), hasher(rhs.hasher)
+        {
+            reserve(rhs.used);
+            for(const_iterator it = rhs.begin(); it != rhs.end(); ++it){
+                emplace_unique(Policy::key(*it), *it);
+            }
+        }
+
+        uint128_flat_table(uint128_flat_table && rhs)
+            : ctrl(rhs.ctrl), slots(rhs.slots), used(rhs.used), cap(rhs.cap), growth_left(rhs.growth_left), hasher(rhs.hasher)
+        {
+            rhs.ctrl = nullptr;
+            rhs.slots = nullptr;
+            rhs.used = rhs.cap = rhs.growth_left = 0;
+        }
+
+        uint128_flat_table & operator=(const uint128_flat_table & rhs){
+            if (this != &rhs){
+                uint128_flat_table temp(rhs);
+                swap(temp);
+            }
+            return *this;
+        }
+
+        uint128_flat_table & operator=(uint128_flat_table && rhs){
+            if (this != &rhs){
+                uint128_flat_table temp(std::move(rhs));
+                swap(temp);
+            }
+            return *this;
+        }
+
+        ~uint128_flat_table(){
+            destroy();
+        }
+
+        void swap(uint128_flat_table & rhs){
+            std::swap(ctrl, rhs.ctrl);
+            std::swap(slots, rhs.slots);
+            std::swap(used, rhs.used);
+            std::swap(cap, rhs.cap);
+            std::swap(growth_left, rhs.growth_left);
+            std::swap(hasher, rhs.hasher);
+        }
+
+        iterator begin(){
+            iterator it(ctrl, ctrl + cap, slots);
+            it.skip();
+            return it;
+        }
+
+        iterator end(){
+            return iterator(ctrl + cap, ctrl + cap, slots + cap);
+        }
+
+        const_iterator begin() const{
+            const_iterator it(ctrl, ctrl + cap, slots);
+            it.skip();
+            return it;
+        }
+
+        const_iterator end() const{
+            return const_iterator(ctrl + cap, ctrl + cap, slots + cap);
+        }
+
+        bool empty() const{
+            return !used;
+        }
+
+        std::size_t size() const{
+            return used;
+        }
+
+        std::size_t capacity() const{
+            return cap;
+        }
+
+        void clear(){
+            for(std::size_t i = 0; i < cap; i++){
+                if (!(ctrl[i] & 0x80)){
+                    slots[i].~value_type();
+                }
+            }
+            if (cap){
+                std::memset(ctrl, uint128_flat_group::EMPTY, cap);
+            }
+            used = 0;
+            growth_left = max_load(cap);
+        }
+
+        // make room for n elements without rehashing
+        void reserve(const std::size_t n){
+            if (n > max_load(cap)){
+                std::size_t new_cap = uint128_flat_group::WIDTH;
+                while (max_load(new_cap) < n){
+                    new_cap <<= 1;
+                }
+                rehash(new_cap);
+            }
+        }
+
+        iterator find(const uint64_t upper, const uint64_t lower){
+            const std::size_t index = find_index(upper, lower);
+            return (index == cap)?end():iterator(ctrl + index, ctrl + cap, slots + index);
+        }
+
+        const_iterator find(const uint64_t upper, const uint64_t lower) const{
+            const std::size_t index = find_index(upper, lower);
+            return (index == cap)?end():const_iterator(ctrl + index, ctrl + cap, slots + index);
+        }
+
+        iterator find(const uint128_t & key){
+            return find(key.upper(), key.lower());
+        }
+
+        const_iterator find(const uint128_t & key) const{
+            return find(key.upper(), key.lower());
+        }
+
+        bool contains(const uint64_t upper, const uint64_t lower) const{
+            return find_index(upper, lower) != cap;
+        }
+
+        bool contains(const uint128_t & key) const{
+            return contains(key.upper(), key.lower());
+        }
+
+        std::size_t count_key(const uint128_t & key) const{
+            return contains(key)?1:0;
+        }
+
+        std::size_t erase(const uint128_t & key){
+            const std::size_t index = find_index(key.upper(), key.lower());
+            if (index == cap){
+                return 0;
+            }
+            erase_index(index);
+            return 1;
+        }
+
+        void erase(const_iterator it){
+            erase_index(it.slot - slots);
+        }
+
+    protected:
+        // builds the slot in place from args if key is not present
+        template <typename... Args>
+        std::pair <iterator, bool> emplace_unique(const uint128_t & key, Args &&... args){
+            const uint64_t h = hash(key);
+            std::size_t index = find_index(key.upper(), key.lower(), h);
+            if (index != cap){
+                return std::make_pair(iterator(ctrl + index, ctrl + cap, slots + index), false);
+            }
+
+            if (!cap){
+                rehash(uint128_flat_group::WIDTH);
+            }
+
+            index = find_free(h);
+            // out of room: grow, or just clear out the tombstones if they are what filled the table
+            if (!growth_left && (ctrl[index] == uint128_flat_group::EMPTY)){
+                rehash((used * 2 > max_load(cap))?(cap << 1):cap);
+                index = find_free(h);
+            }
+
+            ::new (static_cast <void *> (slots + index)) value_type(std::forward <Args> (args)...);
+            growth_left -= (ctrl[index] == uint128_flat_group::EMPTY);
+            ctrl[index] = tag(h);
+            used++;
+            return std::make_pair(iterator(ctrl + index, ctrl + cap, slots + index), true);
+        }
+
+    private:
+        uint8_t * ctrl;
+        value_type * slots;
+        std::size_t used;
+        std::size_t cap;            // 0 or a power of 2 that is at least uint128_flat_group::WIDTH
+        std::size_t growth_left;    // inserts into EMPTY slots left before a rehash
+        Hash hasher;
+
+        // 7/8 load factor
+        static std::size_t max_load(const std::size_t capacity){
+            return capacity - (capacity >> 3);
+        }
+
+        uint64_t hash(const uint128_t & key) const{
+            return static_cast <uint64_t> (hasher(key));
+        }
+
+        static uint8_t tag(const uint64_t h){
+            return static_cast <uint8_t> (h & 0x7f);
+        }
+
+        // groups are visited in triangular order, which covers all of them when the group count is a power of 2
+        std::size_t first_group(const uint64_t h) const{
+            return static_cast <std::size_t> (h >> 7) & ((cap / uint128_flat_group::WIDTH) - 1);
+        }
+
+        std::size_t find_index(const uint64_t upper, const uint64_t lower) const{
+            return cap?find_index(upper, lower, hash(uint128_t(upper, lower))):cap;
+        }
+
+        std::size_t find_index(const uint64_t upper, const uint64_t lower, const uint64_t h) const{
+            if (!cap){
+                return cap;
+            }
+
+            const std::size_t groups_mask = (cap / uint128_flat_group::WIDTH) - 1;
+            std::size_t group = first_group(h);
+            for(std::size_t step = 1; step <= groups_mask + 1; step++){
+                const std::size_t base = group * uint128_flat_group::WIDTH;
+                const uint128_flat_group g(ctrl + base);
+                for(uint32_t mask = g.match(tag(h)); mask; mask &= mask - 1){
+                    const std::size_t index = base + uint128_flat_group::lowest(mask);
+                    const uint128_t & key = Policy::key(slots[index]);
+                    if ((key.lower() == lower) && (key.upper() == upper)){
+                        return index;
+                    }
+                }
+                // the key would have been placed in this group
+                if (g.match_empty()){
+                    break;
+                }
+                group = (group + step) & groups_mask;
+            }
+            return cap;
+        }
+
+        // first EMPTY or DELETED slot on the probe sequence of h
+        std::size_t find_free(const uint64_t h) const{
+            const std::size_t groups_mask = (cap / uint128_flat_group::WIDTH) - 1;
+            std::size_t group = first_group(h);
+            for(std::size_t step = 1;; step++){
+                const std::size_t base = group * uint128_flat_group::WIDTH;
+                const uint32_t mask = uint128_flat_group(ctrl + base).match_empty_or_deleted();
+                if (mask){
+                    return base + uint128_flat_group::lowest(mask);
+                }
+                group = (group + step) & groups_mask;
+            }
+        }
+
+        void erase_index(const std::size_t index){
+            slots[index].~value_type();
+            used--;
+
+            // Probes only stop at a group with an EMPTY slot, so if this group already has one, no probe
+            // sequence can run through it and the slot can go straight back to EMPTY.
+            const std::size_t base = index & ~(uint128_flat_group::WIDTH - 1);
+            if (uint128_flat_group(ctrl + base).match_empty()){
+                ctrl[index] = uint128_flat_group::EMPTY;
+                growth_left++;
+            }
+            else{
+                ctrl[index] = uint128_flat_group::DELETED;
+            }
+        }
+
+        void rehash(const std::size_t new_cap){
+            uint8_t * old_ctrl = ctrl;
+            value_type * old_slots = slots;
+            const std::size_t old_cap = cap;
+
+            // allocate both buffers before touching the members, so a failed allocation leaves the old table intact
+            uint8_t * new_ctrl = static_cast <uint8_t *> (::operator new(new_cap));
+            value_type * new_slots;
+            try{
+                new_slots = static_cast <value_type *> (::operator new(new_cap * sizeof(value_type)));
+            }
+            catch (...){
+                ::operator delete(new_ctrl);
+                throw;
+            }
+            std::memset(new_ctrl, uint128_flat_group::EMPTY, new_cap);
+
+            ctrl = new_ctrl;
+            slots = new_slots;
+            cap = new_cap;
+            growth_left = max_load(cap) - used;
+
+            for(std::size_t i = 0; i < old_cap; i++){
+                if (!(old_ctrl[i] & 0x80)){
+                    const uint64_t h = hash(Policy::key(old_slots[i]));
+                    const std::size_t index = find_free(h);
+                    ::new (static_cast <void *> (slots + index)) value_type(std::move(old_slots[i]));
+                    ctrl[index] = tag(h);
+                    old_slots[i].~value_type();
+                }
+            }
+
+            ::operator delete(old_ctrl);
+            ::operator delete(old_slots);
+        }
+
+        void destroy(){
+            clear();
+            ::operator delete(ctrl);
+            ::operator delete(slots);
+            ctrl = nullptr;
+            slots = nullptr;
+            cap = growth_left = 0;
+        }
+};
+
+template <typename V>
+struct uint128_flat_map_policy{
+    typedef std::pair <const uint128_t, V> slot_type;
+
+    static const uint128_t & key(const slot_type & slot){
+        return slot.first;
+    }
+};
+
+struct uint128_flat_set_policy{
+    typedef uint128_t slot_type;
+
+    static const uint128_t & key(const slot_type & slot){
+        return slot;
+    }
+};
+
+template <typename V, typename Hash = std::hash <uint128_t> >
+class uint128_flat_map : public uint128_flat_table <uint128_flat_map_policy <V>, Hash>{
+    private:
+        typedef uint128_flat_table <uint128_flat_map_policy <V>, Hash> table;
+
+    public:
+        typedef uint128_t key_type;
+        typedef V mapped_type;
+        typedef typename table::value_type value_type;
+        typedef typename table::iterator iterator;
+        typedef typename table::const_iterator const_iterator;
+
+        explicit uint128_flat_map(const std::size_t n = 0, const Hash & hash = Hash())
+            : table(n, hash)
+        {}
+
+        std::pair <iterator, bool> insert(const value_type & value){
+            return this -> emplace_unique(value.first, value);
+        }
+
+        std::pair <iterator, bool> insert(value_type && value){
+            const uint128_t key = value.first;
+            return this -> emplace_unique(key, std::move(value));
+        }
+
+        // only constructs the value if key is not present
+        template <typename... Args>
+        std::pair <iterator, bool> try_emplace(const uint128_t & key, Args &&... args){
+            return this -> emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward <Args> (args)...));
+        }
+
+        V & operator[](const uint128_t & key){
+            return try_emplace(key).first -> second;
+        }
+
+        V & at(const uint128_t & key){
+            iterator it = this -> find(key);
+            if (it == this -> end()){
+                throw std::out_of_range("Error: key not found");
+            }
+            return it -> second;
+        }
+
+        const V & at(const uint128_t & key) const{
+            const_iterator it = this -> find(key);
+            if (it == this -> end()){
+                throw std::out_of_range("Error: key not found");
+            }
+            return it -> second;
+        }
+
+        std::size_t count(const uint128_t & key) const{
+            return this -> count_key(key);
+        }
+};
+
+// keys cannot be modified in place, so both iterator types are const
+template <typename Hash = std::hash <uint128_t> >
+class uint128_basic_flat_set : public uint128_flat_table <uint128_flat_set_policy, Hash>{
+    private:
+        typedef uint128_flat_table <uint128_flat_set_policy, Hash> table;
+
+    public:
+        typedef uint128_t key_type;
+        typedef typename table::value_type value_type;
+        typedef typename table::const_iterator iterator;
+        typedef typename table::const_iterator const_iterator;
+
+        explicit uint128_basic_flat_set(const std::size_t n = 0, const Hash & hash = Hash())
+            : table(n, hash)
+        {}
+
+        const_iterator begin() const{
+            return table::begin();
+        }
+
+        const_iterator end() const{
+            return table::end();
+        }
+
+        const_iterator find(const uint64_t upper, const uint64_t lower) const{
+            return table::find(upper, lower);
+        }
+
+        const_iterator find(const uint128_t & key) const{
+            return table::find(key);
+        }
+
+        std::pair <const_iterator, bool> insert(const uint128_t & key){
+            return this -> emplace_unique(key, key);
+        }
+
+        std::pair <const_iterator, bool> insert(const uint64_t upper, const uint64_t lower){
+            return insert(uint128_t(upper, lower));
+        }
+
+        std::size_t count(const uint128_t & key) const{
+            return this -> count_key(key);
+        }
+};
+
+typedef uint128_basic_flat_set <> uint128_flat_set;
+
+#endif
@@ -0,0 +1,453 @@
+/*
+uint128_float.h
+Conversions between uint128_t and the floating point types
+
+to_float, to_double and to_long_double round to nearest, ties to even, as a cast from
+unsigned __int128 does. Converting through the halves, upper() * 2^64 + lower(), rounds
+twice and is one unit in the last place off for a few values in every thousand.
+
+The value is normalized with one count of leading zeros, so that its top bit is bit 63 of a
+64-bit word, and the rounding is done on that word with the bits shifted out of it folded
+into a sticky bit. The rounded significand, implicit bit included, is then added to the
+biased exponent minus one shifted into place: a significand that rounds up to the next power
+of 2 carries into the exponent by itself, and 2^128 - 1 becomes infinity as a float.
+
+from_double and from_long_double truncate toward zero, so anything in (-1, 2^128) converts.
+In UINT128_FLOAT_CHECKED mode (the default) NaN throws std::domain_error and other values
+outside that range throw std::overflow_error; in UINT128_FLOAT_SATURATE mode NaN and
+negative values give 0 and values of 2^128 and above give 2^128 - 1.
+
+The array versions process 8 values per iteration with AVX-512F and AVX-512CD or 4 with
+AVX2, using the same integer steps as the scalar code. With runtime dispatch (see
+uint128_t_config.include) both are compiled and picked from the CPU; otherwise only the one
+the compiler targets is. AVX2 has no vector count of leading zeros; the index of the top bit is the
+exponent of the 32-bit halves of a word converted to double, which is exact. The checked
+array from_double writes every element, with saturated values where a conversion failed,
+before throwing.
+*/
+
+#ifndef __UINT128_FLOAT__
+#define __UINT128_FLOAT__
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "uint128_t.h"
+
+#if defined(_UINT128_T_DISPATCH) || (defined(__AVX512F__) && defined(__AVX512CD__))
+#define _UINT128_FLOAT_AVX512
+#endif
+
+#if defined(_UINT128_T_DISPATCH) || defined(__AVX2__)
+#define _UINT128_FLOAT_AVX2
+#endif
+
+#if defined(_UINT128_FLOAT_AVX512) || defined(_UINT128_FLOAT_AVX2)
+#include <immintrin.h>
+#endif
+
+enum uint128_float_mode{
+    UINT128_FLOAT_CHECKED,
+    UINT128_FLOAT_SATURATE,
+};
+
+// GCC 12 reports the undefined source operand of its own AVX-512 shift intrinsics as
+// maybe-uninitialized (GCC bug 105593)
+#if defined(__GNUC__) && !defined(__clang__) && defined(_UINT128_FLOAT_AVX512)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+class uint128_float{
+    public:
+        // Shift:    bits below the significand of a normalized 64-bit word
+        // Position: bit position of the implicit bit in the encoding
+        // Base:     exponent bias - 1
+        struct single_format{
+            typedef float type;
+            static const unsigned SHIFT = 40;
+            static const unsigned POSITION = 23;
+            static const uint64_t BASE = 126;
+        };
+
+        struct double_format{
+            typedef double type;
+            static const unsigned SHIFT = 11;
+            static const unsigned POSITION = 52;
+            static const uint64_t BASE = 1022;
+        };
+
+        // x != 0
+        static unsigned leading_zeros(uint64_t x){
+#if defined(__GNUC__)
+            return __builtin_clzll(static_cast <unsigned long long> (x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64))
+            unsigned long index;
+            _BitScanReverse64(&index, x);
+            return 63 - index;
+#else
+            unsigned out = 0;
+            while (!(x >> 63)){
+                x <<= 1;
+                out++;
+            }
+            return out;
+#endif
+        }
+
+        // encoding of (hi, lo) rounded to Format
+        template <typename Format>
+        static uint64_t round_bits(const uint64_t hi, const uint64_t lo){
+            if (!(hi | lo)){
+                return 0;
+            }
+            const uint64_t h = hi?hi:lo;
+            const uint64_t l = hi?lo:0;
+            const unsigned s = leading_zeros(h);
+            const uint64_t top = s?((h << s) | (l >> (64 - s))):h;
+            const uint64_t mant = top >> Format::SHIFT;
+            const uint64_t rest = (top & ((1ULL << Format::SHIFT) - 1)) | ((l << s) != 0);
+            const uint64_t exponent = (hi?127:63) - s;
+            return ((exponent + Format::BASE) << Format::POSITION) + mant +
+                   ((rest + (mant & 1) + (1ULL << (Format::SHIFT - 1)) - 1) >> Format::SHIFT);
+        }
+
+        template <typename Format>
+        static typename Format::type convert(const uint128_t & x){
+            typename Format::type out;
+            if (sizeof(out) == sizeof(uint64_t)){
+                const uint64_t bits = round_bits <Format> (x.upper(), x.lower());
+                std::memcpy(&out, &bits, sizeof(out));
+            }
+            else{
+                const uint32_t bits = static_cast <uint32_t> (round_bits <Format> (x.upper(), x.lower()));
+                std::memcpy(&out, &bits, sizeof(out));
+            }
+            return out;
+        }
+
+        // any other binary floating point type; exact when the value fits in its significand
+        template <typename T>
+        static T convert_generic(const uint128_t & x){
+            const unsigned digits = std::numeric_limits <T>::digits;
+            const T word = static_cast <T> (18446744073709551616.0);     // 2^64
+            if (x.bits() <= digits){
+                return static_cast <T> (x.upper()) * word + static_cast <T> (x.lower());
+            }
+            const unsigned shift = x.bits() - digits;
+            const uint128_t half = uint128_1 << (shift - 1);
+            const uint128_t rest = x & ((half << 1) - 1);
+            uint128_t mant = x >> shift;
+            if ((rest > half) || ((rest == half) && (mant.lower() & 1))){
+                mant += uint128_1;
+            }
+            return std::ldexp(static_cast <T> (mant.upper()) * word + static_cast <T> (mant.lower()), static_cast <int> (shift));
+        }
+
+        static void fail(const bool nan){
+            if (nan){
+                throw std::domain_error("Error: NaN has no uint128_t value");
+            }
+            throw std::overflow_error("Error: value is outside the range of uint128_t");
+        }
+
+        // (hi, lo) from the encoding of a double, saturated; bad is set when the value is out of range
+        static uint128_t from_bits(const uint64_t bits, bool & bad){
+            const uint64_t e = (bits >> 52) & 0x7ff;
+            const uint64_t fraction = bits & ((1ULL << 52) - 1);
+            const bool negative = bits >> 63;
+            const bool nan = (e == 0x7ff) && fraction;
+            bad = nan || ((e >= 1023) && negative) || (e >= 1023 + 128);
+            if (nan || negative || (e < 1023)){
+                return uint128_0;
+            }
+            if (e >= 1023 + 128){
+                return uint128_t(~0ULL, ~0ULL);
+            }
+            const uint64_t mant = fraction | (1ULL << 52);
+            if (e <= 1075){
+                return uint128_t(0, mant >> (1075 - e));
+            }
+            const unsigned s = static_cast <unsigned> (e - 1075);
+            return uint128_t((s < 64)?(mant >> (64 - s)):(mant << (s - 64)), (s < 64)?(mant << s):0);
+        }
+
+        template <typename T>
+        static uint128_t from_generic(const T x, const uint128_float_mode mode){
+            const T word = static_cast <T> (18446744073709551616.0);     // 2^64
+            if ((x != x) || (x <= static_cast <T> (-1)) || (x >= word * word)){
+                if (mode == UINT128_FLOAT_CHECKED){
+                    fail(x != x);
+                }
+                return (x >= word * word)?uint128_t(~0ULL, ~0ULL):uint128_0;
+            }
+            if (x < 1){
+                return uint128_0;
+            }
+            const T whole = std::trunc(x);
+            const T hi = std::floor(whole / word);
+            return uint128_t(static_cast <uint64_t> (hi), static_cast <uint64_t> (whole - hi * word));
+        }
+
+#if defined(_UINT128_FLOAT_AVX512)
+        template <typename Format>
+        _UINT128_T_TARGET_AVX512 static __m512i round_bits(const __m512i hi, const __m512i lo){
+            const __m512i zero = _mm512_setzero_si512();
+            const __mmask8 high = _mm512_test_epi64_mask(hi, hi);
+            const __m512i h = _mm512_mask_blend_epi64(high, lo, hi);
+            const __m512i l = _mm512_maskz_mov_epi64(high, lo);
+            const __m512i s = _mm512_lzcnt_epi64(h);
+            const __m512i top = _mm512_or_si512(_mm512_sllv_epi64(h, s), _mm512_srlv_epi64(l, _mm512_sub_epi64(_mm512_set1_epi64(64), s)));
+            const __m512i below = _mm512_sllv_epi64(l, s);
+            const __mmask8 sticky = _mm512_test_epi64_mask(below, below);
+            const __m512i mant = _mm512_srli_epi64(top, Format::SHIFT);
+            const __m512i fraction = _mm512_and_si512(top, _mm512_set1_epi64((1ULL << Format::SHIFT) - 1));
+            const __m512i rest = _mm512_mask_or_epi64(fraction, sticky, fraction, _mm512_set1_epi64(1));
+            const __m512i up = _mm512_srli_epi64(_mm512_add_epi64(_mm512_add_epi64(rest, _mm512_and_si512(mant, _mm512_set1_epi64(1))),
+                                                                  _mm512_set1_epi64((1ULL << (Format::SHIFT - 1)) - 1)), Format::SHIFT);
+            const __m512i exponent = _mm512_sub_epi64(_mm512_set1_epi64(63 + Format::BASE), s);
+            const __m512i biased = _mm512_mask_add_epi64(exponent, high, exponent, _mm512_set1_epi64(64));
+            const __m512i bits = _mm512_add_epi64(_mm512_add_epi64(_mm512_slli_epi64(biased, Format::POSITION), mant), up);
+            return _mm512_mask_mov_epi64(zero, _mm512_test_epi64_mask(h, h), bits);
+        }
+
+        // halves of in[0, 8)
+        _UINT128_T_TARGET_AVX512 static void load(const uint128_t * in, __m512i & hi, __m512i & lo){
+            const __m512i a = _mm512_loadu_si512(in);
+            const __m512i b = _mm512_loadu_si512(in + 4);
+            lo = _mm512_permutex2var_epi64(a, _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14), b);
+            hi = _mm512_permutex2var_epi64(a, _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15), b);
+        }
+#endif
+
+#if defined(_UINT128_FLOAT_AVX2)
+        // index of the top bit of each lane of x, from the exponents of its 32-bit halves as doubles
+        _UINT128_T_TARGET_AVX2 static __m256i top_bit(const __m256i x){
+            const __m256i magic = _mm256_set1_epi64x(0x4330000000000000LL);      // 2^52
+            const __m256i bias = _mm256_set1_epi64x(1023);
+            const __m256i upper = _mm256_srli_epi64(x, 32);
+            const __m256i lower = _mm256_and_si256(x, _mm256_set1_epi64x(0xffffffffLL));
+            const __m256d u = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(upper, magic)), _mm256_castsi256_pd(magic));
+            const __m256d l = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(lower, magic)), _mm256_castsi256_pd(magic));
+            const __m256i eu = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(u), 52), _mm256_set1_epi64x(1023 - 32));
+            const __m256i el = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(l), 52), bias);
+            return _mm256_blendv_epi8(eu, el, _mm256_cmpeq_epi64(upper, _mm256_setzero_si256()));
+        }
+
+        template <typename Format>
+        _UINT128_T_TARGET_AVX2 static __m256i round_bits(const __m256i hi, const __m256i lo){
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i one = _mm256_set1_epi64x(1);
+            const __m256i low = _mm256_cmpeq_epi64(hi, zero);
+            const __m256i h = _mm256_blendv_epi8(hi, lo, low);
+            const __m256i l = _mm256_andnot_si256(low, lo);
+            const __m256i s = _mm256_sub_epi64(_mm256_set1_epi64x(63), top_bit(h));
+            const __m256i top = _mm256_or_si256(_mm256_sllv_epi64(h, s), _mm256_srlv_epi64(l, _mm256_sub_epi64(_mm256_set1_epi64x(64), s)));
+            const __m256i sticky = _mm256_andnot_si256(_mm256_cmpeq_epi64(_mm256_sllv_epi64(l, s), zero), one);
+            const __m256i mant = _mm256_srli_epi64(top, Format::SHIFT);
+            const __m256i rest = _mm256_or_si256(_mm256_and_si256(top, _mm256_set1_epi64x((1ULL << Format::SHIFT) - 1)), sticky);
+            const __m256i up = _mm256_srli_epi64(_mm256_add_epi64(_mm256_add_epi64(rest, _mm256_and_si256(mant, one)),
+                                                                  _mm256_set1_epi64x((1ULL << (Format::SHIFT - 1)) - 1)), Format::SHIFT);
+            const __m256i exponent = _mm256_add_epi64(_mm256_sub_epi64(_mm256_set1_epi64x(63 + Format::BASE), s),
+                                                      _mm256_andnot_si256(low, _mm256_set1_epi64x(64)));
+            const __m256i bits = _mm256_add_epi64(_mm256_add_epi64(_mm256_slli_epi64(exponent, Format::POSITION), mant), up);
+            return _mm256_andnot_si256(_mm256_cmpeq_epi64(h, zero), bits);
+        }
+
+        // halves of in[0, 4), in the lane order 0, 2, 1, 3
+        _UINT128_T_TARGET_AVX2 static void load(const uint128_t * in, __m256i & hi, __m256i & lo){
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast <const __m256i *> (in));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast <const __m256i *> (in + 2));
+            lo = _mm256_unpacklo_epi64(a, b);
+            hi = _mm256_unpackhi_epi64(a, b);
+        }
+#endif
+
+        // The vector loops return the index they stopped at, for the next loop to continue from.
+#if defined(_UINT128_FLOAT_AVX512)
+        _UINT128_T_TARGET_AVX512 static std::size_t to_double_avx512(const uint128_t * in, double * out, const std::size_t count, std::size_t i){
+            for(; i + 8 <= count; i += 8){
+                __m512i hi, lo;
+                load(in + i, hi, lo);
+                _mm512_storeu_si512(out + i, round_bits <double_format> (hi, lo));
+            }
+            return i;
+        }
+
+        _UINT128_T_TARGET_AVX512 static std::size_t to_float_avx512(const uint128_t * in, float * out, const std::size_t count, std::size_t i){
+            for(; i + 8 <= count; i += 8){
+                __m512i hi, lo;
+                load(in + i, hi, lo);
+                _mm256_storeu_si256(reinterpret_cast <__m256i *> (out + i), _mm512_cvtepi64_epi32(round_bits <single_format> (hi, lo)));
+            }
+            return i;
+        }
+#endif
+
+#if defined(_UINT128_FLOAT_AVX2)
+        _UINT128_T_TARGET_AVX2 static std::size_t to_double_avx2(const uint128_t * in, double * out, const std::size_t count, std::size_t i){
+            for(; i + 4 <= count; i += 4){
+                __m256i hi, lo;
+                load(in + i, hi, lo);
+                const __m256i bits = round_bits <double_format> (hi, lo);
+                _mm256_storeu_si256(reinterpret_cast <__m256i *> (out + i), _mm256_permute4x64_epi64(bits, _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+            return i;
+        }
+
+        _UINT128_T_TARGET_AVX2 static std::size_t to_float_avx2(const uint128_t * in, float * out, const std::size_t count, std::size_t i){
+            for(; i + 4 <= count; i += 4){
+                __m256i hi, lo;
+                load(in + i, hi, lo);
+                const __m256i bits = _mm256_permutevar8x32_epi32(round_bits <single_format> (hi, lo), _mm256_setr_epi32(0, 4, 2, 6, 1, 3, 5, 7));
+                _mm_storeu_si128(reinterpret_cast <__m128i *> (out + i), _mm256_castsi256_si128(bits));
+            }
+            return i;
+        }
+
+        _UINT128_T_TARGET_AVX2 static std::size_t from_double_avx2(const double * in, uint128_t * out, const std::size_t count, std::size_t i, bool & failed){
+            const __m256i zero = _mm256_setzero_si256();
+            for(; i + 4 <= count; i += 4){
+                const __m256i bits = _mm256_loadu_si256(reinterpret_cast <const __m256i *> (in + i));
+                const __m256i e = _mm256_and_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x(0x7ff));
+                const __m256i fraction = _mm256_and_si256(bits, _mm256_set1_epi64x((1LL << 52) - 1));
+                const __m256i mant = _mm256_or_si256(fraction, _mm256_set1_epi64x(1LL << 52));
+
+                // value = mant * 2^s; shift counts outside [0, 64) give 0
+                const __m256i s = _mm256_sub_epi64(e, _mm256_set1_epi64x(1075));
+                const __m256i lo = _mm256_or_si256(_mm256_sllv_epi64(mant, s), _mm256_srlv_epi64(mant, _mm256_sub_epi64(zero, s)));
+                const __m256i hi = _mm256_or_si256(_mm256_srlv_epi64(mant, _mm256_sub_epi64(_mm256_set1_epi64x(64), s)),
+                                                   _mm256_sllv_epi64(mant, _mm256_sub_epi64(s, _mm256_set1_epi64x(64))));
+
+                const __m256i negative = _mm256_cmpgt_epi64(zero, bits);
+                const __m256i nan = _mm256_andnot_si256(_mm256_cmpeq_epi64(fraction, zero), _mm256_cmpeq_epi64(e, _mm256_set1_epi64x(0x7ff)));
+                const __m256i large = _mm256_cmpgt_epi64(e, _mm256_set1_epi64x(1022 + 128));
+                const __m256i whole = _mm256_cmpgt_epi64(e, _mm256_set1_epi64x(1022));
+                const __m256i clear = _mm256_or_si256(negative, nan);
+                const __m256i ones = large;
+                failed |= !_mm256_testz_si256(_mm256_or_si256(_mm256_and_si256(negative, whole), _mm256_or_si256(nan, large)),
+                                              _mm256_set1_epi64x(-1));
+
+                const __m256i l = _mm256_andnot_si256(clear, _mm256_or_si256(lo, ones));
+                const __m256i u = _mm256_andnot_si256(clear, _mm256_or_si256(hi, ones));
+                const __m256i a = _mm256_unpacklo_epi64(l, u);     // elements 0 and 2
+                const __m256i b = _mm256_unpackhi_epi64(l, u);     // elements 1 and 3
+                _mm256_storeu_si256(reinterpret_cast <__m256i *> (out + i), _mm256_permute2x128_si256(a, b, 0x20));
+                _mm256_storeu_si256(reinterpret_cast <__m256i *> (out + i + 2), _mm256_permute2x128_si256(a, b, 0x31));
+            }
+            return i;
+        }
+#endif
+
+        static void to_double(const uint128_t * in, double * out, const std::size_t count){
+            std::size_t i = 0;
+#if defined(_UINT128_FLOAT_AVX512)
+            if (uint128_dispatch_has(UINT128_CPU_AVX512)){
+                i = to_double_avx512(in, out, count, i);
+            }
+#endif
+#if defined(_UINT128_FLOAT_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = to_double_avx2(in, out, count, i);
+            }
+#endif
+            for(; i < count; i++){
+                out[i] = convert <double_format> (in[i]);
+            }
+        }
+
+        static void to_float(const uint128_t * in, float * out, const std::size_t count){
+            std::size_t i = 0;
+#if defined(_UINT128_FLOAT_AVX512)
+            if (uint128_dispatch_has(UINT128_CPU_AVX512)){
+                i = to_float_avx512(in, out, count, i);
+            }
+#endif
+#if defined(_UINT128_FLOAT_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = to_float_avx2(in, out, count, i);
+            }
+#endif
+            for(; i < count; i++){
+                out[i] = convert <single_format> (in[i]);
+            }
+        }
+
+        // returns whether any element was out of range
+        static bool from_double(const double * in, uint128_t * out, const std::size_t count){
+            bool failed = false;
+            std::size_t i = 0;
+#if defined(_UINT128_FLOAT_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = from_double_avx2(in, out, count, i, failed);
+            }
+#endif
+            for(; i < count; i++){
+                uint64_t bits;
+                std::memcpy(&bits, in + i, sizeof(bits));
+                bool bad;
+                out[i] = from_bits(bits, bad);
+                failed |= bad;
+            }
+            return failed;
+        }
+};
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(_UINT128_FLOAT_AVX512)
+#pragma GCC diagnostic pop
+#endif
+
+inline float to_float(const uint128_t & x){
+    return uint128_float::convert <uint128_float::single_format> (x);
+}
+
+inline double to_double(const uint128_t & x){
+    return uint128_float::convert <uint128_float::double_format> (x);
+}
+
+inline long double to_long_double(const uint128_t & x){
+    if (std::numeric_limits <long double>::digits == std::numeric_limits <double>::digits){
+        return to_double(x);
+    }
+    return uint128_float::convert_generic <long double> (x);
+}
+
+inline uint128_t from_double(const double x, const uint128_float_mode mode = UINT128_FLOAT_CHECKED){
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bool bad;
+    const uint128_t out = uint128_float::from_bits(bits, bad);
+    if (bad && (mode == UINT128_FLOAT_CHECKED)){
+        uint128_float::fail(x != x);
+    }
+    return out;
+}
+
+inline uint128_t from_long_double(const long double x, const uint128_float_mode mode = UINT128_FLOAT_CHECKED){
+    return uint128_float::from_generic(x, mode);
+}
+
+// out[i] = to_float(in[i])
+inline void to_float(const uint128_t * in, float * out, const std::size_t count){
+    uint128_float::to_float(in, out, count);
+}
+
+// out[i] = to_double(in[i])
+inline void to_double(const uint128_t * in, double * out, const std::size_t count){
+    uint128_float::to_double(in, out, count);
+}
+
+// out[i] = from_double(in[i], mode); in checked mode every element is written before throwing
+inline void from_double(const double * in, uint128_t * out, const std::size_t count, const uint128_float_mode mode = UINT128_FLOAT_CHECKED){
+    if (uint128_float::from_double(in, out, count) && (mode == UINT128_FLOAT_CHECKED)){
+        for(std::size_t i = 0; i < count; i++){
+            from_double(in[i]);
+        }
+    }
+}
+
+#endif
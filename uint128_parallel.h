@@ -0,0 +1,46 @@
+/*
+uint128_parallel.h
+Minimal fork/join helper shared by the multithreaded uint128_t kernels
+*/
+
+#ifndef __UINT128_PARALLEL__
+#define __UINT128_PARALLEL__
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// 0 threads means one per hardware thread
+inline unsigned uint128_parallel_threads(const unsigned threads, const std::size_t count){
+    unsigned out = threads?threads:std::thread::hardware_concurrency();
+    if (!out){
+        out = 1;
+    }
+    if (count < out){
+        out = count?static_cast <unsigned> (count):1;
+    }
+    return out;
+}
+
+// start of chunk t when [0, count) is split into threads nearly equal contiguous chunks
+inline std::size_t uint128_parallel_chunk(const std::size_t count, const unsigned threads, const unsigned t){
+    return (count / threads) * t + std::min <std::size_t> (t, count % threads);
+}
+
+// Calls f(t, begin, end) for each chunk t in [0, threads) and waits for all of them.
+// The calling thread runs chunk 0. threads must already be resolved with uint128_parallel_threads.
+template <typename F>
+void uint128_parallel_for(const std::size_t count, const unsigned threads, F f){
+    std::vector <std::thread> workers;
+    workers.reserve(threads - 1);
+    for(unsigned t = 1; t < threads; t++){
+        workers.emplace_back(f, t, uint128_parallel_chunk(count, threads, t), uint128_parallel_chunk(count, threads, t + 1));
+    }
+    f(0U, uint128_parallel_chunk(count, threads, 0), uint128_parallel_chunk(count, threads, 1));
+    for(std::thread & worker : workers){
+        worker.join();
+    }
+}
+
+#endif
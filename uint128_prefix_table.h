@@ -0,0 +1,251 @@
+/*
+uint128_prefix_table.h
+Longest prefix match over uint128_t keys (IPv6 routing)
+
+A multibit trie: the root is a table indexed by the top 16 bits of the address, and every
+level below it is a node of 256 entries indexed by the next 8 bits. A prefix is stored at
+the level where it ends, expanded to every entry it covers there (a /20 fills 16 entries of
+a level 1 node), and each entry keeps the longest prefix that covers it. A lookup reads one
+entry per level and remembers the last value it passed, so a /48 takes at most 5 reads
+no matter how many prefixes there are.
+
+Paths are compressed: when only one prefix lies below an entry, the entry points to that
+prefix as a leaf, which a lookup compares in full instead of walking the levels down to it.
+The leaf moves one level down when a second prefix needs the same path, so a sparse table
+does not allocate a chain of mostly empty nodes for every long prefix.
+
+Bits past a prefix's length are ignored. Inserting a prefix that is already present replaces
+its value. Pointers returned by lookup are invalidated by the next insert.
+*/
+
+#ifndef __UINT128_PREFIX_TABLE__
+#define __UINT128_PREFIX_TABLE__
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "uint128_t.h"
+
+// the top len bits set
+inline uint128_t uint128_prefix_mask(const unsigned len){
+    return ~uint128_0 << (128 - len);
+}
+
+template <typename V>
+class uint128_prefix_table{
+    public:
+        uint128_prefix_table()
+            : root(ROOT_SIZE), root_len(ROOT_SIZE, 0), nodes(NODE_SIZE), node_len(NODE_SIZE, 0)      // node 0 is never used
+        {}
+
+        std::size_t size() const{
+            return values.size();
+        }
+
+        // the value of the longest prefix that contains addr, or nullptr if there is none
+        const V * lookup(const uint128_t & addr) const{
+            const entry * e = &root[addr.upper() >> 48];
+            uint32_t result = e -> result;
+            uint32_t child = e -> child;
+            for(unsigned byte = 2; child; byte++){
+                if (child & LEAF){
+                    result = leaves[child & ~LEAF].match(addr)?leaves[child & ~LEAF].result:result;
+                    break;
+                }
+                e = &nodes[child * NODE_SIZE + byte_at(addr, byte)];
+                result = e -> result?e -> result:result;
+                child = e -> child;
+            }
+            return result?&values[result - 1]:nullptr;
+        }
+
+        // lookup for count addresses at once; BATCH walks are interleaved so their cache misses overlap
+        void lookup(const uint128_t * addrs, const std::size_t count, const V ** out) const{
+            for(std::size_t i = 0; i < count; i += BATCH){
+                const std::size_t m = (count - i < BATCH)?(count - i):BATCH;
+                uint32_t child[BATCH];
+                uint32_t result[BATCH];
+
+                for(std::size_t j = 0; j < m; j++){
+                    _UINT128_T_PREFETCH(&root[addrs[i + j].upper() >> 48]);
+                }
+                bool active = false;
+                for(std::size_t j = 0; j < m; j++){
+                    const entry & e = root[addrs[i + j].upper() >> 48];
+                    result[j] = e.result;
+                    child[j] = e.child;
+                    prefetch(child[j], addrs[i + j], 2);
+                    active |= child[j] != 0;
+                }
+
+                for(unsigned byte = 2; active; byte++){
+                    active = false;
+                    for(std::size_t j = 0; j < m; j++){
+                        if (child[j] & LEAF){
+                            const leaf & l = leaves[child[j] & ~LEAF];
+                            result[j] = l.match(addrs[i + j])?l.result:result[j];
+                            child[j] = 0;
+                        }
+                        else if (child[j]){
+                            const entry & e = nodes[child[j] * NODE_SIZE + byte_at(addrs[i + j], byte)];
+                            result[j] = e.result?e.result:result[j];
+                            child[j] = e.child;
+                            prefetch(child[j], addrs[i + j], byte + 1);
+                            active |= child[j] != 0;
+                        }
+                    }
+                }
+
+                for(std::size_t j = 0; j < m; j++){
+                    out[i + j] = result[j]?&values[result[j] - 1]:nullptr;
+                }
+            }
+        }
+
+        bool contains(const uint128_t & addr) const{
+            return lookup(addr) != nullptr;
+        }
+
+        void insert(const uint128_t & prefix, const unsigned len, const V & value){
+            if (len > 128){
+                throw std::invalid_argument("Error: prefix length is greater than 128");
+            }
+            const uint128_t masked = prefix & uint128_prefix_mask(len);
+
+            // the same prefix is already present: replace its value. Looking at the entries is not
+            // enough, as longer prefixes may have taken over every entry it covers.
+            const auto known = present.insert(std::make_pair(std::make_pair(masked, len), static_cast <uint32_t> (values.size() + 1)));
+            if (!known.second){
+                values[known.first -> second - 1] = value;
+                return;
+            }
+            const unsigned level = level_of(len);
+
+            // walk down to the node of that level
+            bool at_root = true;
+            std::size_t index = masked.upper() >> 48;
+            for(unsigned l = 0; l < level; l++){
+                uint32_t child = (at_root?root[index]:nodes[index]).child;
+
+                // nothing below this entry yet: keep the prefix as a leaf
+                if (!child){
+                    values.push_back(value);
+                    leaves.push_back(leaf(masked, len, static_cast <uint32_t> (values.size())));
+                    (at_root?root[index]:nodes[index]).child = LEAF | static_cast <uint32_t> (leaves.size() - 1);
+                    return;
+                }
+
+                // a leaf is in the way: move it one level down into a new node
+                if (child & LEAF){
+                    const leaf old = leaves[child & ~LEAF];
+                    const uint32_t node = static_cast <uint32_t> (nodes.size() / NODE_SIZE);
+                    nodes.resize(nodes.size() + NODE_SIZE);
+                    node_len.resize(node_len.size() + NODE_SIZE, 0);
+                    (at_root?root[index]:nodes[index]).child = node;
+
+                    const std::size_t to = node * NODE_SIZE + byte_at(uint128_t(old.upper, old.lower), l + 2);
+                    if (level_of(old.len) == l + 1){
+                        fill(nodes.data(), node_len.data(), to, old.len, old.result);
+                    }
+                    else{
+                        nodes[to].child = child;
+                    }
+                    child = node;
+                }
+
+                at_root = false;
+                index = child * NODE_SIZE + byte_at(masked, l + 2);
+            }
+            entry * table = at_root?root.data():nodes.data();
+            uint8_t * lengths = at_root?root_len.data():node_len.data();
+            values.push_back(value);
+            fill(table, lengths, index, len, static_cast <uint32_t> (values.size()));
+        }
+
+        // bulk insert
+        void insert(const uint128_t * prefixes, const unsigned * lens, const V * vals, const std::size_t count){
+            values.reserve(values.size() + count);
+            for(std::size_t i = 0; i < count; i++){
+                insert(prefixes[i], lens[i], vals[i]);
+            }
+        }
+
+        void clear(){
+            *this = uint128_prefix_table();
+        }
+
+    private:
+        static const unsigned ROOT_BITS = 16;
+        static const unsigned NODE_BITS = 8;
+        static const std::size_t ROOT_SIZE = static_cast <std::size_t> (1) << ROOT_BITS;
+        static const std::size_t NODE_SIZE = static_cast <std::size_t> (1) << NODE_BITS;
+        static const std::size_t BATCH = 16;
+        static const uint32_t LEAF = 0x80000000;
+
+        struct entry{
+            uint32_t child;     // node of the next level, LEAF | leaf index, or 0 if there is neither
+            uint32_t result;    // 1 + index into values of the longest prefix covering this entry, 0 if there is none
+        };
+
+        // the only prefix below an entry, compared in full instead of walking the levels to it
+        struct leaf{
+            uint64_t upper, lower;
+            uint64_t mask_upper, mask_lower;
+            uint32_t len;
+            uint32_t result;
+
+            leaf(const uint128_t & prefix, const unsigned length, const uint32_t r)
+                : upper(prefix.upper()), lower(prefix.lower()),
+                  mask_upper(uint128_prefix_mask(length).upper()), mask_lower(uint128_prefix_mask(length).lower()),
+                  len(length), result(r)
+            {}
+
+            bool match(const uint128_t & addr) const{
+                return ((addr.upper() & mask_upper) == upper) & ((addr.lower() & mask_lower) == lower);
+            }
+        };
+
+        std::vector <entry> root;
+        std::vector <uint8_t> root_len;     // prefix length of each result, only needed while inserting
+        std::vector <entry> nodes;
+        std::vector <uint8_t> node_len;
+        std::vector <leaf> leaves;
+        std::vector <V> values;
+        std::map <std::pair <uint128_t, unsigned>, uint32_t> present;     // (prefix, length) -> result, only needed while inserting
+
+        // level 0 is the root, level k > 0 ends at bit 16 + 8k
+        static unsigned level_of(const unsigned len){
+            return (len <= ROOT_BITS)?0:(1 + (len - ROOT_BITS - 1) / NODE_BITS);
+        }
+
+        // byte i of addr, counting from the most significant
+        static unsigned byte_at(const uint128_t & addr, const unsigned i){
+            return static_cast <unsigned> (((i < 8)?(addr.upper() >> (56 - 8 * i)):(addr.lower() >> (56 - 8 * (i & 7)))) & 0xff);
+        }
+
+        // store a prefix in every entry of its level that it covers, unless a longer one is there
+        static void fill(entry * table, uint8_t * lengths, const std::size_t index, const unsigned len, const uint32_t result){
+            const std::size_t span = static_cast <std::size_t> (1) << (ROOT_BITS + NODE_BITS * level_of(len) - len);
+            for(std::size_t i = index; i < index + span; i++){
+                if (!table[i].result || (lengths[i] <= len)){
+                    table[i].result = result;
+                    lengths[i] = static_cast <uint8_t> (len);
+                }
+            }
+        }
+
+        void prefetch(const uint32_t child, const uint128_t & addr, const unsigned byte) const{
+            if (child & LEAF){
+                _UINT128_T_PREFETCH(&leaves[child & ~LEAF]);
+            }
+            else{
+                _UINT128_T_PREFETCH(&nodes[child * NODE_SIZE + byte_at(addr, byte)]);
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,622 @@
+#include "uint128_t.build"
+#include "uint128_prime.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "uint128_parallel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// below this many values per thread, extra threads cost more than they save
+static const std::size_t MIN_PER_THREAD = 64;
+
+// 3317044064679887385961981, the smallest strong pseudoprime to all of the primes 2 to 41
+static const uint128_t PSI_13(0x2be69ULL, 0x51adc5b22410a5fdULL);
+
+// differences multiplied together between gcds in Pollard-Brent
+static const uint64_t RHO_BATCH = 128;
+
+// x must not be 0
+static unsigned trailing_zeros(const uint64_t x){
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return index;
+#else
+    unsigned index = 0;
+    while (!((x >> index) & 1)){
+        index++;
+    }
+    return index;
+#endif
+}
+
+static unsigned trailing_zeros(const uint128_t & x){
+    return x.lower()?trailing_zeros(x.lower()):(64 + trailing_zeros(x.upper()));
+}
+
+// The helpers below work on the halves so that they inline; the uint128_t operators do not.
+
+static bool is_zero(const uint128_t & x){
+    return !(x.upper() | x.lower());
+}
+
+static bool is_one(const uint128_t & x){
+    return !x.upper() && (x.lower() == 1);
+}
+
+static bool same(const uint128_t & lhs, const uint128_t & rhs){
+    return (lhs.upper() == rhs.upper()) && (lhs.lower() == rhs.lower());
+}
+
+static bool less(const uint128_t & lhs, const uint128_t & rhs){
+    return (lhs.upper() < rhs.upper()) || ((lhs.upper() == rhs.upper()) && (lhs.lower() < rhs.lower()));
+}
+
+static uint128_t subtract(const uint128_t & lhs, const uint128_t & rhs){
+    return uint128_t(lhs.upper() - rhs.upper() - (lhs.lower() < rhs.lower()), lhs.lower() - rhs.lower());
+}
+
+// shift < 128
+static uint128_t shift_right(const uint128_t & x, const unsigned shift){
+    if (shift >= 64){
+        return uint128_t(0, x.upper() >> (shift - 64));
+    }
+    if (!shift){
+        return x;
+    }
+    return uint128_t(x.upper() >> shift, (x.lower() >> shift) | (x.upper() << (64 - shift)));
+}
+
+static bool bit(const uint128_t & x, const unsigned i){
+    return ((i < 64)?(x.lower() >> i):(x.upper() >> (i - 64))) & 1;
+}
+
+// low 128 bits of lhs * rhs
+static uint128_t multiply_low(const uint128_t & lhs, const uint128_t & rhs){
+    uint64_t high;
+    const uint64_t low = uint128_t::multlong64(lhs.lower(), rhs.lower(), &high);
+    return uint128_t(high + lhs.lower() * rhs.upper() + lhs.upper() * rhs.lower(), low);
+}
+
+// inverse of an odd x modulo 2^64, by Newton's iteration: x is its own inverse modulo 8,
+// and each step doubles the number of correct bits
+static uint64_t inverse(const uint64_t x){
+    uint64_t out = x;
+    for(unsigned i = 0; i < 5; i++){
+        out *= 2 - x * out;
+    }
+    return out;
+}
+
+// inverse of an odd x modulo 2^128
+static uint128_t inverse(const uint128_t & x){
+    const uint128_t out(0, inverse(x.lower()));
+    return multiply_low(out, subtract(uint128_t(2), multiply_low(x, out)));
+}
+
+// x mod d for d < 2^32, one 32-bit digit at a time
+static uint64_t mod_small(const uint128_t & x, const uint64_t d){
+    uint64_t out = 0;
+    for(unsigned shift = 128; shift;){
+        shift -= 32;
+        out = ((out << 32) | static_cast <uint32_t> (shift_right(x, shift).lower())) % d;
+    }
+    return out;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b){
+    if (!a || !b){
+        return a | b;
+    }
+    const unsigned shift = trailing_zeros(a | b);
+    a >>= trailing_zeros(a);
+    while (b){
+        b >>= trailing_zeros(b);
+        if (a > b){
+            std::swap(a, b);
+        }
+        b -= a;
+    }
+    return a << shift;
+}
+
+// binary gcd; b must be odd
+static uint128_t gcd(uint128_t a, uint128_t b){
+    if (is_zero(a)){
+        return b;
+    }
+    a = shift_right(a, trailing_zeros(a));
+    while (a.upper() || b.upper()){
+        // both odd
+        if (less(b, a)){
+            std::swap(a, b);
+        }
+        b = subtract(b, a);
+        if (is_zero(b)){
+            return a;
+        }
+        b = shift_right(b, trailing_zeros(b));
+    }
+    return uint128_t(0, gcd(a.lower(), b.lower()));
+}
+
+// Montgomery arithmetic modulo an odd n < 2^64 with R = 2^64
+class montgomery64{
+    public:
+        typedef uint64_t value;
+
+        explicit montgomery64(const uint64_t modulus)
+            : n(modulus), n_inverse(inverse(modulus)), one((0 - modulus) % modulus), minus_one(modulus - one), r2(one)
+        {
+            // R * 2^64 = R^2
+            for(unsigned i = 0; i < 64; i++){
+                r2 = add(r2, r2);
+            }
+        }
+
+        const uint64_t n;
+        const uint64_t n_inverse;
+        const value one;
+        const value minus_one;
+
+        // x < n to Montgomery form
+        value from(const uint64_t x) const{
+            return multiply(x, r2);
+        }
+
+        value multiply(const value a, const value b) const{
+            uint64_t high;
+            const uint64_t low = uint128_t::multlong64(a, b, &high);
+            return reduce(high, low);
+        }
+
+        value add(const value a, const value b) const{
+            const uint64_t sum = a + b;
+            return ((sum < a) || (sum >= n))?(sum - n):sum;
+        }
+
+        value sub(const value a, const value b) const{
+            return a - b + ((a < b)?n:0);
+        }
+
+        static bool equal(const value a, const value b){
+            return a == b;
+        }
+
+        // gcd(a, n) of a in Montgomery form, which is the same as for a itself
+        uint128_t gcd(const value a) const{
+            return uint128_t(0, ::gcd(a, n));
+        }
+
+    private:
+        value r2;
+
+        // (high * 2^64 + low) / R mod n, for high < n
+        value reduce(const uint64_t high, const uint64_t low) const{
+            uint64_t mh;
+            uint128_t::multlong64(low * n_inverse, n, &mh);
+            return high - mh + ((high < mh)?n:0);
+        }
+};
+
+// Montgomery arithmetic modulo an odd n < 2^128 with R = 2^128
+class montgomery128{
+    public:
+        typedef uint128_t value;
+
+        explicit montgomery128(const uint128_t & modulus)
+            : n(modulus), n_inverse(inverse(modulus)), one((-modulus) % modulus), minus_one(subtract(modulus, one)),
+              n_half((modulus >> 1) + 1), r2(one)
+        {
+            for(unsigned i = 0; i < 128; i++){
+                r2 = add(r2, r2);
+            }
+        }
+
+        const uint128_t n;
+        const uint128_t n_inverse;
+        const value one;
+        const value minus_one;
+
+        value from(const uint128_t & x) const{
+            return multiply(x, r2);
+        }
+
+        value multiply(const value & a, const value & b) const{
+            uint128_t high;
+            const uint128_t low = uint128_t::mul_wide(a, b, &high);
+            return reduce(high, low);
+        }
+
+        value add(const value & a, const value & b) const{
+            const uint64_t low = a.lower() + b.lower();
+            const uint64_t carry = low < a.lower();
+            const uint64_t partial = a.upper() + b.upper();
+            const uint64_t high = partial + carry;
+            const uint128_t sum(high, low);
+            return ((partial < a.upper()) || (high < carry) || !less(sum, n))?subtract(sum, n):sum;
+        }
+
+        value sub(const value & a, const value & b) const{
+            const uint128_t out = subtract(a, b);
+            if (less(a, b)){
+                const uint64_t low = out.lower() + n.lower();
+                return uint128_t(out.upper() + n.upper() + (low < n.lower()), low);
+            }
+            return out;
+        }
+
+        value half(const value & a) const{
+            const uint128_t out = shift_right(a, 1);
+            if (!(a.lower() & 1)){
+                return out;
+            }
+            // (a + n) / 2 = a / 2 + (n + 1) / 2 for odd a, without the carry out of a + n
+            const uint64_t low = out.lower() + n_half.lower();
+            return uint128_t(out.upper() + n_half.upper() + (low < out.lower()), low);
+        }
+
+        static bool equal(const value & a, const value & b){
+            return same(a, b);
+        }
+
+        uint128_t gcd(const value & a) const{
+            return ::gcd(a, n);
+        }
+
+    private:
+        // (n + 1) / 2
+        const uint128_t n_half;
+        value r2;
+
+        value reduce(const uint128_t & high, const uint128_t & low) const{
+            uint128_t mh;
+            uint128_t::mul_wide(multiply_low(low, n_inverse), n, &mh);
+            const uint128_t out = subtract(high, mh);
+            if (less(high, mh)){
+                const uint64_t sum = out.lower() + n.lower();
+                return uint128_t(out.upper() + n.upper() + (sum < n.lower()), sum);
+            }
+            return out;
+        }
+};
+
+// odd primes below 1024 with the constants of the division-free divisibility test
+struct trial_table{
+    static const unsigned LIMIT = 1024;
+
+    std::vector <uint64_t> prime;
+    std::vector <uint128_t> inverse;
+    std::vector <uint128_t> max_quotient;
+    std::size_t below_256;
+
+    trial_table()
+        : below_256(0)
+    {
+        std::vector <bool> composite(LIMIT);
+        for(uint64_t p = 3; p < LIMIT; p += 2){
+            if (composite[p]){
+                continue;
+            }
+            for(uint64_t m = p * p; m < LIMIT; m += 2 * p){
+                composite[m] = true;
+            }
+            prime.push_back(p);
+            inverse.push_back(::inverse(uint128_t(0, p)));
+            max_quotient.push_back(uint128_t(~0ULL, ~0ULL) / uint128_t(0, p));
+            below_256 += p < 256;
+        }
+    }
+
+    // n * p^-1 mod 2^128 is n / p when p divides n, and larger than any such quotient otherwise
+    bool divides(const std::size_t i, const uint128_t & n) const{
+        return !less(max_quotient[i], multiply_low(n, inverse[i]));
+    }
+};
+
+static const trial_table TRIAL;
+
+// base^e in Montgomery form
+template <typename M>
+static typename M::value power(const M & m, const typename M::value & base, const uint128_t & e){
+    typename M::value out = m.one;
+    for(unsigned i = e.bits(); i;){
+        i--;
+        out = m.multiply(out, out);
+        if (bit(e, i)){
+            out = m.multiply(out, base);
+        }
+    }
+    return out;
+}
+
+// strong probable prime test to base, with n - 1 = d * 2^s and d odd
+template <typename M>
+static bool strong_probable_prime(const M & m, const typename M::value & base, const uint128_t & d, const unsigned s){
+    typename M::value x = power(m, base, d);
+    if (M::equal(x, m.one) || M::equal(x, m.minus_one)){
+        return true;
+    }
+    for(unsigned r = 1; r < s; r++){
+        x = m.multiply(x, x);
+        if (M::equal(x, m.minus_one)){
+            return true;
+        }
+        if (M::equal(x, m.one)){
+            return false;
+        }
+    }
+    return false;
+}
+
+static bool miller_rabin(const uint64_t n){
+    // Jaeschke's bases are enough below 4759123141
+    static const uint64_t BASES_32[] = {2, 7, 61};
+    static const uint64_t BASES_64[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    const montgomery64 m(n);
+    const unsigned s = trailing_zeros(n - 1);
+    const uint128_t d(0, (n - 1) >> s);
+    const bool small = n < (1ULL << 32);
+    const uint64_t * bases = small?BASES_32:BASES_64;
+    const std::size_t count = small?(sizeof(BASES_32) / sizeof(uint64_t)):(sizeof(BASES_64) / sizeof(uint64_t));
+    for(std::size_t i = 0; i < count; i++){
+        const uint64_t a = (bases[i] < n)?bases[i]:(bases[i] % n);
+        if (a && !strong_probable_prime(m, m.from(a), d, s)){
+            return false;
+        }
+    }
+    return true;
+}
+
+// n < PSI_13
+static bool miller_rabin(const uint128_t & n){
+    static const uint64_t BASES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41};
+    const montgomery128 m(n);
+    const uint128_t n_1 = subtract(n, uint128_t(1));
+    const unsigned s = trailing_zeros(n_1);
+    const uint128_t d = shift_right(n_1, s);
+    for(const uint64_t base : BASES){
+        if (!strong_probable_prime(m, m.from(uint128_t(base)), d, s)){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Jacobi symbol (a / n) for odd n and odd |a| < 2^32
+static int jacobi(const int64_t a, const uint128_t & n){
+    int out = 1;
+    uint64_t top = (a < 0)?(0 - static_cast <uint64_t> (a)):static_cast <uint64_t> (a);
+    // (-1 / n)
+    if ((a < 0) && ((n.lower() & 3) == 3)){
+        out = -out;
+    }
+    // reciprocity: (top / n) = (n / top), negated when both are 3 mod 4
+    if (((top & 3) == 3) && ((n.lower() & 3) == 3)){
+        out = -out;
+    }
+    uint64_t bottom = mod_small(n, top);
+    // (bottom / top)
+    while (bottom){
+        while (!(bottom & 1)){
+            bottom >>= 1;
+            if (((top & 7) == 3) || ((top & 7) == 5)){
+                out = -out;
+            }
+        }
+        std::swap(top, bottom);
+        if (((top & 3) == 3) && ((bottom & 3) == 3)){
+            out = -out;
+        }
+        bottom %= top;
+    }
+    return (top == 1)?out:0;
+}
+
+static bool perfect_square(const uint128_t & n){
+    uint128_t rem = n, root = 0, b = uint128_1 << 126;
+    while (b > rem){
+        b >>= 2;
+    }
+    while (b){
+        if (rem >= root + b){
+            rem -= root + b;
+            root = (root >> 1) + b;
+        }
+        else{
+            root >>= 1;
+        }
+        b >>= 2;
+    }
+    return !rem;
+}
+
+// small signed x to Montgomery form
+static uint128_t from_signed(const montgomery128 & m, const int64_t x){
+    const uint128_t magnitude = m.from(uint128_t((x < 0)?(0 - static_cast <uint64_t> (x)):static_cast <uint64_t> (x)));
+    return (x < 0)?m.sub(uint128_t(0), magnitude):magnitude;
+}
+
+// strong Lucas probable prime test with Selfridge's parameters; n has no factor below 256
+static bool strong_lucas(const montgomery128 & m, const uint128_t & n){
+    // the first D in 5, -7, 9, -11, ... with (D / n) = -1
+    int64_t D = 5;
+    for(unsigned tries = 0;; tries++){
+        const int j = jacobi(D, n);
+        if (j == -1){
+            break;
+        }
+        if (j == 0){
+            return false;
+        }
+        // there is no such D when n is a square
+        if ((tries == 8) && perfect_square(n)){
+            return false;
+        }
+        D = (D > 0)?(-D - 2):(-D + 2);
+    }
+
+    // P = 1, Q = (1 - D) / 4
+    const uint128_t d_m = from_signed(m, D);
+    const uint128_t q_m = from_signed(m, (1 - D) / 4);
+
+    // n + 1 = d * 2^s; n + 1 does not wrap since 2^128 - 1 is divisible by 3
+    const uint128_t n_1(n.upper() + (n.lower() == ~0ULL), n.lower() + 1);
+    const unsigned s = trailing_zeros(n_1);
+    const uint128_t d = shift_right(n_1, s);
+
+    // U_k, V_k and Q^k from k = 1, doubling k and adding the next bit of d
+    uint128_t u = m.one, v = m.one, qk = q_m;
+    for(unsigned i = d.bits() - 1; i;){
+        i--;
+        u = m.multiply(u, v);
+        v = m.sub(m.multiply(v, v), m.add(qk, qk));
+        qk = m.multiply(qk, qk);
+        if (bit(d, i)){
+            const uint128_t du = m.multiply(d_m, u);
+            u = m.half(m.add(u, v));
+            v = m.half(m.add(du, v));
+            qk = m.multiply(qk, q_m);
+        }
+    }
+
+    if (is_zero(u) || is_zero(v)){
+        return true;
+    }
+    for(unsigned r = 1; r < s; r++){
+        v = m.sub(m.multiply(v, v), m.add(qk, qk));
+        if (is_zero(v)){
+            return true;
+        }
+        qk = m.multiply(qk, qk);
+    }
+    return false;
+}
+
+bool is_prime(const uint128_t & n){
+    if (!n.upper() && (n.lower() < 4)){
+        return n.lower() >= 2;
+    }
+    if (!(n.lower() & 1)){
+        return false;
+    }
+    for(std::size_t i = 0; i < TRIAL.below_256; i++){
+        if (TRIAL.divides(i, n)){
+            return !n.upper() && (n.lower() == TRIAL.prime[i]);
+        }
+    }
+    // no factor below 257
+    if (!n.upper() && (n.lower() < 257 * 257)){
+        return true;
+    }
+    if (!n.upper()){
+        return miller_rabin(n.lower());
+    }
+    if (less(n, PSI_13)){
+        return miller_rabin(n);
+    }
+
+    // Baillie-PSW
+    const montgomery128 m(n);
+    const uint128_t n_1 = subtract(n, uint128_t(1));
+    const unsigned s = trailing_zeros(n_1);
+    return strong_probable_prime(m, m.from(uint128_t(2)), shift_right(n_1, s), s) && strong_lucas(m, n);
+}
+
+void is_prime(const uint128_t * in, const std::size_t count, bool * out, const unsigned threads){
+    uint128_parallel_for(count, uint128_parallel_threads(threads, count / MIN_PER_THREAD),
+                         [=](const unsigned, const std::size_t begin, const std::size_t end){
+        for(std::size_t i = begin; i < end; i++){
+            out[i] = is_prime(in[i]);
+        }
+    });
+}
+
+// Pollard-Brent rho with f(x) = x^2 + c in Montgomery form. Returns a factor of n, which is n
+// itself when this c fails.
+template <typename M>
+static uint128_t pollard_brent(const M & m, const uint128_t & n, const uint64_t c_seed){
+    typedef typename M::value value;
+    const value c = m.from(c_seed);
+    value x = m.one, y = m.one, ys = m.one, q = m.one;
+    uint128_t g(1);
+    for(uint64_t r = 1; is_one(g); r <<= 1){
+        x = y;
+        for(uint64_t i = 0; i < r; i++){
+            y = m.add(m.multiply(y, y), c);
+        }
+        // one gcd per RHO_BATCH differences
+        for(uint64_t k = 0; (k < r) && is_one(g); k += RHO_BATCH){
+            ys = y;
+            const uint64_t steps = std::min(RHO_BATCH, r - k);
+            for(uint64_t i = 0; i < steps; i++){
+                y = m.add(m.multiply(y, y), c);
+                q = m.multiply(q, m.sub(x, y));
+            }
+            g = m.gcd(q);
+        }
+    }
+    // the product picked up every factor at once; step through the batch one difference at a time
+    if (same(g, n)){
+        do{
+            ys = m.add(m.multiply(ys, ys), c);
+            g = m.gcd(m.sub(x, ys));
+        } while (is_one(g));
+    }
+    return g;
+}
+
+// a nontrivial factor of an odd composite n
+template <typename M>
+static uint128_t split(const M & m, const uint128_t & n){
+    for(uint64_t c = 1;; c++){
+        const uint128_t g = pollard_brent(m, n, c);
+        if (!same(g, n)){
+            return g;
+        }
+    }
+}
+
+// appends the prime factors of an odd n > 1
+static void factor_odd(const uint128_t & n, std::vector <uint128_t> & out){
+    if (is_prime(n)){
+        out.push_back(n);
+        return;
+    }
+    const uint128_t d = n.upper()?split(montgomery128(n), n):split(montgomery64(n.lower()), n);
+    factor_odd(d, out);
+    // exact division by the odd d
+    factor_odd(multiply_low(n, inverse(d)), out);
+}
+
+std::vector <uint128_t> factor(const uint128_t & n){
+    if (is_zero(n)){
+        throw std::invalid_argument("Error: 0 has no prime factorization");
+    }
+    const unsigned twos = trailing_zeros(n);
+    std::vector <uint128_t> out(twos, uint128_t(2));
+    uint128_t rest = shift_right(n, twos);
+
+    for(std::size_t i = 0; i < TRIAL.prime.size(); i++){
+        const uint64_t p = TRIAL.prime[i];
+        if (!rest.upper() && (rest.lower() < p * p)){
+            break;
+        }
+        while (TRIAL.divides(i, rest)){
+            rest = multiply_low(rest, TRIAL.inverse[i]);
+            out.push_back(uint128_t(p));
+        }
+    }
+
+    if (!is_one(rest)){
+        factor_odd(rest, out);
+        std::sort(out.begin(), out.end());
+    }
+    return out;
+}
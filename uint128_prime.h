@@ -0,0 +1,41 @@
+/*
+uint128_prime.h
+Primality testing and factorization of uint128_t values
+
+is_prime is deterministic below 3317044064679887385961981 (about 2^81.5):
+    n < 2^32:        Miller-Rabin with Jaeschke's bases 2, 7 and 61
+    n < 2^64:        Miller-Rabin with Sinclair's 7 bases
+    n < 3.3 * 10^24: Miller-Rabin with the 13 primes 2 to 41
+    otherwise:       Baillie-PSW (a strong base 2 test and a strong Lucas test)
+Each base set is proven for every n below its bound. No Miller-Rabin base set has been
+proven for all n < 2^128, so above 3.3 * 10^24 the answer is a Baillie-PSW probable prime,
+for which no counterexample is known.
+
+factor returns the prime factors of n in ascending order, repeated by multiplicity; factor(1)
+is empty and factor(0) throws std::invalid_argument. Small factors are removed by trial
+division, and the rest are split with Pollard-Brent rho, which finds a factor p in about
+sqrt(p) steps, so factor is practical while the second largest prime factor is below about
+2^50.
+
+All modular arithmetic is Montgomery multiplication on 64-bit halves: after setting up the
+modulus there is no division anywhere. Trial division is also division-free: n is divisible
+by an odd p exactly when n * p^-1 mod 2^128 is at most (2^128 - 1) / p, with both constants
+taken from a table.
+*/
+
+#ifndef __UINT128_PRIME__
+#define __UINT128_PRIME__
+
+#include <cstddef>
+#include <vector>
+
+#include "uint128_t.h"
+
+UINT128_T_EXTERN bool is_prime(const uint128_t & n);
+
+// out[i] = is_prime(in[i]). threads = 0 uses every hardware thread.
+UINT128_T_EXTERN void is_prime(const uint128_t * in, std::size_t count, bool * out, unsigned threads = 1);
+
+UINT128_T_EXTERN std::vector <uint128_t> factor(const uint128_t & n);
+
+#endif
@@ -0,0 +1,356 @@
+/*
+uint128_random.h
+Random engines with 128-bit linear congruential state
+
+uint128_pcg64         PCG XSL-RR 128/64: the default 128-bit PCG multiplier and the XSL-RR
+                      output of the stepped state (pcg64 in the PCG reference code)
+uint128_pcg64_dxsm    PCG DXSM 128/64: a 64-bit multiplier and the DXSM output of the state
+                      before the step (PCG64DXSM in NumPy)
+uint128_mcg128        multiplicative LCG with a 64-bit multiplier that outputs the upper half
+                      of the stepped state; the fastest of the three, with period 2^126
+
+Each is a UniformRandomBitGenerator producing uint64_t, so it works with the <random>
+distributions, and none of them needs a compiler 128-bit type: the state is a uint128_t
+and steps with multlong64.
+
+The PCG engines have 2^127 streams, selected by the odd increment; two engines seeded with
+the same seed but different streams produce unrelated sequences. All three can jump ahead
+(or back, with a negative delta modulo 2^128) any number of steps in O(log delta)
+multiplies with advance(), so a block of the sequence can also be handed to each thread.
+
+fill() writes the next n outputs, exactly the values n calls would return. It keeps 4
+copies of the state, each one step ahead of the previous, and steps each by 4 at once, so
+the multiplies of different copies overlap instead of waiting on each other.
+
+uniform_uint128() draws unbiased values below a bound or in a closed range from any
+generator with 32 or 64 random bits per call, without a division in the common case
+(Lemire, "Fast Random Integer Generation in an Interval", 2019): a random x in [0, 2^128)
+times the bound is a 256-bit product whose upper half is in [0, bound), and is uniform once
+the products whose lower half is below 2^128 mod bound are rejected. That remainder costs a
+division, but it is only needed when the lower half is below the bound, which for a bound
+far from 2^128 almost never happens. Bounds up to 2^64 draw 64 bits instead of 128.
+*/
+
+#ifndef __UINT128_RANDOM__
+#define __UINT128_RANDOM__
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "uint128_t.h"
+
+// Output functions and multipliers of the engines below
+struct uint128_pcg_xsl_rr{
+    static constexpr uint64_t MULT_UPPER = 2549297995355413924ULL;
+    static constexpr uint64_t MULT_LOWER = 4865540595714422341ULL;
+    static constexpr bool OUTPUT_PREVIOUS = false;
+
+    static uint64_t output(const uint64_t upper, const uint64_t lower){
+        const uint64_t x = upper ^ lower;
+        const unsigned rot = static_cast <unsigned> (upper >> 58);
+        return (x >> rot) | (x << ((64 - rot) & 63));
+    }
+};
+
+struct uint128_pcg_dxsm{
+    static constexpr uint64_t MULT_UPPER = 0;
+    static constexpr uint64_t MULT_LOWER = 0xda942042e4dd58b5ULL;
+    static constexpr bool OUTPUT_PREVIOUS = true;
+
+    static uint64_t output(uint64_t upper, const uint64_t lower){
+        upper ^= upper >> 32;
+        upper *= MULT_LOWER;
+        upper ^= upper >> 48;
+        return upper * (lower | 1);
+    }
+};
+
+struct uint128_mcg_upper{
+    static constexpr uint64_t MULT_UPPER = 0;
+    static constexpr uint64_t MULT_LOWER = 0xda942042e4dd58b5ULL;
+    static constexpr bool OUTPUT_PREVIOUS = false;
+
+    static uint64_t output(const uint64_t upper, const uint64_t){
+        return upper;
+    }
+};
+
+// state = state * multiplier + increment; Streams = false fixes the increment at 0
+template <typename Output, bool Streams>
+class uint128_lcg_engine{
+    public:
+        typedef uint64_t result_type;
+
+        static constexpr result_type min(){
+            return 0;
+        }
+
+        static constexpr result_type max(){
+            return ~static_cast <result_type> (0);
+        }
+
+        // the default seed and stream are those of the PCG reference code
+        explicit uint128_lcg_engine(const uint128_t & s = uint128_t(0xcafef00dd15ea5e5ULL)){
+            seed(s);
+        }
+
+        uint128_lcg_engine(const uint128_t & s, const uint128_t & stream){
+            seed(s, stream);
+        }
+
+        void seed(const uint128_t & s = uint128_t(0xcafef00dd15ea5e5ULL)){
+            if (Streams){
+                seed_increment(s, uint128_t(6364136223846793005ULL, 1442695040888963407ULL));
+            }
+            else{
+                // any odd state has the full period
+                const uint128_t odd = (s << 1) | uint128_1;
+                upper = odd.upper();
+                lower = odd.lower();
+                inc_upper = inc_lower = 0;
+            }
+        }
+
+        // streams differ in their increment, (stream << 1) | 1; the top bit of stream is ignored
+        void seed(const uint128_t & s, const uint128_t & stream){
+            static_assert(Streams, "this engine has no streams");
+            seed_increment(s, (stream << 1) | uint128_1);
+        }
+
+        result_type operator()(){
+            if (Output::OUTPUT_PREVIOUS){
+                const result_type out = Output::output(upper, lower);
+                step();
+                return out;
+            }
+            step();
+            return Output::output(upper, lower);
+        }
+
+        // jump delta steps ahead; ~delta + 1 steps back delta
+        void advance(const uint128_t & delta){
+            uint128_t mult, plus;
+            jump(delta, mult, plus);
+            const uint128_t s = mult * state() + plus;
+            upper = s.upper();
+            lower = s.lower();
+        }
+
+        void discard(const unsigned long long n){
+            advance(uint128_t(n));
+        }
+
+        // out[i] = (*this)() for i in [0, n)
+        void fill(result_type * out, const std::size_t n){
+            const std::size_t rounds = n / 4;
+            if (rounds){
+                uint128_t mult, plus;
+                jump(uint128_t(4), mult, plus);
+                const uint64_t m_hi = mult.upper(), m_lo = mult.lower();
+                const uint64_t c_hi = plus.upper(), c_lo = plus.lower();
+
+                // the states that outputs 4r, 4r + 1, 4r + 2 and 4r + 3 are made from
+                if (!Output::OUTPUT_PREVIOUS){
+                    step();
+                }
+                uint64_t h0 = upper, l0 = lower;
+                step();
+                uint64_t h1 = upper, l1 = lower;
+                step();
+                uint64_t h2 = upper, l2 = lower;
+                step();
+                uint64_t h3 = upper, l3 = lower;
+
+                for(std::size_t r = 0;; r++){
+                    out[4 * r] = Output::output(h0, l0);
+                    out[4 * r + 1] = Output::output(h1, l1);
+                    out[4 * r + 2] = Output::output(h2, l2);
+                    out[4 * r + 3] = Output::output(h3, l3);
+                    if (r + 1 == rounds){
+                        break;
+                    }
+                    multiply_add(h0, l0, m_hi, m_lo, c_hi, c_lo);
+                    multiply_add(h1, l1, m_hi, m_lo, c_hi, c_lo);
+                    multiply_add(h2, l2, m_hi, m_lo, c_hi, c_lo);
+                    multiply_add(h3, l3, m_hi, m_lo, c_hi, c_lo);
+                }
+
+                // the state after the last output
+                upper = h3;
+                lower = l3;
+                if (Output::OUTPUT_PREVIOUS){
+                    step();
+                }
+            }
+            for(std::size_t i = rounds * 4; i < n; i++){
+                out[i] = (*this)();
+            }
+        }
+
+        uint128_t state() const{
+            return uint128_t(upper, lower);
+        }
+
+        uint128_t increment() const{
+            return uint128_t(inc_upper, inc_lower);
+        }
+
+        bool operator==(const uint128_lcg_engine & rhs) const{
+            return (upper == rhs.upper) && (lower == rhs.lower) && (inc_upper == rhs.inc_upper) && (inc_lower == rhs.inc_lower);
+        }
+
+        bool operator!=(const uint128_lcg_engine & rhs) const{
+            return !(*this == rhs);
+        }
+
+    private:
+        uint64_t upper, lower;
+        uint64_t inc_upper, inc_lower;
+
+        // hi:lo = hi:lo * m + c, modulo 2^128
+        static void multiply_add(uint64_t & hi, uint64_t & lo, const uint64_t m_hi, const uint64_t m_lo, const uint64_t c_hi, const uint64_t c_lo){
+            uint64_t high;
+            const uint64_t low = uint128_t::multlong64(lo, m_lo, &high);
+            high += lo * m_hi + hi * m_lo;
+            lo = low + c_lo;
+            hi = high + c_hi + (lo < low);
+        }
+
+        void step(){
+            multiply_add(upper, lower, Output::MULT_UPPER, Output::MULT_LOWER, inc_upper, inc_lower);
+        }
+
+        // the seeding of the PCG reference code
+        void seed_increment(const uint128_t & s, const uint128_t & inc){
+            inc_upper = inc.upper();
+            inc_lower = inc.lower();
+            upper = lower = 0;
+            step();
+            const uint128_t start = state() + s;
+            upper = start.upper();
+            lower = start.lower();
+            step();
+        }
+
+        // delta steps are state * mult + plus (Brown, "Random Number Generation with Arbitrary Strides", 1994)
+        void jump(uint128_t delta, uint128_t & mult, uint128_t & plus) const{
+            const uint64_t m_hi = Output::MULT_UPPER, m_lo = Output::MULT_LOWER;
+            uint128_t cur_mult(m_hi, m_lo);
+            uint128_t cur_plus = increment();
+            mult = uint128_1;
+            plus = uint128_0;
+            while (delta){
+                if (delta.lower() & 1){
+                    mult *= cur_mult;
+                    plus = plus * cur_mult + cur_plus;
+                }
+                cur_plus = (cur_mult + uint128_1) * cur_plus;
+                cur_mult *= cur_mult;
+                delta >>= 1;
+            }
+        }
+};
+
+typedef uint128_lcg_engine <uint128_pcg_xsl_rr, true> uint128_pcg64;
+typedef uint128_lcg_engine <uint128_pcg_dxsm, true> uint128_pcg64_dxsm;
+typedef uint128_lcg_engine <uint128_mcg_upper, false> uint128_mcg128;
+
+// 64 random bits from a generator with 32 or 64 per call
+template <typename Gen>
+uint64_t uint128_random_bits64(Gen & gen){
+    static_assert((Gen::max() - Gen::min() == 0xffffffffULL) || (Gen::max() - Gen::min() == 0xffffffffffffffffULL),
+                  "the generator must produce 32 or 64 random bits per call");
+    if (Gen::max() - Gen::min() == 0xffffffffULL){
+        const uint64_t upper = static_cast <uint64_t> (gen() - Gen::min());
+        return (upper << 32) | static_cast <uint64_t> (gen() - Gen::min());
+    }
+    return static_cast <uint64_t> (gen() - Gen::min());
+}
+
+template <typename Gen>
+uint128_t uint128_random_bits(Gen & gen){
+    const uint64_t upper = uint128_random_bits64(gen);
+    return uint128_t(upper, uint128_random_bits64(gen));
+}
+
+// 2^128 mod bound (2^64 mod bound for bounds up to 2^64), computed the first time a draw needs it
+struct uint128_uniform_threshold{
+    uint128_t value;
+    bool known;
+
+    uint128_uniform_threshold()
+        : value(0), known(false)
+    {}
+};
+
+// a value in [0, bound), bound > 0; threshold may be shared by draws with the same bound
+template <typename Gen>
+uint128_t uint128_uniform_below(Gen & gen, const uint128_t & bound, uint128_uniform_threshold & threshold){
+    if (!bound.upper()){
+        const uint64_t b = bound.lower();
+        uint64_t high;
+        uint64_t low = uint128_t::multlong64(uint128_random_bits64(gen), b, &high);
+        if (low < b){
+            if (!threshold.known){
+                threshold.value = (0 - b) % b;
+                threshold.known = true;
+            }
+            while (low < threshold.value.lower()){
+                low = uint128_t::multlong64(uint128_random_bits64(gen), b, &high);
+            }
+        }
+        return uint128_t(high);
+    }
+
+    uint128_t high;
+    uint128_t low = uint128_t::mul_wide(uint128_random_bits(gen), bound, &high);
+    if (low < bound){
+        if (!threshold.known){
+            threshold.value = (uint128_0 - bound) % bound;
+            threshold.known = true;
+        }
+        while (low < threshold.value){
+            low = uint128_t::mul_wide(uint128_random_bits(gen), bound, &high);
+        }
+    }
+    return high;
+}
+
+// uniform in [0, bound); throws std::invalid_argument if bound is 0
+template <typename Gen>
+uint128_t uniform_uint128(Gen & gen, const uint128_t & bound){
+    if (!bound){
+        throw std::invalid_argument("Error: bound is 0");
+    }
+    uint128_uniform_threshold threshold;
+    return uint128_uniform_below(gen, bound, threshold);
+}
+
+// uniform in [lo, hi]; throws std::invalid_argument if lo > hi
+template <typename Gen>
+uint128_t uniform_uint128(Gen & gen, const uint128_t & lo, const uint128_t & hi){
+    if (lo > hi){
+        throw std::invalid_argument("Error: lo is greater than hi");
+    }
+    const uint128_t bound = hi - lo + uint128_1;
+    if (!bound){
+        return uint128_random_bits(gen);
+    }
+    uint128_uniform_threshold threshold;
+    return lo + uint128_uniform_below(gen, bound, threshold);
+}
+
+// out[i] = uniform_uint128(gen, bound) for i in [0, count), sharing the rejection threshold
+template <typename Gen>
+void uniform_uint128(Gen & gen, const uint128_t & bound, uint128_t * out, const std::size_t count){
+    if (!bound){
+        throw std::invalid_argument("Error: bound is 0");
+    }
+    uint128_uniform_threshold threshold;
+    for(std::size_t i = 0; i < count; i++){
+        out[i] = uint128_uniform_below(gen, bound, threshold);
+    }
+}
+
+#endif
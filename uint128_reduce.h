@@ -0,0 +1,277 @@
+/*
+uint128_reduce.h
+Exact sums, sums of squares and dot products of uint128_t and uint64_t arrays
+
+The results are up to 256 bits wide and are returned as a uint128_wide_sum, the value
+high * 2^128 + low. Sums of up to 2^64 values never overflow it; sums of squares and dot
+products of uint128_t values can, and set overflow instead (high and low then hold the
+result modulo 2^256).
+
+Every 64 x 64 -> 128 bit partial product is split into 64-bit terms by the power of 2^64 it
+is worth, and each power gets its own column: a running 64-bit sum plus a count of the
+times it wrapped. Adding to a column depends on nothing but that column, so there is no
+carry chain running through the loop, and each column is kept in several independent
+copies (lanes) so that consecutive elements do not wait on each other either. The columns
+are only added up exactly, with full carry propagation, once per thread at the end.
+
+With more than one thread, each thread reduces a contiguous chunk and the chunk totals are
+added at the end.
+*/
+
+#ifndef __UINT128_REDUCE__
+#define __UINT128_REDUCE__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "uint128_parallel.h"
+#include "uint128_t.h"
+
+// high * 2^128 + low, unless overflow is set
+struct uint128_wide_sum{
+    uint128_t high;
+    uint128_t low;
+    bool overflow;
+};
+
+class uint128_reduce{
+    public:
+        // below this many values per thread, extra threads cost more than they save
+        static const std::size_t MIN_PER_THREAD = 1 << 16;
+
+        // 64-bit terms summed as sum + carries * 2^64
+        struct column{
+            uint64_t sum;
+            uint64_t carries;
+
+            column()
+                : sum(0), carries(0)
+            {}
+
+            void add(const uint64_t term){
+                sum += term;
+                carries += sum < term;
+            }
+        };
+
+        // exact 320-bit total, least significant limb first; wide enough for any sum of fewer than 2^64 products
+        struct total{
+            uint64_t limb[5];
+
+            total()
+                : limb{0, 0, 0, 0, 0}
+            {}
+
+            // += term * 2^(64 * at)
+            void add(uint64_t term, unsigned at){
+                for(; term && (at < 5); at++){
+                    limb[at] += term;
+                    term = limb[at] < term;
+                }
+            }
+
+            // += times * c * 2^(64 * at)
+            void add(const column & c, const unsigned at, const unsigned times = 1){
+                for(unsigned i = 0; i < times; i++){
+                    add(c.sum, at);
+                    add(c.carries, at + 1);
+                }
+            }
+
+            void add(const total & rhs){
+                for(unsigned i = 0; i < 5; i++){
+                    add(rhs.limb[i], i);
+                }
+            }
+
+            uint128_wide_sum result() const{
+                return uint128_wide_sum{uint128_t(limb[3], limb[2]), uint128_t(limb[1], limb[0]), limb[4] != 0};
+            }
+        };
+
+        // Chunk(begin, end) returns the total of [begin, end)
+        template <typename Chunk>
+        static uint128_wide_sum run(const std::size_t count, const unsigned requested, Chunk chunk){
+            const unsigned threads = uint128_parallel_threads(requested, count / MIN_PER_THREAD);
+            std::vector <total> totals(threads);
+            uint128_parallel_for(count, threads, [&](const unsigned t, const std::size_t begin, const std::size_t end){
+                totals[t] = chunk(begin, end);
+            });
+            for(unsigned t = 1; t < threads; t++){
+                totals[0].add(totals[t]);
+            }
+            return totals[0].result();
+        }
+
+        // Lanes independent copies of the columns; column k is worth 2^(64 * k) unless folded otherwise
+        template <unsigned Lanes, unsigned Columns>
+        struct lanes{
+            column c[Lanes][Columns];
+
+            total fold() const{
+                total out;
+                for(unsigned l = 0; l < Lanes; l++){
+                    for(unsigned k = 0; k < Columns; k++){
+                        out.add(c[l][k], k);
+                    }
+                }
+                return out;
+            }
+        };
+
+        // columns: lo * lo at 2^0 and 2^64, hi * hi at 2^128 and 2^192, lo * hi at 2^64 and 2^128
+        template <unsigned Lane, typename L>
+        static void square(L & acc, const uint128_t & x){
+            uint64_t high;
+            const uint64_t lo = x.lower(), hi = x.upper();
+            acc.c[Lane][0].add(uint128_t::multlong64(lo, lo, &high));
+            acc.c[Lane][1].add(high);
+            acc.c[Lane][2].add(uint128_t::multlong64(hi, hi, &high));
+            acc.c[Lane][3].add(high);
+            acc.c[Lane][4].add(uint128_t::multlong64(lo, hi, &high));
+            acc.c[Lane][5].add(high);
+        }
+
+        template <unsigned Lane, typename L>
+        static void multiply(L & acc, const uint128_t & a, const uint128_t & b){
+            uint64_t high;
+            acc.c[Lane][0].add(uint128_t::multlong64(a.lower(), b.lower(), &high));
+            acc.c[Lane][1].add(high);
+            acc.c[Lane][2].add(uint128_t::multlong64(a.upper(), b.upper(), &high));
+            acc.c[Lane][3].add(high);
+            acc.c[Lane][4].add(uint128_t::multlong64(a.lower(), b.upper(), &high));
+            acc.c[Lane][5].add(high);
+            acc.c[Lane][6].add(uint128_t::multlong64(a.upper(), b.lower(), &high));
+            acc.c[Lane][7].add(high);
+        }
+
+        // adds to the columns of one lane
+        template <unsigned Lane, typename L>
+        static void add(L & acc, const uint128_t & x){
+            acc.c[Lane][0].add(x.lower());
+            acc.c[Lane][1].add(x.upper());
+        }
+
+        template <unsigned Lane, typename L>
+        static void add(L & acc, const uint64_t x){
+            acc.c[Lane][0].add(x);
+        }
+
+        template <unsigned Lane, typename L>
+        static void multiply(L & acc, const uint64_t a, const uint64_t b){
+            uint64_t high;
+            acc.c[Lane][0].add(uint128_t::multlong64(a, b, &high));
+            acc.c[Lane][1].add(high);
+        }
+
+        template <typename T>
+        static total sum(const T * in, const std::size_t begin, const std::size_t end){
+            lanes <4, sizeof(T) / sizeof(uint64_t)> acc;
+            std::size_t i = begin;
+            for(; i + 4 <= end; i += 4){
+                add <0> (acc, in[i]);
+                add <1> (acc, in[i + 1]);
+                add <2> (acc, in[i + 2]);
+                add <3> (acc, in[i + 3]);
+            }
+            for(; i < end; i++){
+                add <0> (acc, in[i]);
+            }
+            return acc.fold();
+        }
+
+        static total sum_squares(const uint128_t * in, const std::size_t begin, const std::size_t end){
+            lanes <2, 6> acc;
+            std::size_t i = begin;
+            for(; i + 2 <= end; i += 2){
+                square <0> (acc, in[i]);
+                square <1> (acc, in[i + 1]);
+            }
+            if (i < end){
+                square <0> (acc, in[i]);
+            }
+            return fold_products(acc, 2);
+        }
+
+        static total dot(const uint128_t * a, const uint128_t * b, const std::size_t begin, const std::size_t end){
+            lanes <2, 8> acc;
+            std::size_t i = begin;
+            for(; i + 2 <= end; i += 2){
+                multiply <0> (acc, a[i], b[i]);
+                multiply <1> (acc, a[i + 1], b[i + 1]);
+            }
+            if (i < end){
+                multiply <0> (acc, a[i], b[i]);
+            }
+            return fold_products(acc, 1);
+        }
+
+        // products of 64-bit values only have the 2^0 and 2^64 columns
+        static total dot(const uint64_t * a, const uint64_t * b, const std::size_t begin, const std::size_t end){
+            lanes <2, 2> acc;
+            std::size_t i = begin;
+            for(; i + 2 <= end; i += 2){
+                multiply <0> (acc, a[i], b[i]);
+                multiply <1> (acc, a[i + 1], b[i + 1]);
+            }
+            if (i < end){
+                multiply <0> (acc, a[i], b[i]);
+            }
+            return acc.fold();
+        }
+
+    private:
+        // columns 4 and up are the cross products at 2^64, 2^128, 2^64, 2^128, ...
+        template <unsigned Lanes, unsigned Columns>
+        static total fold_products(const lanes <Lanes, Columns> & acc, const unsigned cross_times){
+            total out;
+            for(unsigned l = 0; l < Lanes; l++){
+                for(unsigned k = 0; k < Columns; k++){
+                    out.add(acc.c[l][k], (k < 4)?k:(1 + (k & 1)), (k < 4)?1:cross_times);
+                }
+            }
+            return out;
+        }
+};
+
+// sum of in[0, count). threads = 0 uses every hardware thread.
+inline uint128_wide_sum uint128_sum(const uint128_t * in, const std::size_t count, const unsigned threads = 1){
+    return uint128_reduce::run(count, threads, [=](const std::size_t begin, const std::size_t end){
+        return uint128_reduce::sum(in, begin, end);
+    });
+}
+
+inline uint128_wide_sum uint128_sum(const uint64_t * in, const std::size_t count, const unsigned threads = 1){
+    return uint128_reduce::run(count, threads, [=](const std::size_t begin, const std::size_t end){
+        return uint128_reduce::sum(in, begin, end);
+    });
+}
+
+// sum of in[i]^2
+inline uint128_wide_sum uint128_sum_squares(const uint128_t * in, const std::size_t count, const unsigned threads = 1){
+    return uint128_reduce::run(count, threads, [=](const std::size_t begin, const std::size_t end){
+        return uint128_reduce::sum_squares(in, begin, end);
+    });
+}
+
+inline uint128_wide_sum uint128_sum_squares(const uint64_t * in, const std::size_t count, const unsigned threads = 1){
+    return uint128_reduce::run(count, threads, [=](const std::size_t begin, const std::size_t end){
+        return uint128_reduce::dot(in, in, begin, end);
+    });
+}
+
+// sum of a[i] * b[i]
+inline uint128_wide_sum uint128_dot(const uint128_t * a, const uint128_t * b, const std::size_t count, const unsigned threads = 1){
+    return uint128_reduce::run(count, threads, [=](const std::size_t begin, const std::size_t end){
+        return uint128_reduce::dot(a, b, begin, end);
+    });
+}
+
+inline uint128_wide_sum uint128_dot(const uint64_t * a, const uint64_t * b, const std::size_t count, const unsigned threads = 1){
+    return uint128_reduce::run(count, threads, [=](const std::size_t begin, const std::size_t end){
+        return uint128_reduce::dot(a, b, begin, end);
+    });
+}
+
+#endif
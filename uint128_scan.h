@@ -0,0 +1,188 @@
+/*
+uint128_scan.h
+Prefix sums (scans) of uint128_t arrays
+
+Inclusive:  out[i] = in[0] + ... + in[i]
+Exclusive:  out[i] = init + in[0] + ... + in[i - 1], out[0] = init
+Segmented:  the same, restarting from 0 at every i where heads[i] is nonzero
+
+in and out may be the same array. By default the totals wrap modulo 2^128. With
+UINT128_SCAN_CHECKED the scan still runs to the end, writing the wrapped totals, and then
+throws std::overflow_error if the total of any segment (for an exclusive scan, including its
+last element) did not fit in 128 bits.
+
+The running total is kept as two 64-bit halves and each step is one add and one add with
+carry, all inline; the carry chain through the halves is the only dependency between steps,
+so there is nothing to gain from SIMD lanes, which would need a cross-lane carry fixup on
+every step. With more than one thread, the scan runs in two passes: each thread first sums
+its chunk, the chunk totals are scanned serially into starting offsets, then each thread
+scans its chunk from its offset. Both passes read the input; only the second writes.
+*/
+
+#ifndef __UINT128_SCAN__
+#define __UINT128_SCAN__
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "uint128_parallel.h"
+#include "uint128_t.h"
+
+enum uint128_scan_mode{
+    UINT128_SCAN_WRAP,
+    UINT128_SCAN_CHECKED,
+};
+
+class uint128_scan{
+    public:
+        // below this many values per thread, extra threads cost more than they save
+        static const std::size_t MIN_PER_THREAD = 1 << 16;
+
+        // running total as two halves, so the loop keeps it in registers
+        struct running{
+            uint64_t hi;
+            uint64_t lo;
+            bool overflow;
+
+            explicit running(const uint128_t & init = uint128_0)
+                : hi(init.upper()), lo(init.lower()), overflow(false)
+            {}
+
+            template <bool Checked>
+            void add(const uint128_t & x){
+                lo += x.lower();
+                const uint64_t carry = lo < x.lower();
+                if (Checked){
+                    const uint64_t sum = hi + x.upper();
+                    overflow |= sum < hi;
+                    hi = sum + carry;
+                    overflow |= hi < carry;
+                }
+                else{
+                    hi += x.upper() + carry;
+                }
+            }
+
+            uint128_t value() const{
+                return uint128_t(hi, lo);
+            }
+        };
+
+        // scans [begin, end) starting from start; returns true if a segment total overflowed
+        template <bool Inclusive, bool Segmented, bool Checked>
+        static bool scan(const uint128_t * in, const uint8_t * heads, uint128_t * out,
+                         const std::size_t begin, const std::size_t end, const uint128_t & start){
+            running total(start);
+            for(std::size_t i = begin; i < end; i++){
+                if (Segmented && heads[i]){
+                    total.hi = total.lo = 0;
+                }
+                const uint128_t x = in[i];
+                if (!Inclusive){
+                    out[i] = total.value();
+                }
+                total.template add <Checked> (x);
+                if (Inclusive){
+                    out[i] = total.value();
+                }
+            }
+            return total.overflow;
+        }
+
+        // total of the last segment of [begin, end), or of all of it if there is no head in it
+        template <bool Segmented>
+        static uint128_t reduce(const uint128_t * in, const uint8_t * heads, std::size_t begin, const std::size_t end, bool & has_head){
+            has_head = false;
+            if (Segmented){
+                for(std::size_t i = end; i > begin; i--){
+                    if (heads[i - 1]){
+                        has_head = true;
+                        begin = i - 1;
+                        break;
+                    }
+                }
+            }
+            running total;
+            for(std::size_t i = begin; i < end; i++){
+                total.template add <false> (in[i]);
+            }
+            return total.value();
+        }
+
+        template <bool Inclusive, bool Segmented>
+        static void run(const uint128_t * in, const uint8_t * heads, uint128_t * out, const std::size_t count,
+                        const uint128_t & init, const uint128_scan_mode mode, const unsigned requested){
+            const bool checked = (mode == UINT128_SCAN_CHECKED);
+            const unsigned threads = uint128_parallel_threads(requested, count / MIN_PER_THREAD);
+            bool overflow = false;
+
+            if (threads == 1){
+                overflow = checked?scan <Inclusive, Segmented, true> (in, heads, out, 0, count, init)
+                                  :scan <Inclusive, Segmented, false> (in, heads, out, 0, count, init);
+            }
+            else{
+                // pass 1: chunk totals
+                std::vector <uint128_t> offsets(threads);
+                std::vector <char> has_head(threads);
+                uint128_parallel_for(count, threads, [&](const unsigned t, const std::size_t begin, const std::size_t end){
+                    bool head;
+                    offsets[t] = reduce <Segmented> (in, heads, begin, end, head);
+                    has_head[t] = head;
+                });
+
+                // chunk totals to starting offsets
+                running total(init);
+                bool wrapped = false;
+                for(unsigned t = 0; t < threads; t++){
+                    const uint128_t chunk = offsets[t];
+                    offsets[t] = total.value();
+                    if (has_head[t]){
+                        wrapped |= total.overflow;
+                        total = running();
+                    }
+                    total.add <true> (chunk);
+                }
+                overflow = checked && (wrapped || total.overflow);
+
+                // pass 2: scan each chunk from its offset
+                std::vector <char> chunk_overflow(threads, 0);
+                uint128_parallel_for(count, threads, [&](const unsigned t, const std::size_t begin, const std::size_t end){
+                    chunk_overflow[t] = checked?scan <Inclusive, Segmented, true> (in, heads, out, begin, end, offsets[t])
+                                               :scan <Inclusive, Segmented, false> (in, heads, out, begin, end, offsets[t]);
+                });
+                for(unsigned t = 0; t < threads; t++){
+                    overflow |= chunk_overflow[t] != 0;
+                }
+            }
+
+            if (overflow){
+                throw std::overflow_error("Error: prefix sum does not fit in 128 bits");
+            }
+        }
+};
+
+// threads = 0 uses every hardware thread
+inline void uint128_inclusive_scan(const uint128_t * in, uint128_t * out, const std::size_t count,
+                                   const uint128_scan_mode mode = UINT128_SCAN_WRAP, const unsigned threads = 1){
+    uint128_scan::run <true, false> (in, nullptr, out, count, uint128_0, mode, threads);
+}
+
+inline void uint128_exclusive_scan(const uint128_t * in, uint128_t * out, const std::size_t count, const uint128_t & init = uint128_0,
+                                   const uint128_scan_mode mode = UINT128_SCAN_WRAP, const unsigned threads = 1){
+    uint128_scan::run <false, false> (in, nullptr, out, count, init, mode, threads);
+}
+
+// a nonzero heads[i] starts a new segment at i
+inline void uint128_segmented_inclusive_scan(const uint128_t * in, const uint8_t * heads, uint128_t * out, const std::size_t count,
+                                             const uint128_scan_mode mode = UINT128_SCAN_WRAP, const unsigned threads = 1){
+    uint128_scan::run <true, true> (in, heads, out, count, uint128_0, mode, threads);
+}
+
+inline void uint128_segmented_exclusive_scan(const uint128_t * in, const uint8_t * heads, uint128_t * out, const std::size_t count,
+                                             const uint128_scan_mode mode = UINT128_SCAN_WRAP, const unsigned threads = 1){
+    uint128_scan::run <false, true> (in, heads, out, count, uint128_0, mode, threads);
+}
+
+#endif
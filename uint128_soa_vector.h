@@ -0,0 +1,623 @@
+/*
+uint128_soa_vector.h
+uint128_t array with the upper and lower halves in separate arrays
+
+An array of uint128_t interleaves the halves, so a loop over it moves 16 bytes per element
+through scalar registers. Here each half is a contiguous, 64 byte aligned uint64_t array, and
+the elementwise operations process 8 (AVX-512) or 4 (AVX2) values per instruction, picked from
+the CPU with runtime dispatch (see uint128_t_config.include) or else from the compiler flags.
+Carries and borrows are the result of unsigned vector compares; AVX2 has only signed 64-bit
+compares, so both sides are offset by 2^63 first.
+
+The bitwise operations and shifts are plain loops that compilers vectorize on their own.
+Multiplication by a scalar uses the scalar 64 x 64 -> 128 bit multiply: neither AVX2 nor
+AVX-512F has a 64-bit high multiply, and building one from 32-bit products costs more than
+mulx does.
+
+Binary operations throw std::invalid_argument if the sizes differ.
+Compare results are written as one byte (0 or 1) per element.
+*/
+
+#ifndef __UINT128_SOA_VECTOR__
+#define __UINT128_SOA_VECTOR__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "uint128_t.h"
+
+#if defined(_UINT128_T_DISPATCH) || defined(__AVX512F__)
+#define _UINT128_SOA_AVX512
+#endif
+
+#if defined(_UINT128_T_DISPATCH) || defined(__AVX2__)
+#define _UINT128_SOA_AVX2
+#endif
+
+#if defined(_UINT128_SOA_AVX512) || defined(_UINT128_SOA_AVX2)
+#include <immintrin.h>
+#endif
+
+// Allocator for 64 byte aligned arrays. The start of the block returned by operator new is
+// stored just before the aligned pointer.
+template <typename T>
+struct uint128_aligned_allocator{
+    typedef T value_type;
+
+    static const std::size_t ALIGNMENT = 64;
+
+    uint128_aligned_allocator() = default;
+
+    template <typename U>
+    uint128_aligned_allocator(const uint128_aligned_allocator <U> &){}
+
+    T * allocate(const std::size_t n){
+        if (n > (static_cast <std::size_t> (-1) - ALIGNMENT - sizeof(void *)) / sizeof(T)){
+            throw std::bad_alloc();
+        }
+        char * raw = static_cast <char *> (::operator new(n * sizeof(T) + ALIGNMENT + sizeof(void *)));
+        const uintptr_t addr = reinterpret_cast <uintptr_t> (raw + sizeof(void *));
+        char * aligned = raw + sizeof(void *) + ((ALIGNMENT - (addr % ALIGNMENT)) % ALIGNMENT);
+        reinterpret_cast <void **> (aligned)[-1] = raw;
+        return reinterpret_cast <T *> (aligned);
+    }
+
+    void deallocate(T * ptr, const std::size_t){
+        ::operator delete(reinterpret_cast <void **> (ptr)[-1]);
+    }
+
+    template <typename U>
+    bool operator==(const uint128_aligned_allocator <U> &) const{
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const uint128_aligned_allocator <U> &) const{
+        return false;
+    }
+};
+
+class uint128_soa_vector{
+    public:
+        typedef std::vector <uint64_t, uint128_aligned_allocator <uint64_t> > half;
+
+        uint128_soa_vector() = default;
+
+        explicit uint128_soa_vector(const std::size_t n, const uint128_t & value = uint128_0)
+            : hi(n, value.upper()), lo(n, value.lower())
+        {}
+
+        uint128_soa_vector(const uint128_t * values, const std::size_t n)
+            : hi(n), lo(n)
+        {
+            for(std::size_t i = 0; i < n; i++){
+                hi[i] = values[i].upper();
+                lo[i] = values[i].lower();
+            }
+        }
+
+        explicit uint128_soa_vector(const std::vector <uint128_t> & values)
+            : uint128_soa_vector(values.data(), values.size())
+        {}
+
+        std::size_t size() const{
+            return lo.size();
+        }
+
+        bool empty() const{
+            return lo.empty();
+        }
+
+        void resize(const std::size_t n, const uint128_t & value = uint128_0){
+            hi.resize(n, value.upper());
+            lo.resize(n, value.lower());
+        }
+
+        void reserve(const std::size_t n){
+            hi.reserve(n);
+            lo.reserve(n);
+        }
+
+        void clear(){
+            hi.clear();
+            lo.clear();
+        }
+
+        void push_back(const uint128_t & value){
+            hi.push_back(value.upper());
+            lo.push_back(value.lower());
+        }
+
+        uint128_t operator[](const std::size_t i) const{
+            return uint128_t(hi[i], lo[i]);
+        }
+
+        void set(const std::size_t i, const uint128_t & value){
+            hi[i] = value.upper();
+            lo[i] = value.lower();
+        }
+
+        // the halves, for kernels of your own
+        uint64_t * upper_data(){ return hi.data(); }
+        uint64_t * lower_data(){ return lo.data(); }
+        const uint64_t * upper_data() const{ return hi.data(); }
+        const uint64_t * lower_data() const{ return lo.data(); }
+
+        // out must hold size() values
+        void copy_to(uint128_t * out) const{
+            for(std::size_t i = 0; i < size(); i++){
+                out[i] = uint128_t(hi[i], lo[i]);
+            }
+        }
+
+        std::vector <uint128_t> to_vector() const{
+            std::vector <uint128_t> out(size());
+            copy_to(out.data());
+            return out;
+        }
+
+        // Arithmetic (wrapping) //////////////////////////////////////////////
+
+        uint128_soa_vector & operator+=(const uint128_soa_vector & rhs){
+            check(rhs);
+            add <false> (rhs.hi.data(), rhs.lo.data());
+            return *this;
+        }
+
+        uint128_soa_vector & operator+=(const uint128_t & rhs){
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            add <true> (&h, &l);
+            return *this;
+        }
+
+        uint128_soa_vector & operator-=(const uint128_soa_vector & rhs){
+            check(rhs);
+            sub <false> (rhs.hi.data(), rhs.lo.data());
+            return *this;
+        }
+
+        uint128_soa_vector & operator-=(const uint128_t & rhs){
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            sub <true> (&h, &l);
+            return *this;
+        }
+
+        // low 128 bits of each product
+        uint128_soa_vector & operator*=(const uint128_t & rhs){
+            const uint64_t rh = rhs.upper(), rl = rhs.lower();
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            for(std::size_t i = 0; i < size(); i++){
+                uint64_t high;
+                const uint64_t low = uint128_t::multlong64(l[i], rl, &high);
+                h[i] = high + l[i] * rh + h[i] * rl;
+                l[i] = low;
+            }
+            return *this;
+        }
+
+        // Bitwise ////////////////////////////////////////////////////////////
+
+        uint128_soa_vector & operator&=(const uint128_soa_vector & rhs){
+            check(rhs);
+            bitwise(rhs.hi.data(), rhs.lo.data(), 1, [](const uint64_t a, const uint64_t b){ return a & b; });
+            return *this;
+        }
+
+        uint128_soa_vector & operator&=(const uint128_t & rhs){
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            bitwise(&h, &l, 0, [](const uint64_t a, const uint64_t b){ return a & b; });
+            return *this;
+        }
+
+        uint128_soa_vector & operator|=(const uint128_soa_vector & rhs){
+            check(rhs);
+            bitwise(rhs.hi.data(), rhs.lo.data(), 1, [](const uint64_t a, const uint64_t b){ return a | b; });
+            return *this;
+        }
+
+        uint128_soa_vector & operator|=(const uint128_t & rhs){
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            bitwise(&h, &l, 0, [](const uint64_t a, const uint64_t b){ return a | b; });
+            return *this;
+        }
+
+        uint128_soa_vector & operator^=(const uint128_soa_vector & rhs){
+            check(rhs);
+            bitwise(rhs.hi.data(), rhs.lo.data(), 1, [](const uint64_t a, const uint64_t b){ return a ^ b; });
+            return *this;
+        }
+
+        uint128_soa_vector & operator^=(const uint128_t & rhs){
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            bitwise(&h, &l, 0, [](const uint64_t a, const uint64_t b){ return a ^ b; });
+            return *this;
+        }
+
+        // shifts of 128 or more give 0
+        uint128_soa_vector & operator<<=(const unsigned shift){
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            if (shift >= 128){
+                std::fill(h, h + size(), 0);
+                std::fill(l, l + size(), 0);
+            }
+            else if (shift >= 64){
+                for(std::size_t i = 0; i < size(); i++){
+                    h[i] = l[i] << (shift - 64);
+                    l[i] = 0;
+                }
+            }
+            else if (shift){
+                for(std::size_t i = 0; i < size(); i++){
+                    h[i] = (h[i] << shift) | (l[i] >> (64 - shift));
+                    l[i] <<= shift;
+                }
+            }
+            return *this;
+        }
+
+        uint128_soa_vector & operator>>=(const unsigned shift){
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            if (shift >= 128){
+                std::fill(h, h + size(), 0);
+                std::fill(l, l + size(), 0);
+            }
+            else if (shift >= 64){
+                for(std::size_t i = 0; i < size(); i++){
+                    l[i] = h[i] >> (shift - 64);
+                    h[i] = 0;
+                }
+            }
+            else if (shift){
+                for(std::size_t i = 0; i < size(); i++){
+                    l[i] = (l[i] >> shift) | (h[i] << (64 - shift));
+                    h[i] >>= shift;
+                }
+            }
+            return *this;
+        }
+
+        // Min / max //////////////////////////////////////////////////////////
+
+        // this[i] = min(this[i], rhs[i])
+        void assign_min(const uint128_soa_vector & rhs){
+            check(rhs);
+            select <false> (rhs);
+        }
+
+        // this[i] = max(this[i], rhs[i])
+        void assign_max(const uint128_soa_vector & rhs){
+            check(rhs);
+            select <true> (rhs);
+        }
+
+        // Compares ///////////////////////////////////////////////////////////
+
+        // out[i] = this[i] == rhs[i]
+        void equal(const uint128_soa_vector & rhs, uint8_t * out) const{
+            check(rhs);
+            compare <EQUAL, false> (rhs.hi.data(), rhs.lo.data(), out);
+        }
+
+        void equal(const uint128_t & rhs, uint8_t * out) const{
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            compare <EQUAL, true> (&h, &l, out);
+        }
+
+        // out[i] = this[i] < rhs[i]
+        void less(const uint128_soa_vector & rhs, uint8_t * out) const{
+            check(rhs);
+            compare <LESS, false> (rhs.hi.data(), rhs.lo.data(), out);
+        }
+
+        void less(const uint128_t & rhs, uint8_t * out) const{
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            compare <LESS, true> (&h, &l, out);
+        }
+
+        // out[i] = this[i] > rhs[i]
+        void greater(const uint128_soa_vector & rhs, uint8_t * out) const{
+            check(rhs);
+            compare <GREATER, false> (rhs.hi.data(), rhs.lo.data(), out);
+        }
+
+        void greater(const uint128_t & rhs, uint8_t * out) const{
+            const uint64_t h = rhs.upper(), l = rhs.lower();
+            compare <GREATER, true> (&h, &l, out);
+        }
+
+    private:
+        enum comparison{
+            EQUAL,
+            LESS,
+            GREATER,
+        };
+
+        half hi;
+        half lo;
+
+        void check(const uint128_soa_vector & rhs) const{
+            if (rhs.size() != size()){
+                throw std::invalid_argument("Error: uint128_soa_vector sizes differ");
+            }
+        }
+
+        // element i of the right hand side; Scalar means it is the same value for every i
+        template <bool Scalar>
+        static uint64_t at(const uint64_t * p, const std::size_t i){
+            return p[Scalar?0:i];
+        }
+
+        // The vector loops start at i and return the index they stopped at, for the next loop to
+        // continue from.
+#if defined(_UINT128_SOA_AVX512)
+        template <bool Scalar>
+        _UINT128_T_TARGET_AVX512 static __m512i load512(const uint64_t * p, const std::size_t i){
+            return Scalar?_mm512_set1_epi64(static_cast <long long> (*p)):_mm512_loadu_si512(p + i);
+        }
+
+        template <bool Scalar>
+        _UINT128_T_TARGET_AVX512 static std::size_t add_avx512(uint64_t * h, uint64_t * l, const uint64_t * rhs_hi, const uint64_t * rhs_lo, const std::size_t n, std::size_t i){
+            for(; i + 8 <= n; i += 8){
+                const __m512i a = _mm512_load_si512(l + i);
+                const __m512i sum = _mm512_add_epi64(a, load512 <Scalar> (rhs_lo, i));
+                const __mmask8 carry = _mm512_cmplt_epu64_mask(sum, a);
+                const __m512i high = _mm512_add_epi64(_mm512_load_si512(h + i), load512 <Scalar> (rhs_hi, i));
+                _mm512_store_si512(l + i, sum);
+                _mm512_store_si512(h + i, _mm512_mask_add_epi64(high, carry, high, _mm512_set1_epi64(1)));
+            }
+            return i;
+        }
+
+        template <bool Scalar>
+        _UINT128_T_TARGET_AVX512 static std::size_t sub_avx512(uint64_t * h, uint64_t * l, const uint64_t * rhs_hi, const uint64_t * rhs_lo, const std::size_t n, std::size_t i){
+            for(; i + 8 <= n; i += 8){
+                const __m512i a = _mm512_load_si512(l + i);
+                const __m512i b = load512 <Scalar> (rhs_lo, i);
+                const __mmask8 borrow = _mm512_cmplt_epu64_mask(a, b);
+                const __m512i high = _mm512_sub_epi64(_mm512_load_si512(h + i), load512 <Scalar> (rhs_hi, i));
+                _mm512_store_si512(l + i, _mm512_sub_epi64(a, b));
+                _mm512_store_si512(h + i, _mm512_mask_sub_epi64(high, borrow, high, _mm512_set1_epi64(1)));
+            }
+            return i;
+        }
+
+        template <bool Max>
+        _UINT128_T_TARGET_AVX512 static std::size_t select_avx512(uint64_t * h, uint64_t * l, const uint64_t * rh, const uint64_t * rl, const std::size_t n, std::size_t i){
+            for(; i + 8 <= n; i += 8){
+                const __m512i ah = _mm512_load_si512(h + i), al = _mm512_load_si512(l + i);
+                const __m512i bh = _mm512_load_si512(rh + i), bl = _mm512_load_si512(rl + i);
+                // lanes where rhs wins
+                const __mmask8 take = Max?(_mm512_cmplt_epu64_mask(ah, bh) | (_mm512_cmpeq_epu64_mask(ah, bh) & _mm512_cmplt_epu64_mask(al, bl)))
+                                         :(_mm512_cmplt_epu64_mask(bh, ah) | (_mm512_cmpeq_epu64_mask(ah, bh) & _mm512_cmplt_epu64_mask(bl, al)));
+                _mm512_store_si512(h + i, _mm512_mask_blend_epi64(take, ah, bh));
+                _mm512_store_si512(l + i, _mm512_mask_blend_epi64(take, al, bl));
+            }
+            return i;
+        }
+
+        template <comparison Op, bool Scalar>
+        _UINT128_T_TARGET_AVX512 static std::size_t compare_avx512(const uint64_t * h, const uint64_t * l, const uint64_t * rhs_hi, const uint64_t * rhs_lo, uint8_t * out, const std::size_t n, std::size_t i){
+            for(; i + 8 <= n; i += 8){
+                const __m512i ah = _mm512_load_si512(h + i), al = _mm512_load_si512(l + i);
+                const __m512i bh = load512 <Scalar> (rhs_hi, i), bl = load512 <Scalar> (rhs_lo, i);
+                const __mmask8 high_equal = _mm512_cmpeq_epu64_mask(ah, bh);
+                __mmask8 result;
+                if (Op == EQUAL){
+                    result = high_equal & _mm512_cmpeq_epu64_mask(al, bl);
+                }
+                else if (Op == LESS){
+                    result = _mm512_cmplt_epu64_mask(ah, bh) | (high_equal & _mm512_cmplt_epu64_mask(al, bl));
+                }
+                else{
+                    result = _mm512_cmplt_epu64_mask(bh, ah) | (high_equal & _mm512_cmplt_epu64_mask(bl, al));
+                }
+                for(unsigned j = 0; j < 8; j++){
+                    out[i + j] = (result >> j) & 1;
+                }
+            }
+            return i;
+        }
+#endif
+
+#if defined(_UINT128_SOA_AVX2)
+        template <bool Scalar>
+        _UINT128_T_TARGET_AVX2 static __m256i load256(const uint64_t * p, const std::size_t i){
+            return Scalar?_mm256_set1_epi64x(static_cast <long long> (*p)):_mm256_loadu_si256(reinterpret_cast <const __m256i *> (p + i));
+        }
+
+        // unsigned a > b for 64-bit lanes, from the signed compare
+        _UINT128_T_TARGET_AVX2 static __m256i greater_epu64(const __m256i a, const __m256i b){
+            const __m256i sign = _mm256_set1_epi64x(static_cast <long long> (0x8000000000000000ULL));
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+        }
+
+        template <bool Scalar>
+        _UINT128_T_TARGET_AVX2 static std::size_t add_avx2(uint64_t * h, uint64_t * l, const uint64_t * rhs_hi, const uint64_t * rhs_lo, const std::size_t n, std::size_t i){
+            for(; i + 4 <= n; i += 4){
+                const __m256i a = _mm256_load_si256(reinterpret_cast <const __m256i *> (l + i));
+                const __m256i sum = _mm256_add_epi64(a, load256 <Scalar> (rhs_lo, i));
+                const __m256i carry = greater_epu64(a, sum);      // all ones where the low half wrapped
+                const __m256i high = _mm256_add_epi64(_mm256_load_si256(reinterpret_cast <const __m256i *> (h + i)), load256 <Scalar> (rhs_hi, i));
+                _mm256_store_si256(reinterpret_cast <__m256i *> (l + i), sum);
+                _mm256_store_si256(reinterpret_cast <__m256i *> (h + i), _mm256_sub_epi64(high, carry));
+            }
+            return i;
+        }
+
+        template <bool Scalar>
+        _UINT128_T_TARGET_AVX2 static std::size_t sub_avx2(uint64_t * h, uint64_t * l, const uint64_t * rhs_hi, const uint64_t * rhs_lo, const std::size_t n, std::size_t i){
+            for(; i + 4 <= n; i += 4){
+                const __m256i a = _mm256_load_si256(reinterpret_cast <const __m256i *> (l + i));
+                const __m256i b = load256 <Scalar> (rhs_lo, i);
+                const __m256i borrow = greater_epu64(b, a);       // all ones where the low half wrapped
+                const __m256i high = _mm256_sub_epi64(_mm256_load_si256(reinterpret_cast <const __m256i *> (h + i)), load256 <Scalar> (rhs_hi, i));
+                _mm256_store_si256(reinterpret_cast <__m256i *> (l + i), _mm256_sub_epi64(a, b));
+                _mm256_store_si256(reinterpret_cast <__m256i *> (h + i), _mm256_add_epi64(high, borrow));
+            }
+            return i;
+        }
+
+        template <bool Max>
+        _UINT128_T_TARGET_AVX2 static std::size_t select_avx2(uint64_t * h, uint64_t * l, const uint64_t * rh, const uint64_t * rl, const std::size_t n, std::size_t i){
+            for(; i + 4 <= n; i += 4){
+                const __m256i ah = _mm256_load_si256(reinterpret_cast <const __m256i *> (h + i));
+                const __m256i al = _mm256_load_si256(reinterpret_cast <const __m256i *> (l + i));
+                const __m256i bh = _mm256_load_si256(reinterpret_cast <const __m256i *> (rh + i));
+                const __m256i bl = _mm256_load_si256(reinterpret_cast <const __m256i *> (rl + i));
+                const __m256i take = Max?_mm256_or_si256(greater_epu64(bh, ah), _mm256_and_si256(_mm256_cmpeq_epi64(ah, bh), greater_epu64(bl, al)))
+                                        :_mm256_or_si256(greater_epu64(ah, bh), _mm256_and_si256(_mm256_cmpeq_epi64(ah, bh), greater_epu64(al, bl)));
+                _mm256_store_si256(reinterpret_cast <__m256i *> (h + i), _mm256_blendv_epi8(ah, bh, take));
+                _mm256_store_si256(reinterpret_cast <__m256i *> (l + i), _mm256_blendv_epi8(al, bl, take));
+            }
+            return i;
+        }
+
+        template <comparison Op, bool Scalar>
+        _UINT128_T_TARGET_AVX2 static std::size_t compare_avx2(const uint64_t * h, const uint64_t * l, const uint64_t * rhs_hi, const uint64_t * rhs_lo, uint8_t * out, const std::size_t n, std::size_t i){
+            for(; i + 4 <= n; i += 4){
+                const __m256i ah = _mm256_load_si256(reinterpret_cast <const __m256i *> (h + i));
+                const __m256i al = _mm256_load_si256(reinterpret_cast <const __m256i *> (l + i));
+                const __m256i bh = load256 <Scalar> (rhs_hi, i), bl = load256 <Scalar> (rhs_lo, i);
+                const __m256i high_equal = _mm256_cmpeq_epi64(ah, bh);
+                __m256i result;
+                if (Op == EQUAL){
+                    result = _mm256_and_si256(high_equal, _mm256_cmpeq_epi64(al, bl));
+                }
+                else if (Op == LESS){
+                    result = _mm256_or_si256(greater_epu64(bh, ah), _mm256_and_si256(high_equal, greater_epu64(bl, al)));
+                }
+                else{
+                    result = _mm256_or_si256(greater_epu64(ah, bh), _mm256_and_si256(high_equal, greater_epu64(al, bl)));
+                }
+                const int bits = _mm256_movemask_pd(_mm256_castsi256_pd(result));
+                for(unsigned j = 0; j < 4; j++){
+                    out[i + j] = (bits >> j) & 1;
+                }
+            }
+            return i;
+        }
+#endif
+
+        template <bool Scalar>
+        void add(const uint64_t * rhs_hi, const uint64_t * rhs_lo){
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            const std::size_t n = size();
+            std::size_t i = 0;
+#if defined(_UINT128_SOA_AVX512)
+            if (uint128_dispatch_has(UINT128_CPU_AVX512)){
+                i = add_avx512 <Scalar> (h, l, rhs_hi, rhs_lo, n, i);
+            }
+#endif
+#if defined(_UINT128_SOA_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = add_avx2 <Scalar> (h, l, rhs_hi, rhs_lo, n, i);
+            }
+#endif
+            for(; i < n; i++){
+                const uint64_t sum = l[i] + at <Scalar> (rhs_lo, i);
+                h[i] += at <Scalar> (rhs_hi, i) + (sum < l[i]);
+                l[i] = sum;
+            }
+        }
+
+        template <bool Scalar>
+        void sub(const uint64_t * rhs_hi, const uint64_t * rhs_lo){
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            const std::size_t n = size();
+            std::size_t i = 0;
+#if defined(_UINT128_SOA_AVX512)
+            if (uint128_dispatch_has(UINT128_CPU_AVX512)){
+                i = sub_avx512 <Scalar> (h, l, rhs_hi, rhs_lo, n, i);
+            }
+#endif
+#if defined(_UINT128_SOA_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = sub_avx2 <Scalar> (h, l, rhs_hi, rhs_lo, n, i);
+            }
+#endif
+            for(; i < n; i++){
+                const uint64_t b = at <Scalar> (rhs_lo, i);
+                h[i] -= at <Scalar> (rhs_hi, i) + (l[i] < b);
+                l[i] -= b;
+            }
+        }
+
+        // stride 0 applies the same right hand side to every element
+        template <typename F>
+        void bitwise(const uint64_t * rhs_hi, const uint64_t * rhs_lo, const std::size_t stride, F f){
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            for(std::size_t i = 0; i < size(); i++){
+                h[i] = f(h[i], rhs_hi[i * stride]);
+                l[i] = f(l[i], rhs_lo[i * stride]);
+            }
+        }
+
+        // keep this[i] unless rhs[i] is smaller (Max: larger)
+        template <bool Max>
+        void select(const uint128_soa_vector & rhs){
+            uint64_t * h = hi.data();
+            uint64_t * l = lo.data();
+            const uint64_t * rh = rhs.hi.data();
+            const uint64_t * rl = rhs.lo.data();
+            const std::size_t n = size();
+            std::size_t i = 0;
+#if defined(_UINT128_SOA_AVX512)
+            if (uint128_dispatch_has(UINT128_CPU_AVX512)){
+                i = select_avx512 <Max> (h, l, rh, rl, n, i);
+            }
+#endif
+#if defined(_UINT128_SOA_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = select_avx2 <Max> (h, l, rh, rl, n, i);
+            }
+#endif
+            for(; i < n; i++){
+                const bool take = Max?((h[i] < rh[i]) | ((h[i] == rh[i]) & (l[i] < rl[i])))
+                                     :((rh[i] < h[i]) | ((h[i] == rh[i]) & (rl[i] < l[i])));
+                h[i] = take?rh[i]:h[i];
+                l[i] = take?rl[i]:l[i];
+            }
+        }
+
+        template <comparison Op, bool Scalar>
+        void compare(const uint64_t * rhs_hi, const uint64_t * rhs_lo, uint8_t * out) const{
+            const uint64_t * h = hi.data();
+            const uint64_t * l = lo.data();
+            const std::size_t n = size();
+            std::size_t i = 0;
+#if defined(_UINT128_SOA_AVX512)
+            if (uint128_dispatch_has(UINT128_CPU_AVX512)){
+                i = compare_avx512 <Op, Scalar> (h, l, rhs_hi, rhs_lo, out, n, i);
+            }
+#endif
+#if defined(_UINT128_SOA_AVX2)
+            if (uint128_dispatch_has(UINT128_CPU_AVX2)){
+                i = compare_avx2 <Op, Scalar> (h, l, rhs_hi, rhs_lo, out, n, i);
+            }
+#endif
+            for(; i < n; i++){
+                const uint64_t bh = at <Scalar> (rhs_hi, i), bl = at <Scalar> (rhs_lo, i);
+                if (Op == EQUAL){
+                    out[i] = (h[i] == bh) & (l[i] == bl);
+                }
+                else if (Op == LESS){
+                    out[i] = (h[i] < bh) | ((h[i] == bh) & (l[i] < bl));
+                }
+                else{
+                    out[i] = (bh < h[i]) | ((h[i] == bh) & (bl < l[i]));
+                }
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+uint128_sort.h
+LSD radix sort for arrays of uint128_t
+
+Keys are split into 16 byte-wide digits that are read straight out of upper() and lower().
+One pass builds the histograms of all 16 digits; digits that have the same value across
+the whole input (the top bytes of small or clustered keys, for example) are skipped, so
+sorting 64-bit ids stored in uint128_t costs at most 8 scatter passes.
+
+The sort is stable. The key/value version moves each value along with its key.
+With more than one thread, every pass builds one histogram per thread chunk, and each
+thread scatters its own chunk into disjoint output ranges.
+*/
+
+#ifndef __UINT128_SORT__
+#define __UINT128_SORT__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "uint128_parallel.h"
+#include "uint128_t.h"
+
+class uint128_radix{
+    public:
+        static const unsigned DIGITS = 16;
+        static const std::size_t BUCKETS = 256;
+
+        // below this many keys per thread, extra threads cost more than they save
+        static const std::size_t MIN_PER_THREAD = 1 << 16;
+
+        static unsigned digit(const uint128_t & key, const unsigned d){
+            return static_cast <unsigned> (((d < 8)?(key.lower() >> (8 * d)):(key.upper() >> (8 * (d - 8)))) & 0xff);
+        }
+
+        // all 16 histograms in one pass
+        // counts holds DIGITS consecutive histograms
+        static void count_all(const uint128_t * keys, const std::size_t begin, const std::size_t end, std::size_t * counts){
+            for(std::size_t i = begin; i < end; i++){
+                const uint64_t lo = keys[i].lower();
+                const uint64_t hi = keys[i].upper();
+                for(unsigned d = 0; d < 8; d++){
+                    counts[d * BUCKETS + ((lo >> (8 * d)) & 0xff)]++;
+                    counts[(d + 8) * BUCKETS + ((hi >> (8 * d)) & 0xff)]++;
+                }
+            }
+        }
+
+        static void count(const uint128_t * keys, const std::size_t begin, const std::size_t end, const unsigned d, std::size_t * counts){
+            for(std::size_t i = begin; i < end; i++){
+                counts[digit(keys[i], d)]++;
+            }
+        }
+
+        // a digit is useless if every key falls into the same bucket
+        static bool constant(const std::size_t * counts, const std::size_t n){
+            for(std::size_t b = 0; b < BUCKETS; b++){
+                if (counts[b]){
+                    return counts[b] == n;
+                }
+            }
+            return true;
+        }
+
+        template <bool HasValues, typename V>
+        static void scatter(const uint128_t * src, V * src_values, uint128_t * dst, V * dst_values,
+                            const std::size_t begin, const std::size_t end, const unsigned d, std::size_t * offsets){
+            for(std::size_t i = begin; i < end; i++){
+                const std::size_t to = offsets[digit(src[i], d)]++;
+                dst[to] = src[i];
+                if (HasValues){
+                    dst_values[to] = std::move(src_values[i]);
+                }
+            }
+        }
+
+        template <bool HasValues, typename V>
+        static void sort(uint128_t * keys, V * values, const std::size_t n, const unsigned requested){
+            if (n < 2){
+                return;
+            }
+
+            const unsigned threads = uint128_parallel_threads(requested, n / MIN_PER_THREAD);
+
+            // per thread histograms of every digit
+            std::vector <std::size_t> counts(threads * DIGITS * BUCKETS, 0);
+            const auto hist = [&counts](const unsigned t, const unsigned d){
+                return counts.data() + (t * DIGITS + d) * BUCKETS;
+            };
+            uint128_parallel_for(n, threads, [&](const unsigned t, const std::size_t begin, const std::size_t end){
+                count_all(keys, begin, end, hist(t, 0));
+            });
+
+            std::vector <unsigned> active;
+            for(unsigned d = 0; d < DIGITS; d++){
+                std::size_t total[BUCKETS] = {0};
+                for(unsigned t = 0; t < threads; t++){
+                    for(std::size_t b = 0; b < BUCKETS; b++){
+                        total[b] += hist(t, d)[b];
+                    }
+                }
+                if (!constant(total, n)){
+                    active.push_back(d);
+                }
+            }
+            if (active.empty()){
+                return;
+            }
+
+            std::vector <uint128_t> key_buffer(n);
+            std::vector <V> value_buffer(HasValues?n:0);
+            uint128_t * src = keys;
+            uint128_t * dst = key_buffer.data();
+            V * src_values = values;
+            V * dst_values = value_buffer.data();
+
+            std::vector <std::size_t> offsets(threads * BUCKETS);
+            for(std::size_t p = 0; p < active.size(); p++){
+                const unsigned d = active[p];
+
+                // the counts from the first pass only describe the original order
+                if (p){
+                    uint128_parallel_for(n, threads, [&](const unsigned t, const std::size_t begin, const std::size_t end){
+                        std::fill(hist(t, d), hist(t, d) + BUCKETS, 0);
+                        count(src, begin, end, d, hist(t, d));
+                    });
+                }
+
+                // bucket b of thread t starts after all smaller buckets and after bucket b of earlier threads
+                std::size_t sum = 0;
+                for(std::size_t b = 0; b < BUCKETS; b++){
+                    for(unsigned t = 0; t < threads; t++){
+                        offsets[t * BUCKETS + b] = sum;
+                        sum += hist(t, d)[b];
+                    }
+                }
+
+                uint128_parallel_for(n, threads, [&](const unsigned t, const std::size_t begin, const std::size_t end){
+                    scatter <HasValues> (src, src_values, dst, dst_values, begin, end, d, &offsets[t * BUCKETS]);
+                });
+
+                std::swap(src, dst);
+                std::swap(src_values, dst_values);
+            }
+
+            // odd number of passes: the result is in the buffer
+            if (src != keys){
+                std::copy(src, src + n, keys);
+                if (HasValues){
+                    std::move(src_values, src_values + n, values);
+                }
+            }
+        }
+};
+
+// Sort keys[0, n) in ascending order. threads = 0 uses every hardware thread.
+inline void radix_sort(uint128_t * keys, const std::size_t n, const unsigned threads = 1){
+    uint128_radix::sort <false, char> (keys, nullptr, n, threads);
+}
+
+inline void radix_sort(std::vector <uint128_t> & keys, const unsigned threads = 1){
+    radix_sort(keys.data(), keys.size(), threads);
+}
+
+// Sort keys[0, n) in ascending order and apply the same permutation to values[0, n).
+// V must be default constructible and move assignable.
+template <typename V>
+void radix_sort(uint128_t * keys, V * values, const std::size_t n, const unsigned threads = 1){
+    uint128_radix::sort <true, V> (keys, values, n, threads);
+}
+
+#endif
@@ -0,0 +1,257 @@
+/*
+uint128_static_index.h
+Read-only search index over a sorted set of uint128_t keys
+
+The keys are stored in Eytzinger (BFS heap) order: the children of node k are 2k and 2k + 1.
+A search walks down from the root without branching on the comparison, and since the 8
+descendants of node k three levels down sit next to each other at 8k, one prefetch per
+level keeps the memory loads for the next three levels in flight.
+
+Upper and lower halves live in separate 64 byte aligned arrays, so the 8 descendants that one
+prefetch targets fill exactly one cache line in each array. The comparison does not branch,
+so every step reads both halves of its node, and each level prefetches both lines.
+
+Positions returned by the queries are indices into the sorted input, like
+std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin().
+*/
+
+#ifndef __UINT128_STATIC_INDEX__
+#define __UINT128_STATIC_INDEX__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "uint128_t.h"
+
+class uint128_static_index{
+    public:
+        uint128_static_index()
+            : n(0), depth(0), upper(nullptr), lower(nullptr)
+        {}
+
+        // sorted must be in ascending order; duplicates are allowed
+        explicit uint128_static_index(const std::vector <uint128_t> & sorted)
+            : n(sorted.size()), depth(0), upper(nullptr), lower(nullptr)
+        {
+            for(std::size_t i = 1; i < n; i++){
+                if (sorted[i] < sorted[i - 1]){
+                    throw std::invalid_argument("Error: keys are not sorted");
+                }
+            }
+
+            depth = n?log2(n):0;
+
+            // index 0 is unused; pad so both arrays start on a cache line
+            storage.resize(2 * (n + 1) + 2 * LINE);
+            upper = align(storage.data());
+            lower = align(upper + n + 1);
+
+            std::size_t next = 0;
+            fill(sorted, 1, next);
+        }
+
+        // moving the vector keeps its buffer, so the halves stay valid; rhs is left empty
+        uint128_static_index(uint128_static_index && rhs)
+            : n(rhs.n), depth(rhs.depth), storage(std::move(rhs.storage)), upper(rhs.upper), lower(rhs.lower)
+        {
+            rhs.clear();
+        }
+
+        uint128_static_index & operator=(uint128_static_index && rhs){
+            if (this != &rhs){
+                n = rhs.n;
+                depth = rhs.depth;
+                storage = std::move(rhs.storage);
+                upper = rhs.upper;
+                lower = rhs.lower;
+                rhs.clear();
+            }
+            return *this;
+        }
+
+        // the halves point into storage
+        uint128_static_index(const uint128_static_index & rhs) = delete;
+        uint128_static_index & operator=(const uint128_static_index & rhs) = delete;
+
+        std::size_t size() const{
+            return n;
+        }
+
+        // position of the first key >= x (size() if there is none)
+        std::size_t lower_bound(const uint128_t & x) const{
+            return rank(search <false> (x.upper(), x.lower()));
+        }
+
+        // position of the first key > x (size() if there is none)
+        std::size_t upper_bound(const uint128_t & x) const{
+            return rank(search <true> (x.upper(), x.lower()));
+        }
+
+        bool contains(const uint128_t & x) const{
+            const std::size_t k = search <false> (x.upper(), x.lower());
+            return k && (upper[k] == x.upper()) && (lower[k] == x.lower());
+        }
+
+        // number of keys in [lo, hi)
+        std::size_t count(const uint128_t & lo, const uint128_t & hi) const{
+            if (!(lo < hi)){
+                return 0;
+            }
+            return lower_bound(hi) - lower_bound(lo);
+        }
+
+        // appends the keys in [lo, hi) to out in ascending order
+        void range(const uint128_t & lo, const uint128_t & hi, std::vector <uint128_t> & out) const{
+            for(std::size_t k = search <false> (lo.upper(), lo.lower()); k && less(upper[k], lower[k], hi.upper(), hi.lower()); k = successor(k)){
+                out.push_back(uint128_t(upper[k], lower[k]));
+            }
+        }
+
+        // lower_bound for count keys at once; BATCH searches are interleaved so their cache misses overlap
+        void lower_bound(const uint128_t * x, const std::size_t count, std::size_t * out) const{
+            if (!n){
+                std::fill(out, out + count, 0);
+                return;
+            }
+
+            for(std::size_t i = 0; i < count; i += BATCH){
+                const std::size_t m = (count - i < BATCH)?(count - i):BATCH;
+                std::size_t k[BATCH];
+                std::fill(k, k + m, 1);
+
+                // every search takes depth + 1 steps except those that fall off the incomplete last level
+                for(unsigned level = 0; level <= depth; level++){
+                    for(std::size_t j = 0; j < m; j++){
+                        const std::size_t node = (k[j] <= n)?k[j]:0;
+                        _UINT128_T_PREFETCH(upper + std::min(node * 8, n));
+                        _UINT128_T_PREFETCH(lower + std::min(node * 8, n));
+                        const std::size_t next = 2 * node + less(upper[node], lower[node], x[i + j].upper(), x[i + j].lower());
+                        k[j] = node?next:k[j];
+                    }
+                }
+
+                for(std::size_t j = 0; j < m; j++){
+                    out[i + j] = rank(k[j] >> (trailing_ones(k[j]) + 1));
+                }
+            }
+        }
+
+    private:
+        static const std::size_t LINE = 64 / sizeof(uint64_t);
+        static const std::size_t BATCH = 16;
+
+        void clear(){
+            n = 0;
+            depth = 0;
+            storage.clear();
+            upper = nullptr;
+            lower = nullptr;
+        }
+
+        std::size_t n;
+        unsigned depth;                 // depth of the deepest level; the root is at depth 0
+        std::vector <uint64_t> storage;
+        uint64_t * upper;
+        uint64_t * lower;
+
+        static uint64_t * align(uint64_t * ptr){
+            const uintptr_t addr = reinterpret_cast <uintptr_t> (ptr);
+            return ptr + (((64 - (addr & 63)) & 63) / sizeof(uint64_t));
+        }
+
+        static unsigned log2(std::size_t x){
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(static_cast <unsigned long long> (x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64))
+            unsigned long index;
+            _BitScanReverse64(&index, x);
+            return index;
+#else
+            unsigned out = 0;
+            while (x >>= 1){
+                out++;
+            }
+            return out;
+#endif
+        }
+
+        static unsigned trailing_ones(std::size_t x){
+#if defined(__GNUC__)
+            return __builtin_ctzll(~static_cast <unsigned long long> (x));
+#else
+            unsigned out = 0;
+            while (x & 1){
+                x >>= 1;
+                out++;
+            }
+            return out;
+#endif
+        }
+
+        static bool less(const uint64_t lhs_upper, const uint64_t lhs_lower, const uint64_t rhs_upper, const uint64_t rhs_lower){
+            return (lhs_upper < rhs_upper) | ((lhs_upper == rhs_upper) & (lhs_lower < rhs_lower));
+        }
+
+        static bool less_equal(const uint64_t lhs_upper, const uint64_t lhs_lower, const uint64_t rhs_upper, const uint64_t rhs_lower){
+            return (lhs_upper < rhs_upper) | ((lhs_upper == rhs_upper) & (lhs_lower <= rhs_lower));
+        }
+
+        // in-order fill
+        void fill(const std::vector <uint128_t> & sorted, const std::size_t k, std::size_t & next){
+            if (k <= n){
+                fill(sorted, 2 * k, next);
+                upper[k] = sorted[next].upper();
+                lower[k] = sorted[next].lower();
+                next++;
+                fill(sorted, 2 * k + 1, next);
+            }
+        }
+
+        // Eytzinger index of the first key >= x (> x when Upper), or 0 if there is none
+        template <bool Upper>
+        std::size_t search(const uint64_t x_upper, const uint64_t x_lower) const{
+            std::size_t k = 1;
+            while (k <= n){
+                _UINT128_T_PREFETCH(upper + std::min(k * 8, n));
+                _UINT128_T_PREFETCH(lower + std::min(k * 8, n));
+                k = 2 * k + (Upper?less_equal(upper[k], lower[k], x_upper, x_lower):less(upper[k], lower[k], x_upper, x_lower));
+            }
+            // undo the right turns taken after the last left turn
+            return k >> (trailing_ones(k) + 1);
+        }
+
+        // Position of node k in sorted order: its in-order rank in the full tree of this depth,
+        // minus the nodes missing from the last level that would have come before it.
+        std::size_t rank(const std::size_t k) const{
+            if (!k){
+                return n;
+            }
+            const unsigned d = log2(k);
+            const unsigned below = depth - d;
+            const std::size_t full = ((k - (static_cast <std::size_t> (1) << d)) << (below + 1)) + (static_cast <std::size_t> (1) << below) - 1;
+            // last level slots that come before k in order are those below this index
+            const std::size_t before = below?((k << below) + (static_cast <std::size_t> (1) << (below - 1))):k;
+            return full - ((before > n + 1)?(before - n - 1):0);
+        }
+
+        std::size_t successor(std::size_t k) const{
+            if (2 * k + 1 <= n){
+                k = 2 * k + 1;
+                while (2 * k <= n){
+                    k = 2 * k;
+                }
+                return k;
+            }
+            return k >> (trailing_ones(k) + 1);
+        }
+};
+
+#endif
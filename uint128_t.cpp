@@ -1,9 +1,401 @@
 #include "uint128_t.build"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
+#if defined(UINT128_T_STATS)
+#include <cstddef>
+#include <mutex>
+#endif
+
+#if defined(_UINT128_T_DISPATCH)
+#include <cpuid.h>
+#endif
+
+#if defined(__GNUC__)
+#define _UINT128_T_INLINE inline __attribute__((__always_inline__))
+#else
+#define _UINT128_T_INLINE inline
+#endif
+
+// Runtime CPU dispatch ////////////////////////////////////////////////////////
+
+#if defined(_UINT128_T_DISPATCH)
+static unsigned detect_features(){
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)){
+        return 0;
+    }
+    const unsigned leaf1 = ecx;
+
+    unsigned out = 0;
+    out |= (leaf1 & (1U <<  9))?UINT128_CPU_SSSE3:0;
+    out |= (leaf1 & (1U << 23))?UINT128_CPU_POPCNT:0;
+
+    if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)){
+        out |= (ecx & (1U << 5))?UINT128_CPU_LZCNT:0;
+    }
+
+    // the vector registers count only if the OS saves them: XCR0 has the YMM state (bits 1 and 2),
+    // and for AVX-512 also the opmask and ZMM state (bits 5 to 7)
+    uint64_t xcr0 = 0;
+    if ((leaf1 & (1U << 27)) && (leaf1 & (1U << 28))){
+        uint32_t lo, hi;
+        __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        xcr0 = (static_cast <uint64_t> (hi) << 32) | lo;
+    }
+
+    if (__get_cpuid_max(0, nullptr) >= 7){
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        out |= (ebx & (1U <<  8))?UINT128_CPU_BMI2:0;
+        out |= (ebx & (1U << 19))?UINT128_CPU_ADX:0;
+        const bool avx2 = (ebx & (1U << 5)) && ((xcr0 & 0x06) == 0x06);
+        out |= avx2?UINT128_CPU_AVX2:0;
+        const unsigned avx512 = (1U << 16) | (1U << 17) | (1U << 28) | (1U << 30) | (1U << 31);     // F, DQ, CD, BW, VL
+        out |= (avx2 && ((ebx & avx512) == avx512) && ((xcr0 & 0xe6) == 0xe6))?UINT128_CPU_AVX512:0;
+    }
+    return out;
+}
+#else
+// the extensions the compiler targets
+static unsigned detect_features(){
+    unsigned out = 0;
+#if defined(__SSSE3__) || defined(__AVX__)
+    out |= UINT128_CPU_SSSE3;
+#endif
+#if defined(__POPCNT__) || defined(__AVX__)
+    out |= UINT128_CPU_POPCNT;
+#endif
+#if defined(__LZCNT__) || defined(__AVX2__)
+    out |= UINT128_CPU_LZCNT;
+#endif
+#if defined(__BMI2__) || defined(__AVX2__)
+    out |= UINT128_CPU_BMI2;
+#endif
+#if defined(__ADX__)
+    out |= UINT128_CPU_ADX;
+#endif
+#if defined(__AVX2__)
+    out |= UINT128_CPU_AVX2;
+#endif
+#if defined(__AVX512F__) && defined(__AVX512CD__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+    out |= UINT128_CPU_AVX512;
+#endif
+    return out;
+}
+#endif
+
+static const unsigned BMI2_FEATURES   = UINT128_CPU_SSSE3 | UINT128_CPU_POPCNT | UINT128_CPU_LZCNT | UINT128_CPU_BMI2 | UINT128_CPU_ADX;
+static const unsigned AVX2_FEATURES   = BMI2_FEATURES | UINT128_CPU_AVX2;
+static const unsigned AVX512_FEATURES = AVX2_FEATURES | UINT128_CPU_AVX512;
+
+// not yet initialized
+static const unsigned UNSET = ~0U;
+
+static std::atomic <unsigned> DISPATCH(UNSET);
+
+unsigned uint128_cpu_features(){
+    static const unsigned features = detect_features();
+    return features;
+}
+
+unsigned uint128_dispatch_features(){
+    unsigned features = DISPATCH.load(std::memory_order_relaxed);
+    if (features == UNSET){
+        features = uint128_cpu_features();
+        if (const char * env = std::getenv("UINT128_T_DISPATCH")){
+            const struct{
+                const char * name;
+                unsigned features;
+            } LEVELS[] = {
+                {"baseline", 0},
+                {"bmi2",     BMI2_FEATURES},
+                {"avx2",     AVX2_FEATURES},
+                {"avx512",   AVX512_FEATURES},
+            };
+            for(const auto & level : LEVELS){
+                if (!std::strcmp(env, level.name)){
+                    features &= level.features;
+                }
+            }
+        }
+        // threads that get here together store the same value
+        DISPATCH.store(features, std::memory_order_relaxed);
+    }
+    return features;
+}
+
+unsigned uint128_set_dispatch(const unsigned features){
+    const unsigned out = features & uint128_cpu_features();
+    DISPATCH.store(out, std::memory_order_relaxed);
+    return out;
+}
+
+const char * uint128_dispatch_name(){
+    const unsigned features = uint128_dispatch_features();
+    if (features & UINT128_CPU_AVX512){
+        return "avx512";
+    }
+    if (features & UINT128_CPU_AVX2){
+        return "avx2";
+    }
+    if ((features & (UINT128_CPU_BMI2 | UINT128_CPU_ADX)) == (UINT128_CPU_BMI2 | UINT128_CPU_ADX)){
+        return "bmi2";
+    }
+    return "baseline";
+}
+
+#if defined(UINT128_T_STATS)
+static const std::size_t STATS_COUNTERS = sizeof(uint128_stats) / sizeof(uint64_t);
+
+// One thread's counts. Only that thread adds to them, so a relaxed load and store is enough (no
+// locked add); they are atomic so that snapshots from other threads can read them.
+struct stats_slot{
+    std::atomic <uint64_t> counts[STATS_COUNTERS];
+
+    stats_slot();
+    ~stats_slot();
+
+    void add(const std::size_t i){
+        counts[i].store(counts[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+};
+
+struct stats_registry{
+    std::mutex mutex;
+    std::vector <stats_slot *> threads;
+    uint64_t exited[STATS_COUNTERS];       // counts of threads that have finished
+};
+
+static stats_registry & registry(){
+    static stats_registry r;
+    return r;
+}
+
+stats_slot::stats_slot(){
+    for(std::atomic <uint64_t> & c : counts){
+        c.store(0, std::memory_order_relaxed);
+    }
+    stats_registry & r = registry();
+    std::lock_guard <std::mutex> lock(r.mutex);
+    r.threads.push_back(this);
+}
+
+stats_slot::~stats_slot(){
+    stats_registry & r = registry();
+    std::lock_guard <std::mutex> lock(r.mutex);
+    for(std::size_t i = 0; i < STATS_COUNTERS; i++){
+        r.exited[i] += counts[i].load(std::memory_order_relaxed);
+    }
+    r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+}
+
+static stats_slot & stats(){
+    static thread_local stats_slot slot;
+    return slot;
+}
+
+#define _UINT128_T_STAT(field, i) stats().add(offsetof(uint128_stats, field) / sizeof(uint64_t) + static_cast <std::size_t> (i))
+
+uint128_stats uint128_stats_snapshot(){
+    uint64_t sum[STATS_COUNTERS];
+    stats_registry & r = registry();
+    {
+        std::lock_guard <std::mutex> lock(r.mutex);
+        for(std::size_t i = 0; i < STATS_COUNTERS; i++){
+            sum[i] = r.exited[i];
+            for(const stats_slot * slot : r.threads){
+                sum[i] += slot->counts[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    uint128_stats out;
+    std::memcpy(&out, sum, sizeof(out));
+    return out;
+}
+
+// a thread counting while this runs may put back the count it had just read
+void uint128_stats_reset(){
+    stats_registry & r = registry();
+    std::lock_guard <std::mutex> lock(r.mutex);
+    for(std::size_t i = 0; i < STATS_COUNTERS; i++){
+        r.exited[i] = 0;
+        for(stats_slot * slot : r.threads){
+            slot->counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+template <std::size_t N>
+static void dump_list(std::ostream & out, const char * name, const uint64_t (&counts)[N]){
+    out << "\"" << name << "\": [";
+    for(std::size_t i = 0; i < N; i++){
+        out << (i?", ":"") << counts[i];
+    }
+    out << "]";
+}
+
+void uint128_stats_dump(std::ostream & out){
+    static const char * const PATHS[uint128_stats::DIVMOD_PATHS] = {
+        "by_zero",
+        "by_one",
+        "equal",
+        "smaller",
+        "power_of_2",
+        "64",
+        "full",
+    };
+
+    const uint128_stats s = uint128_stats_snapshot();
+    out << "{\"divmod\": {";
+    for(std::size_t i = 0; i < uint128_stats::DIVMOD_PATHS; i++){
+        out << (i?", ":"") << "\"" << PATHS[i] << "\": " << s.divmod[i];
+    }
+    out << "}, ";
+    dump_list(out, "divisor_bits", s.divisor_bits);
+    out << ", ";
+    dump_list(out, "bits", s.bits);
+    out << ", ";
+    dump_list(out, "str_digits", s.str_digits);
+    out << ", ";
+    dump_list(out, "parse_base", s.parse_base);
+    out << "}";
+}
+#else
+#define _UINT128_T_STAT(field, i)
+#endif
+
+// Division and formatting on 64-bit words. The bodies are always inlined into one wrapper per target
+// below, so the BMI2 wrappers get lzcnt, mulx and shlx/shrx in place of bsr, mul and shifts by cl.
+
+// x != 0
+static _UINT128_T_INLINE unsigned leading_zeros(const uint64_t x){
+#if defined(__GNUC__)
+    return __builtin_clzll(static_cast <unsigned long long> (x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - index;
+#else
+    unsigned out = 0;
+    for(uint64_t y = x; !(y >> 63); y <<= 1){
+        out++;
+    }
+    return out;
+#endif
+}
+
+// number of significant bits in (hi, lo)
+static _UINT128_T_INLINE uint8_t width(const uint64_t hi, const uint64_t lo){
+    if (hi){
+        return static_cast <uint8_t> (128 - leading_zeros(hi));
+    }
+    if (lo){
+        return static_cast <uint8_t> (64 - leading_zeros(lo));
+    }
+    return 0;
+}
+
+// (n1, n0) / (d1, d0) for a nonzero divisor, most significant words first
+static _UINT128_T_INLINE void divide(const uint64_t n1, const uint64_t n0, const uint64_t d1, const uint64_t d0, uint64_t * q, uint64_t * r){
+    if (!d1){
+        // two 128 / 64 bit steps; the first has an upper word of 0
+        const uint64_t q1 = n1 / d0;
+        q[0] = q1;
+        q[1] = uint128_t::divlong64(n1 - q1 * d0, n0, d0, &r[1]);
+        r[0] = 0;
+        return;
+    }
+
+    // The quotient fits in a word. Dividing n / 2 by the top 64 bits of the normalized divisor
+    // gives an estimate that is exact or 1 too large after scaling back (Hacker's Delight, 9-5).
+    const unsigned s = leading_zeros(d1);
+    const uint64_t v1 = s?((d1 << s) | (d0 >> (64 - s))):d1;
+    uint64_t unused;
+    uint64_t qhat = uint128_t::divlong64(n1 >> 1, (n0 >> 1) | (n1 << 63), v1, &unused) >> (63 - s);
+    if (qhat){
+        qhat--;
+    }
+
+    // n - qhat * d, which is less than 2 * d
+    uint64_t ph;
+    const uint64_t pl = uint128_t::multlong64(qhat, d0, &ph);
+    ph += qhat * d1;
+    uint64_t rl = n0 - pl;
+    uint64_t rh = n1 - ph - (n0 < pl);
+    if ((rh > d1) || ((rh == d1) && (rl >= d0))){
+        qhat++;
+        rh -= d1 + (rl < d0);
+        rl -= d0;
+    }
+    q[0] = 0;
+    q[1] = qhat;
+    r[0] = rh;
+    r[1] = rl;
+}
+
+static void divide_baseline(const uint64_t n1, const uint64_t n0, const uint64_t d1, const uint64_t d0, uint64_t * q, uint64_t * r){
+    divide(n1, n0, d1, d0, q, r);
+}
+
+#if defined(_UINT128_T_DISPATCH)
+_UINT128_T_TARGET_BMI2 static void divide_bmi2(const uint64_t n1, const uint64_t n0, const uint64_t d1, const uint64_t d0, uint64_t * q, uint64_t * r){
+    divide(n1, n0, d1, d0, q, r);
+}
+#endif
+
+static const char DIGITS[] = "0123456789abcdef";
+
+// writes the digits of (hi, lo) backwards, ending just before out; returns the first digit
+static _UINT128_T_INLINE char * format(uint64_t hi, uint64_t lo, const uint8_t base, char * out){
+    // the largest power of the base that fits in a word, so that the digits below it come from 64-bit arithmetic
+    uint64_t chunk = base;
+    unsigned chunk_digits = 1;
+    while (chunk <= ~0ULL / base){
+        chunk *= base;
+        chunk_digits++;
+    }
+
+    while (hi){
+        uint64_t r;
+        const uint64_t q1 = hi / chunk;
+        lo = uint128_t::divlong64(hi - q1 * chunk, lo, chunk, &r);
+        hi = q1;
+        for(unsigned i = 0; i < chunk_digits; i++){
+            *--out = DIGITS[r % base];
+            r /= base;
+        }
+    }
+    do{
+        *--out = DIGITS[lo % base];
+        lo /= base;
+    } while (lo);
+    return out;
+}
+
+// the common bases get their own copies, with division by a constant
+static char * format_baseline(const uint64_t hi, const uint64_t lo, const uint8_t base, char * out){
+    switch (base){
+        case 10: return format(hi, lo, 10, out);
+        case 16: return format(hi, lo, 16, out);
+        default: return format(hi, lo, base, out);
+    }
+}
+
+#if defined(_UINT128_T_DISPATCH)
+_UINT128_T_TARGET_BMI2 static char * format_bmi2(const uint64_t hi, const uint64_t lo, const uint8_t base, char * out){
+    switch (base){
+        case 10: return format(hi, lo, 10, out);
+        case 16: return format(hi, lo, 16, out);
+        default: return format(hi, lo, base, out);
+    }
+}
+#endif
+
 uint128_t::uint128_t(const std::string & s, uint8_t base) {
     init(s.c_str(), s.size(), base);
 }
@@ -17,6 +409,7 @@ uint128_t::uint128_t(const bool & b)
 {}
 
 void uint128_t::init(const char *s, std::size_t len, uint8_t base) {
+    _UINT128_T_STAT(parse_base, ((base == 2) || (base == 8) || (base == 10) || (base == 16))?base:0);
     if ((s == NULL) || !len || (s[0] == '\x00')){
         LOWER = UPPER = 0;
         return;
@@ -317,69 +710,7 @@ uint128_t & uint128_t::operator-=(const uint128_t & rhs){
 // multiply on the high bits.
 // This allows us to take advantage of not only compiler intrinsics but native 64-bit arithmetic.
 
-// First we define the generic multlong64 methods. These will all do basically what _umul128 does.
-
-// MSVC _umul128
-#if _UINT128_T_MULT_TYPE == _UINT128_T_MULT_MSVC
-#include <intrin.h>
-_UINT128_T_MULT_TARGET uint64_t uint128_t::multlong64(uint64_t lhs, uint64_t rhs, uint64_t *high){
-    return _umul128(lhs, rhs, high);
-}
-
-// GCC __uint128_t
-#elif _UINT128_T_MULT_TYPE == _UINT128_T_MULT_GCC
-_UINT128_T_MULT_TARGET uint64_t uint128_t::multlong64(uint64_t lhs, uint64_t rhs, uint64_t *high){
-    __uint128_t product = static_cast<__uint128_t>(lhs) * static_cast<__uint128_t>(rhs);
-    *high = static_cast<uint64_t>(product >> 64);
-    return static_cast<uint64_t>(product & 0xFFFFFFFFFFFFFFFF);
-}
-
-// Portable version
-#else
-// The double cast helps MSVC
-_UINT128_T_MULT_TARGET static inline uint64_t lower32(uint64_t val){
-    return static_cast<uint64_t>(static_cast<uint32_t>(val));
-}
-_UINT128_T_MULT_TARGET static inline uint64_t upper32(uint64_t val){
-    return static_cast<uint64_t>(static_cast<uint32_t>(val >> 32));
-}
-
-_UINT128_T_MULT_TARGET uint64_t uint128_t::multlong64(uint64_t lhs, uint64_t rhs, uint64_t *high){
-    // This is a fast yet simple grade school 2x2 long multiply.
-    // The way we add the cross products avoids the need to track 64-bit carries due to the properties
-    // of multiplying by 11 (technically 0x100000001) capping the sums at 0xFFFFFFFFFFFFFFFF, and it
-    // tries to match the powerful ARMv6's UMAAL function which was explicitly designed for
-    // multiprecision multiplication:
-    //
-    //    void umaal(uint32_t &RdLo, uint32_t &RdHi, const uint32_t Rn, const uint32_t Rm){
-    //        uint64_t product = static_cast<uint64_t>(Rn) * static_cast<uint64_t>(Rm);
-    //        product += RdLo;
-    //        product += RdHi;
-    //        RdLo = static_cast<uint32_t>(product & 0xFFFFFFFF);
-    //        RdHi = static_cast<uint32_t>(product >> 32);
-    //    }
-    //
-    // This allows a 64-bit to 128-bit multiply to be calculated in 4 instructions, ~3 cycles each.
-    //
-    // It is still fast for other platforms, though.
-    //
-    // TODO: Use better variable names
-
-    // Calculate the cross products...
-    uint64_t lo_lo = lower32(lhs) * lower32(rhs);
-    uint64_t hi_lo = upper32(lhs) * lower32(rhs);
-    uint64_t lo_hi = lower32(lhs) * upper32(rhs);
-    uint64_t hi_hi = upper32(lhs) * upper32(rhs);
-
-    // then add them together.
-    uint64_t cross = upper32(lo_lo) + lower32(hi_lo) + lo_hi;
-    uint64_t top = upper32(hi_lo) + upper32(cross) + hi_hi;
-
-    // Done
-    *high = top;
-    return (cross << 32) | (lo_lo & 0xFFFFFFFF);
-}
-#endif
+// multlong64 is defined inline in uint128_t.include.
 
 // Now we do the full 128-bit multiply.
 //
@@ -421,53 +752,177 @@ void uint128_t::export_bits(std::vector<uint8_t> &ret) const {
     ConvertToVector(ret, const_cast<const uint64_t&>(LOWER));
 }
 
+static inline void store_be64(uint8_t * out, const uint64_t val){
+    out[0] = static_cast<uint8_t>(val >> 56);
+    out[1] = static_cast<uint8_t>(val >> 48);
+    out[2] = static_cast<uint8_t>(val >> 40);
+    out[3] = static_cast<uint8_t>(val >> 32);
+    out[4] = static_cast<uint8_t>(val >> 24);
+    out[5] = static_cast<uint8_t>(val >> 16);
+    out[6] = static_cast<uint8_t>(val >> 8);
+    out[7] = static_cast<uint8_t>(val);
+}
+
+static inline uint64_t load_be64(const uint8_t * in){
+    return (static_cast<uint64_t>(in[0]) << 56) |
+           (static_cast<uint64_t>(in[1]) << 48) |
+           (static_cast<uint64_t>(in[2]) << 40) |
+           (static_cast<uint64_t>(in[3]) << 32) |
+           (static_cast<uint64_t>(in[4]) << 24) |
+           (static_cast<uint64_t>(in[5]) << 16) |
+           (static_cast<uint64_t>(in[6]) << 8)  |
+            static_cast<uint64_t>(in[7]);
+}
+
+// number of bytes needed to hold val
+static inline std::size_t significant_bytes(uint64_t val){
+    std::size_t out = 0;
+    while (val){
+        val >>= 8;
+        out++;
+    }
+    return out;
+}
+
+void uint128_t::export_key(uint8_t * out) const {
+    store_be64(out, UPPER);
+    store_be64(out + 8, LOWER);
+}
+
+uint128_t uint128_t::import_key(const uint8_t * in){
+    return uint128_t(load_be64(in), load_be64(in + 8));
+}
+
+std::size_t uint128_t::export_varkey(uint8_t * out) const {
+    const std::size_t len = UPPER?(8 + significant_bytes(UPPER)):significant_bytes(LOWER);
+
+    // write the full key and keep the tail
+    uint8_t full[UINT128_KEY_SIZE];
+    export_key(full);
+    out[0] = static_cast<uint8_t>(len);
+    std::memcpy(out + 1, full + UINT128_KEY_SIZE - len, len);
+    return len + 1;
+}
+
+std::size_t uint128_t::import_varkey(const uint8_t * in, std::size_t len, uint128_t & out){
+    if (!in || !len){
+        throw std::invalid_argument("Error: empty variable width key");
+    }
+
+    const std::size_t size = in[0];
+    if (size > UINT128_KEY_SIZE){
+        throw std::invalid_argument("Error: variable width key is too long");
+    }
+    if (len < size + 1){
+        throw std::invalid_argument("Error: variable width key is truncated");
+    }
+    // leading zeros would give a second encoding of the same value that sorts differently
+    if (size && !in[1]){
+        throw std::invalid_argument("Error: variable width key is not canonical");
+    }
+
+    uint8_t full[UINT128_KEY_SIZE] = {0};
+    std::memcpy(full + UINT128_KEY_SIZE - size, in + 1, size);
+    out = import_key(full);
+    return size + 1;
+}
+
+void uint128_t::export_keys(const uint128_t * in, std::size_t count, uint8_t * out){
+    for(std::size_t i = 0; i < count; i++, out += UINT128_KEY_SIZE){
+        in[i].export_key(out);
+    }
+}
+
+void uint128_t::import_keys(const uint8_t * in, std::size_t count, uint128_t * out){
+    for(std::size_t i = 0; i < count; i++, in += UINT128_KEY_SIZE){
+        out[i] = import_key(in);
+    }
+}
+
+std::size_t uint128_t::export_varkeys(const uint128_t * in, std::size_t count, uint8_t * out){
+    std::size_t written = 0;
+    for(std::size_t i = 0; i < count; i++){
+        written += in[i].export_varkey(out + written);
+    }
+    return written;
+}
+
+std::size_t uint128_t::import_varkeys(const uint8_t * in, std::size_t len, uint128_t * out, std::size_t count){
+    std::size_t read = 0;
+    for(std::size_t i = 0; i < count; i++){
+        read += import_varkey(in + read, len - read, out[i]);
+    }
+    return read;
+}
+
 std::pair <uint128_t, uint128_t> uint128_t::divmod(const uint128_t & lhs, const uint128_t & rhs){
     // Save some calculations /////////////////////
     if (rhs == uint128_0){
+        _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_BY_ZERO);
         throw std::domain_error("Error: division or modulus by 0");
     }
     else if (rhs == uint128_1){
+        _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_BY_ONE);
         return std::pair <uint128_t, uint128_t> (lhs, uint128_0);
     }
     else if (lhs == rhs){
+        _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_EQUAL);
         return std::pair <uint128_t, uint128_t> (uint128_1, uint128_0);
     }
     else if ((lhs == uint128_0) || (lhs < rhs)){
+        _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_SMALLER);
         return std::pair <uint128_t, uint128_t> (uint128_0, lhs);
     }
 
     // right shift shortcuts
     if(rhs.upper() == 0) {
         switch(rhs.lower()) {
-            case 2:  return std::pair <uint128_t, uint128_t> (lhs >> 1, lhs & 0b1);
-            case 4:  return std::pair <uint128_t, uint128_t> (lhs >> 2, lhs & 0b11);
-            case 8:  return std::pair <uint128_t, uint128_t> (lhs >> 3, lhs & 0b111);
-            case 16: return std::pair <uint128_t, uint128_t> (lhs >> 4, lhs & 0b1111);
+            case 2:  _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_POWER_OF_2); return std::pair <uint128_t, uint128_t> (lhs >> 1, lhs & 0b1);
+            case 4:  _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_POWER_OF_2); return std::pair <uint128_t, uint128_t> (lhs >> 2, lhs & 0b11);
+            case 8:  _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_POWER_OF_2); return std::pair <uint128_t, uint128_t> (lhs >> 3, lhs & 0b111);
+            case 16: _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_POWER_OF_2); return std::pair <uint128_t, uint128_t> (lhs >> 4, lhs & 0b1111);
         }
     }
 
+    _UINT128_T_STAT(divisor_bits, width(rhs.UPPER, rhs.LOWER));
+
     // 64-bit shortcut
     if (lhs.upper() == 0 && rhs.upper() == 0){
+        _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_64);
         return std::pair <uint128_t, uint128_t> (
                 lhs.lower() / rhs.lower(),
                 lhs.lower() % rhs.lower());
     }
 
-    std::pair <uint128_t, uint128_t> qr (uint128_0, uint128_0);
-    for(uint8_t x = lhs.bits(); x > 0; x--){
-        qr.first  <<= uint128_1;
-        qr.second <<= uint128_1;
+    _UINT128_T_STAT(divmod, uint128_stats::DIVMOD_FULL);
+    uint64_t q[2];
+    uint64_t r[2];
+#if defined(_UINT128_T_DISPATCH)
+    if (uint128_dispatch_has(UINT128_CPU_LZCNT | UINT128_CPU_BMI2)){
+        divide_bmi2(lhs.UPPER, lhs.LOWER, rhs.UPPER, rhs.LOWER, q, r);
+    }
+    else
+#endif
+    {
+        divide_baseline(lhs.UPPER, lhs.LOWER, rhs.UPPER, rhs.LOWER, q, r);
+    }
+    return std::pair <uint128_t, uint128_t> (uint128_t(q[0], q[1]), uint128_t(r[0], r[1]));
+}
 
-        if ((lhs >> (x - 1U)) & 1){
-            ++qr.second;
-        }
+// Same shape as XXH3 on 9 - 16 byte inputs: both halves are keyed, multiplied together and folded,
+// and the halves are also added back in so that a zero product does not erase the other half.
+uint64_t uint128_t::hash(const uint64_t seed) const{
+    const uint64_t lo = LOWER ^ (0xa0761d6478bd642fULL + seed);
+    const uint64_t hi = UPPER ^ (0xe7037ed1a0b428dbULL - seed);
 
-        if (qr.second >= rhs){
-            qr.second -= rhs;
-            ++qr.first;
-        }
-    }
-    return qr;
+    uint64_t high;
+    const uint64_t low = multlong64(lo, hi, &high);
+
+    uint64_t acc = ((lo << 32) | (lo >> 32)) + hi + (low ^ high);
+    acc ^= acc >> 37;
+    acc *= 0x165667919e3779f9ULL;
+    acc ^= acc >> 32;
+    return acc;
 }
 
 uint128_t uint128_t::operator/(const uint128_t & rhs) const{
@@ -516,31 +971,10 @@ uint128_t uint128_t::operator-() const{
     return ~*this + uint128_1;
 }
 
-const uint64_t & uint128_t::upper() const{
-    return UPPER;
-}
-
-const uint64_t & uint128_t::lower() const{
-    return LOWER;
-}
-
+// Not dispatched: lzcnt saves a cycle over bsr, less than a call through the dispatch check costs
 uint8_t uint128_t::bits() const{
-    uint8_t out = 0;
-    if (UPPER){
-        out = 64;
-        uint64_t up = UPPER;
-        while (up){
-            up >>= 1;
-            out++;
-        }
-    }
-    else{
-        uint64_t low = LOWER;
-        while (low){
-            low >>= 1;
-            out++;
-        }
-    }
+    const uint8_t out = width(UPPER, LOWER);
+    _UINT128_T_STAT(bits, out);
     return out;
 }
 
@@ -548,17 +982,20 @@ std::string uint128_t::str(uint8_t base, const unsigned int & len) const{
     if ((base < 2) || (base > 16)){
         throw std::invalid_argument("Base must be in the range [2, 16]");
     }
-    std::string out = "";
-    if (!(*this)){
-        out = "0";
+    char buf[128];
+    char * end = buf + sizeof(buf);
+    char * start;
+#if defined(_UINT128_T_DISPATCH)
+    if (uint128_dispatch_has(UINT128_CPU_LZCNT | UINT128_CPU_BMI2)){
+        start = format_bmi2(UPPER, LOWER, base, end);
     }
-    else{
-        std::pair <uint128_t, uint128_t> qr(*this, uint128_0);
-        do{
-            qr = divmod(qr.first, base);
-            out = "0123456789abcdef"[(uint8_t) qr.second] + out;
-        } while (qr.first);
+    else
+#endif
+    {
+        start = format_baseline(UPPER, LOWER, base, end);
     }
+    _UINT128_T_STAT(str_digits, end - start);
+    std::string out(start, end);
     if (out.size() < len){
         out = std::string(len - out.size(), '0') + out;
     }
@@ -2,7 +2,9 @@
 #ifndef _UINT128_H_
 #define _UINT128_H_
 #include "uint128_t_config.include"
+// already defined when included from a library source after uint128_t.build
+#ifndef UINT128_T_EXTERN
 #define UINT128_T_EXTERN _UINT128_T_IMPORT
+#endif
 #include "uint128_t.include"
 #endif
-
@@ -0,0 +1,338 @@
+#include "uint128_t.build"
+#include "uint128_text.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_UINT128_T_DISPATCH) || defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define _UINT128_TEXT_SSSE3
+#endif
+
+static const char LOWER_DIGITS[] = "0123456789abcdef";
+static const char UPPER_DIGITS[] = "0123456789ABCDEF";
+
+// value of each hex digit, 0xff for any other character
+struct hex_table{
+    uint8_t value[256];
+
+    hex_table(){
+        std::memset(value, 0xff, sizeof(value));
+        for(uint8_t i = 0; i < 16; i++){
+            value[static_cast <uint8_t> (LOWER_DIGITS[i])] = i;
+            value[static_cast <uint8_t> (UPPER_DIGITS[i])] = i;
+        }
+    }
+};
+
+static const hex_table HEX;
+
+#if defined(_UINT128_TEXT_SSSE3)
+_UINT128_T_TARGET_SSSE3 static void encode_hex_ssse3(const uint8_t * bytes, char * out, const bool uppercase){
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast <const __m128i *> (uppercase?UPPER_DIGITS:LOWER_DIGITS));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i v = _mm_loadu_si128(reinterpret_cast <const __m128i *> (bytes));
+    const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+    _mm_storeu_si128(reinterpret_cast <__m128i *> (out), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast <__m128i *> (out + 16), _mm_unpackhi_epi8(hi, lo));
+}
+
+// chars >= 0x80 compare as negative, so they fail both range checks
+_UINT128_T_TARGET_SSSE3 static bool decode_hex_ssse3(const char * in, uint8_t * bytes){
+    for(std::size_t half = 0; half < 2; half++){
+        const __m128i v = _mm_loadu_si128(reinterpret_cast <const __m128i *> (in + 16 * half));
+        const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+        const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xffff){
+            return false;
+        }
+        const __m128i values = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, _mm_set1_epi8('0'))),
+                                            _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+        // (high nibble, low nibble) pairs to bytes
+        const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0110));
+        _mm_storel_epi64(reinterpret_cast <__m128i *> (bytes + 8 * half), _mm_packus_epi16(pairs, pairs));
+    }
+    return true;
+}
+#endif
+
+// the 32 hex digits of the big endian value, most significant first
+static void encode_hex(const uint128_t & value, char * out, const bool uppercase){
+    uint8_t bytes[UINT128_KEY_SIZE];
+    value.export_key(bytes);
+#if defined(_UINT128_TEXT_SSSE3)
+    if (uint128_dispatch_has(UINT128_CPU_SSSE3)){
+        encode_hex_ssse3(bytes, out, uppercase);
+        return;
+    }
+#endif
+    const char * digits = uppercase?UPPER_DIGITS:LOWER_DIGITS;
+    for(std::size_t i = 0; i < UINT128_KEY_SIZE; i++){
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0f];
+    }
+}
+
+// 32 hex digits to the value; false if any of them is not a hex digit
+static bool decode_hex(const char * in, uint128_t & out){
+    uint8_t bytes[UINT128_KEY_SIZE];
+#if defined(_UINT128_TEXT_SSSE3)
+    if (uint128_dispatch_has(UINT128_CPU_SSSE3)){
+        if (!decode_hex_ssse3(in, bytes)){
+            return false;
+        }
+        out = uint128_t::import_key(bytes);
+        return true;
+    }
+#endif
+    uint8_t bad = 0;
+    for(std::size_t i = 0; i < UINT128_KEY_SIZE; i++){
+        const uint8_t hi = HEX.value[static_cast <uint8_t> (in[2 * i])];
+        const uint8_t lo = HEX.value[static_cast <uint8_t> (in[2 * i + 1])];
+        bad |= hi | lo;
+        bytes[i] = static_cast <uint8_t> ((hi << 4) | (lo & 0x0f));
+    }
+    if (bad & 0xf0){
+        return false;
+    }
+    out = uint128_t::import_key(bytes);
+    return true;
+}
+
+// IPv6 ///////////////////////////////////////////////////////////////////////
+
+static char * format_ipv4(uint32_t addr, char * out){
+    for(int shift = 24; shift >= 0; shift -= 8){
+        const unsigned octet = (addr >> shift) & 0xff;
+        if (octet >= 100){
+            *out++ = static_cast <char> ('0' + octet / 100);
+        }
+        if (octet >= 10){
+            *out++ = static_cast <char> ('0' + (octet / 10) % 10);
+        }
+        *out++ = static_cast <char> ('0' + octet % 10);
+        if (shift){
+            *out++ = '.';
+        }
+    }
+    return out;
+}
+
+// dotted decimal with exactly four octets; leading zeros are rejected since some parsers read them as octal
+static bool parse_ipv4(const char * s, const std::size_t len, uint32_t & out){
+    uint32_t addr = 0;
+    std::size_t i = 0;
+    for(int octet = 0; octet < 4; octet++){
+        if (octet){
+            if ((i == len) || (s[i] != '.')){
+                return false;
+            }
+            i++;
+        }
+        const std::size_t start = i;
+        unsigned value = 0;
+        while ((i < len) && (i - start < 3) && (s[i] >= '0') && (s[i] <= '9')){
+            value = value * 10 + (s[i] - '0');
+            i++;
+        }
+        if ((i == start) || (value > 255) || ((s[start] == '0') && (i - start > 1))){
+            return false;
+        }
+        addr = (addr << 8) | value;
+    }
+    if (i != len){
+        return false;
+    }
+    out = addr;
+    return true;
+}
+
+std::size_t uint128_format_ipv6(const uint128_t & addr, char * out){
+    char * p = out;
+
+    // ::ffff:a.b.c.d
+    if (!addr.upper() && ((addr.lower() >> 32) == 0xffff)){
+        std::memcpy(p, "::ffff:", 7);
+        return format_ipv4(static_cast <uint32_t> (addr.lower()), p + 7) - out;
+    }
+
+    uint16_t groups[8];
+    for(int i = 0; i < 4; i++){
+        groups[i] = static_cast <uint16_t> (addr.upper() >> (48 - 16 * i));
+        groups[i + 4] = static_cast <uint16_t> (addr.lower() >> (48 - 16 * i));
+    }
+
+    // the first longest run of at least two zero groups
+    int zero_start = -1;
+    int zero_len = 1;
+    for(int i = 0; i < 8;){
+        if (groups[i]){
+            i++;
+            continue;
+        }
+        int j = i;
+        while ((j < 8) && !groups[j]){
+            j++;
+        }
+        if (j - i > zero_len){
+            zero_start = i;
+            zero_len = j - i;
+        }
+        i = j;
+    }
+
+    char hex[32];
+    encode_hex(addr, hex, false);
+
+    for(int i = 0; i < 8;){
+        if (i == zero_start){
+            *p++ = ':';
+            *p++ = ':';
+            i += zero_len;
+            continue;
+        }
+        if (i && (i != zero_start + zero_len)){
+            *p++ = ':';
+        }
+        const int digits = (groups[i] >= 0x1000)?4:(groups[i] >= 0x100)?3:(groups[i] >= 0x10)?2:1;
+        std::memcpy(p, hex + 4 * i + 4 - digits, digits);
+        p += digits;
+        i++;
+    }
+    return p - out;
+}
+
+bool uint128_try_parse_ipv6(const char * s, std::size_t len, uint128_t & out){
+    if (!s || (len < 2) || (len > UINT128_IPV6_MAX_SIZE)){
+        return false;
+    }
+
+    uint16_t groups[8];
+    int n = 0;
+    int gap = -1;           // number of groups before the "::"
+    std::size_t i = 0;
+
+    if (s[0] == ':'){
+        if (s[1] != ':'){
+            return false;
+        }
+        gap = 0;
+        i = 2;
+    }
+
+    while (i < len){
+        if (n == 8){
+            return false;
+        }
+
+        const std::size_t start = i;
+        unsigned value = 0;
+        while ((i < len) && (i - start < 5) && (HEX.value[static_cast <uint8_t> (s[i])] != 0xff)){
+            value = (value << 4) | HEX.value[static_cast <uint8_t> (s[i])];
+            i++;
+        }
+
+        // an IPv4 tail takes the place of the last two groups
+        if ((i < len) && (s[i] == '.')){
+            uint32_t ipv4;
+            if ((n > 6) || !parse_ipv4(s + start, len - start, ipv4)){
+                return false;
+            }
+            groups[n++] = static_cast <uint16_t> (ipv4 >> 16);
+            groups[n++] = static_cast <uint16_t> (ipv4);
+            break;
+        }
+
+        if ((i == start) || (i - start > 4)){
+            return false;
+        }
+        groups[n++] = static_cast <uint16_t> (value);
+
+        if (i == len){
+            break;
+        }
+        if ((s[i] != ':') || (++i == len)){
+            return false;
+        }
+        if (s[i] == ':'){
+            if (gap >= 0){
+                return false;
+            }
+            gap = n;
+            i++;
+        }
+    }
+
+    if ((gap < 0)?(n != 8):(n > 7)){
+        return false;
+    }
+
+    // the groups after the gap move to the end
+    uint16_t full[8] = {0};
+    const int before = (gap < 0)?n:gap;
+    for(int g = 0; g < before; g++){
+        full[g] = groups[g];
+    }
+    for(int g = before; g < n; g++){
+        full[8 - n + g] = groups[g];
+    }
+
+    uint64_t upper = 0;
+    uint64_t lower = 0;
+    for(int g = 0; g < 4; g++){
+        upper = (upper << 16) | full[g];
+        lower = (lower << 16) | full[g + 4];
+    }
+    out = uint128_t(upper, lower);
+    return true;
+}
+
+uint128_t uint128_parse_ipv6(const char * s, std::size_t len){
+    uint128_t out;
+    if (!uint128_try_parse_ipv6(s, len, out)){
+        throw std::invalid_argument("Error: not an IPv6 address");
+    }
+    return out;
+}
+
+// UUID ///////////////////////////////////////////////////////////////////////
+
+// hex digit runs of the 8-4-4-4-12 form: offset in the text, length
+static const std::size_t UUID_RUNS[5][2] = {{0, 8}, {9, 4}, {14, 4}, {19, 4}, {24, 12}};
+
+std::size_t uint128_format_uuid(const uint128_t & uuid, char * out, bool uppercase){
+    char hex[32];
+    encode_hex(uuid, hex, uppercase);
+    const char * from = hex;
+    for(std::size_t r = 0; r < 5; r++){
+        std::memcpy(out + UUID_RUNS[r][0], from, UUID_RUNS[r][1]);
+        from += UUID_RUNS[r][1];
+        if (r < 4){
+            out[UUID_RUNS[r][0] + UUID_RUNS[r][1]] = '-';
+        }
+    }
+    return UINT128_UUID_SIZE;
+}
+
+bool uint128_try_parse_uuid(const char * s, std::size_t len, uint128_t & out){
+    if (!s || (len != UINT128_UUID_SIZE) || (s[8] != '-') || (s[13] != '-') || (s[18] != '-') || (s[23] != '-')){
+        return false;
+    }
+    char hex[32];
+    char * to = hex;
+    for(std::size_t r = 0; r < 5; r++){
+        std::memcpy(to, s + UUID_RUNS[r][0], UUID_RUNS[r][1]);
+        to += UUID_RUNS[r][1];
+    }
+    return decode_hex(hex, out);
+}
+
+uint128_t uint128_parse_uuid(const char * s, std::size_t len){
+    uint128_t out;
+    if (!uint128_try_parse_uuid(s, len, out)){
+        throw std::invalid_argument("Error: not a UUID");
+    }
+    return out;
+}
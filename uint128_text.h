@@ -0,0 +1,41 @@
+/*
+uint128_text.h
+IPv6 address and UUID text formats
+
+Formatting writes into a caller supplied buffer and returns the number of characters
+written; no terminating NUL is added. Parsing reads exactly len characters. Nothing
+allocates.
+
+IPv6 addresses are formatted in the RFC 5952 canonical form: lowercase hex without leading
+zeros, the first longest run of two or more zero groups replaced by "::", and IPv4-mapped
+addresses (::ffff:0:0/96) ending in dotted decimal. The parser accepts any RFC 4291 text
+form, including "::" and a dotted decimal IPv4 tail, but not zone ids ("%eth0").
+
+UUIDs are the 8-4-4-4-12 hex form, read with either case.
+
+The uint128_parse_* functions throw std::invalid_argument on malformed text; the
+uint128_try_parse_* functions return false instead and leave out unchanged.
+*/
+
+#ifndef __UINT128_TEXT__
+#define __UINT128_TEXT__
+
+#include <cstddef>
+
+#include "uint128_t.h"
+
+// longest IPv6 text: "ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255"
+static constexpr std::size_t UINT128_IPV6_MAX_SIZE = 45;
+static constexpr std::size_t UINT128_UUID_SIZE = 36;
+
+// out must hold UINT128_IPV6_MAX_SIZE characters
+UINT128_T_EXTERN std::size_t uint128_format_ipv6(const uint128_t & addr, char * out);
+UINT128_T_EXTERN bool uint128_try_parse_ipv6(const char * s, std::size_t len, uint128_t & out);
+UINT128_T_EXTERN uint128_t uint128_parse_ipv6(const char * s, std::size_t len);
+
+// out must hold UINT128_UUID_SIZE characters
+UINT128_T_EXTERN std::size_t uint128_format_uuid(const uint128_t & uuid, char * out, bool uppercase = false);
+UINT128_T_EXTERN bool uint128_try_parse_uuid(const char * s, std::size_t len, uint128_t & out);
+UINT128_T_EXTERN uint128_t uint128_parse_uuid(const char * s, std::size_t len);
+
+#endif
@@ -0,0 +1,630 @@
+#include "uint256_t.build"
+
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#if defined(__BMI2__) && defined(__ADX__)
+#include <immintrin.h>
+#define _UINT256_T_ADX
+#endif
+
+// The arithmetic works on the value as 4 words, least significant first.
+static const std::size_t WORDS = 4;
+
+static inline void split(const uint256_t & x, uint64_t * w){
+    w[0] = x.lower().lower();
+    w[1] = x.lower().upper();
+    w[2] = x.upper().lower();
+    w[3] = x.upper().upper();
+}
+
+static inline uint256_t join(const uint64_t * w){
+    return uint256_t(uint128_t(w[3], w[2]), uint128_t(w[1], w[0]));
+}
+
+// number of words up to the most significant nonzero one
+static inline std::size_t length(const uint64_t * w, std::size_t n){
+    while (n && !w[n - 1]){
+        n--;
+    }
+    return n;
+}
+
+// x != 0
+static inline unsigned leading_zeros(uint64_t x){
+#if defined(__GNUC__)
+    return __builtin_clzll(static_cast <unsigned long long> (x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - index;
+#else
+    unsigned out = 0;
+    while (!(x >> 63)){
+        x <<= 1;
+        out++;
+    }
+    return out;
+#endif
+}
+
+// returns the low word of a * b and writes the high word to hi
+static inline uint64_t mul_word(const uint64_t a, const uint64_t b, uint64_t & hi){
+#if defined(_UINT256_T_ADX)
+    unsigned long long high;
+    const uint64_t low = _mulx_u64(a, b, &high);
+    hi = high;
+    return low;
+#else
+    return uint128_t::multlong64(a, b, &hi);
+#endif
+}
+
+// out = x + y + carry; returns the carry out
+static inline unsigned char add_word(const unsigned char carry, const uint64_t x, const uint64_t y, uint64_t & out){
+#if defined(_UINT256_T_ADX)
+    unsigned long long sum;
+    const unsigned char c = _addcarryx_u64(carry, x, y, &sum);
+    out = sum;
+    return c;
+#else
+    const uint64_t sum = x + y;
+    out = sum + carry;
+    return (sum < x) | (out < sum);
+#endif
+}
+
+// out = x - y - borrow; returns the borrow out
+static inline unsigned char sub_word(const unsigned char borrow, const uint64_t x, const uint64_t y, uint64_t & out){
+    const uint64_t diff = x - y;
+    out = diff - borrow;
+    return (x < y) | (diff < borrow);
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+// out[0, 4] += a * b[0, 4) with out[4] == 0
+// Compilers emit adc for both chains of _addcarryx_u64, which serializes them on CF, so the row
+// is written out with adcx (CF) for the low words and adox (OF) for the high words. The assembler
+// takes these without -mbmi2 -madx; multiply checks that the CPU has them.
+static inline void add_row(const uint64_t a, const uint64_t * b, uint64_t * out){
+    uint64_t o0 = out[0], o1 = out[1], o2 = out[2], o3 = out[3], o4 = out[4];
+    uint64_t lo, hi;
+    __asm__(
+        "xorl %k[lo], %k[lo]\n\t"       // clears CF and OF
+        "mulxq %[b0], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[o0]\n\t"
+        "adoxq %[hi], %[o1]\n\t"
+        "mulxq %[b1], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[o1]\n\t"
+        "adoxq %[hi], %[o2]\n\t"
+        "mulxq %[b2], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[o2]\n\t"
+        "adoxq %[hi], %[o3]\n\t"
+        "mulxq %[b3], %[lo], %[hi]\n\t"
+        "adcxq %[lo], %[o3]\n\t"
+        "adoxq %[hi], %[o4]\n\t"
+        "movl $0, %k[lo]\n\t"           // mov leaves the flags alone
+        "adcxq %[lo], %[o4]"
+        : [o0] "+&r"(o0), [o1] "+&r"(o1), [o2] "+&r"(o2), [o3] "+&r"(o3), [o4] "+&r"(o4), [lo] "=&r"(lo), [hi] "=&r"(hi)
+        : "d"(a), [b0] "m"(b[0]), [b1] "m"(b[1]), [b2] "m"(b[2]), [b3] "m"(b[3])
+        : "cc");
+    out[0] = o0;
+    out[1] = o1;
+    out[2] = o2;
+    out[3] = o3;
+    out[4] = o4;
+}
+#define _UINT256_T_ADX_ROW
+#endif
+
+// out[0, N) = the low N words of a * b
+//
+// Each row adds a[i] * b into out[i, i + 4] with two carry chains: one for the low words of
+// the products and one for the high words, one word further up. The chains do not depend on
+// each other, which is what adcx and adox (two carry flags) are for. Before row i, out[i + 4]
+// is still 0 and the row's total fits, so neither chain carries past it.
+template <std::size_t N>
+static inline void multiply(const uint64_t * a, const uint64_t * b, uint64_t * out){
+    std::fill(out, out + N, 0);
+#if defined(_UINT256_T_ADX_ROW)
+    // full rows only; the rows of a truncated product are cut short
+    const bool adx = (N > WORDS) && uint128_dispatch_has(UINT128_CPU_BMI2 | UINT128_CPU_ADX);
+#endif
+    for(std::size_t i = 0; i < WORDS; i++){
+#if defined(_UINT256_T_ADX_ROW)
+        if (adx && (i + WORDS < N)){
+            add_row(a[i], b, out + i);
+            continue;
+        }
+#endif
+        unsigned char lo_carry = 0;
+        unsigned char hi_carry = 0;
+        for(std::size_t j = 0; (j < WORDS) && (i + j < N); j++){
+            uint64_t hi;
+            const uint64_t lo = mul_word(a[i], b[j], hi);
+            lo_carry = add_word(lo_carry, out[i + j], lo, out[i + j]);
+            if (i + j + 1 < N){
+                hi_carry = add_word(hi_carry, out[i + j + 1], hi, out[i + j + 1]);
+            }
+        }
+        if (i + WORDS < N){
+            out[i + WORDS] += lo_carry;
+        }
+    }
+}
+
+// w[0, n) /= d; returns the remainder
+static inline uint64_t short_divide(uint64_t * w, const std::size_t n, const uint64_t d){
+    uint64_t r = 0;
+    for(std::size_t i = n; i-- > 0;){
+        w[i] = uint128_t::divlong64(r, w[i], d, &r);
+    }
+    return r;
+}
+
+// Knuth, TAOCP vol. 2, 4.3.1, algorithm D, on 64-bit words:
+// q[0, m - n] = u / v and r[0, n) = u % v for u of m words and v of n words, 2 <= n <= m
+static void long_divide(const uint64_t * u, const std::size_t m, const uint64_t * v, const std::size_t n, uint64_t * q, uint64_t * r){
+    // normalize, so that the top bit of the divisor is set and the quotient estimates are at most 2 too large
+    const unsigned s = leading_zeros(v[n - 1]);
+    uint64_t vn[WORDS];
+    uint64_t un[WORDS + 1];
+    for(std::size_t i = n - 1; i > 0; i--){
+        vn[i] = (v[i] << s) | (s?(v[i - 1] >> (64 - s)):0);
+    }
+    vn[0] = v[0] << s;
+    un[m] = s?(u[m - 1] >> (64 - s)):0;
+    for(std::size_t i = m - 1; i > 0; i--){
+        un[i] = (u[i] << s) | (s?(u[i - 1] >> (64 - s)):0);
+    }
+    un[0] = u[0] << s;
+
+    for(std::size_t j = m - n + 1; j-- > 0;){
+        // estimate the quotient word from the top two words of the remainder and the top word of the divisor
+        uint64_t qhat;
+        uint64_t rhat;
+        bool large;                     // rhat >= 2^64, so that the estimate cannot be too large
+        if (un[j + n] >= vn[n - 1]){
+            // un[j + n] == vn[n - 1]: the estimate would be 2^64 or more
+            qhat = ~0ULL;
+            rhat = un[j + n - 1] + vn[n - 1];
+            large = rhat < vn[n - 1];
+        }
+        else{
+            qhat = uint128_t::divlong64(un[j + n], un[j + n - 1], vn[n - 1], &rhat);
+            large = false;
+        }
+        while (!large){
+            uint64_t hi;
+            const uint64_t lo = uint128_t::multlong64(qhat, vn[n - 2], &hi);
+            if ((hi < rhat) || ((hi == rhat) && (lo <= un[j + n - 2]))){
+                break;
+            }
+            qhat--;
+            rhat += vn[n - 1];
+            large = rhat < vn[n - 1];
+        }
+
+        // multiply and subtract
+        uint64_t carry = 0;
+        unsigned char borrow = 0;
+        for(std::size_t i = 0; i < n; i++){
+            uint64_t hi;
+            uint64_t lo = uint128_t::multlong64(qhat, vn[i], &hi);
+            lo += carry;
+            hi += lo < carry;
+            carry = hi;
+            borrow = sub_word(borrow, un[i + j], lo, un[i + j]);
+        }
+        borrow = sub_word(borrow, un[j + n], carry, un[j + n]);
+
+        // the estimate was 1 too large: add the divisor back
+        if (borrow){
+            qhat--;
+            unsigned char c = 0;
+            for(std::size_t i = 0; i < n; i++){
+                c = add_word(c, un[i + j], vn[i], un[i + j]);
+            }
+            un[j + n] += c;
+        }
+        q[j] = qhat;
+    }
+
+    // unnormalize the remainder
+    for(std::size_t i = 0; i < n; i++){
+        r[i] = (un[i] >> s) | (s?(un[i + 1] << (64 - s)):0);
+    }
+}
+
+uint256_t::uint256_t(const std::string & s, uint8_t base)
+    : uint256_t(s.c_str(), s.size(), base)
+{}
+
+uint256_t::uint256_t(const char *s, std::size_t len, uint8_t base)
+    : uint256_t(0)
+{
+    if ((base < 2) || (base > 16)){
+        throw std::invalid_argument("Base must be in the range [2, 16]");
+    }
+    if (!s){
+        return;
+    }
+    while (len && *s && std::isspace(*s)){
+        ++s;
+        len--;
+    }
+
+    uint64_t w[WORDS] = {0, 0, 0, 0};
+    for(; len && *s; ++s, len--){
+        const char c = static_cast <char> (std::tolower(*s));
+        const unsigned digit = (('0' <= c) && (c <= '9'))?(c - '0'):((('a' <= c) && (c <= 'f'))?(c - 'a' + 10):16);
+        if (digit >= base){
+            break;
+        }
+        // w = w * base + digit
+        uint64_t carry = digit;
+        for(std::size_t i = 0; i < WORDS; i++){
+            uint64_t hi;
+            const uint64_t lo = uint128_t::multlong64(w[i], base, &hi);
+            w[i] = lo + carry;
+            carry = hi + (w[i] < lo);
+        }
+    }
+    *this = join(w);
+}
+
+uint256_t::uint256_t(const bool & b)
+    : uint256_t((uint8_t) b)
+{}
+
+uint256_t & uint256_t::operator=(const bool & rhs){
+    UPPER = 0;
+    LOWER = rhs;
+    return *this;
+}
+
+uint256_t::operator bool() const{
+    return (bool) (UPPER | LOWER);
+}
+
+uint256_t::operator uint8_t() const{
+    return (uint8_t) LOWER;
+}
+
+uint256_t::operator uint16_t() const{
+    return (uint16_t) LOWER;
+}
+
+uint256_t::operator uint32_t() const{
+    return (uint32_t) LOWER;
+}
+
+uint256_t::operator uint64_t() const{
+    return (uint64_t) LOWER;
+}
+
+uint256_t uint256_t::operator&(const uint256_t & rhs) const{
+    return uint256_t(UPPER & rhs.UPPER, LOWER & rhs.LOWER);
+}
+
+void uint256_t::export_bits(std::vector<uint8_t> & ret) const{
+    UPPER.export_bits(ret);
+    LOWER.export_bits(ret);
+}
+
+uint256_t & uint256_t::operator&=(const uint256_t & rhs){
+    UPPER &= rhs.UPPER;
+    LOWER &= rhs.LOWER;
+    return *this;
+}
+
+uint256_t uint256_t::operator|(const uint256_t & rhs) const{
+    return uint256_t(UPPER | rhs.UPPER, LOWER | rhs.LOWER);
+}
+
+uint256_t & uint256_t::operator|=(const uint256_t & rhs){
+    UPPER |= rhs.UPPER;
+    LOWER |= rhs.LOWER;
+    return *this;
+}
+
+uint256_t uint256_t::operator^(const uint256_t & rhs) const{
+    return uint256_t(UPPER ^ rhs.UPPER, LOWER ^ rhs.LOWER);
+}
+
+uint256_t & uint256_t::operator^=(const uint256_t & rhs){
+    UPPER ^= rhs.UPPER;
+    LOWER ^= rhs.LOWER;
+    return *this;
+}
+
+uint256_t uint256_t::operator~() const{
+    return uint256_t(~UPPER, ~LOWER);
+}
+
+uint256_t uint256_t::operator<<(const uint256_t & rhs) const{
+    if (rhs.UPPER || rhs.LOWER.upper() || (rhs.LOWER.lower() >= 256)){
+        return uint256_0;
+    }
+    const std::size_t words = rhs.LOWER.lower() / 64;
+    const unsigned bits = rhs.LOWER.lower() % 64;
+    uint64_t w[WORDS];
+    uint64_t out[WORDS];
+    split(*this, w);
+    for(std::size_t i = 0; i < WORDS; i++){
+        if (i < words){
+            out[i] = 0;
+        }
+        else{
+            const std::size_t src = i - words;
+            out[i] = (w[src] << bits) | ((bits && src)?(w[src - 1] >> (64 - bits)):0);
+        }
+    }
+    return join(out);
+}
+
+uint256_t & uint256_t::operator<<=(const uint256_t & rhs){
+    *this = *this << rhs;
+    return *this;
+}
+
+uint256_t uint256_t::operator>>(const uint256_t & rhs) const{
+    if (rhs.UPPER || rhs.LOWER.upper() || (rhs.LOWER.lower() >= 256)){
+        return uint256_0;
+    }
+    const std::size_t words = rhs.LOWER.lower() / 64;
+    const unsigned bits = rhs.LOWER.lower() % 64;
+    uint64_t w[WORDS];
+    uint64_t out[WORDS];
+    split(*this, w);
+    for(std::size_t i = 0; i < WORDS; i++){
+        const std::size_t src = i + words;
+        if (src >= WORDS){
+            out[i] = 0;
+        }
+        else{
+            out[i] = (w[src] >> bits) | ((bits && (src + 1 < WORDS))?(w[src + 1] << (64 - bits)):0);
+        }
+    }
+    return join(out);
+}
+
+uint256_t & uint256_t::operator>>=(const uint256_t & rhs){
+    *this = *this >> rhs;
+    return *this;
+}
+
+bool uint256_t::operator!() const{
+    return !(bool) *this;
+}
+
+bool uint256_t::operator&&(const uint256_t & rhs) const{
+    return ((bool) *this && (bool) rhs);
+}
+
+bool uint256_t::operator||(const uint256_t & rhs) const{
+    return ((bool) *this || (bool) rhs);
+}
+
+bool uint256_t::operator==(const uint256_t & rhs) const{
+    return ((UPPER == rhs.UPPER) && (LOWER == rhs.LOWER));
+}
+
+bool uint256_t::operator!=(const uint256_t & rhs) const{
+    return !(*this == rhs);
+}
+
+bool uint256_t::operator>(const uint256_t & rhs) const{
+    return rhs < *this;
+}
+
+bool uint256_t::operator<(const uint256_t & rhs) const{
+    if (UPPER == rhs.UPPER){
+        return (LOWER < rhs.LOWER);
+    }
+    return (UPPER < rhs.UPPER);
+}
+
+bool uint256_t::operator>=(const uint256_t & rhs) const{
+    return !(*this < rhs);
+}
+
+bool uint256_t::operator<=(const uint256_t & rhs) const{
+    return !(rhs < *this);
+}
+
+uint256_t uint256_t::operator+(const uint256_t & rhs) const{
+    uint64_t a[WORDS];
+    uint64_t b[WORDS];
+    split(*this, a);
+    split(rhs, b);
+    unsigned char carry = 0;
+    for(std::size_t i = 0; i < WORDS; i++){
+        carry = add_word(carry, a[i], b[i], a[i]);
+    }
+    return join(a);
+}
+
+uint256_t & uint256_t::operator+=(const uint256_t & rhs){
+    *this = *this + rhs;
+    return *this;
+}
+
+uint256_t uint256_t::operator-(const uint256_t & rhs) const{
+    uint64_t a[WORDS];
+    uint64_t b[WORDS];
+    split(*this, a);
+    split(rhs, b);
+    unsigned char borrow = 0;
+    for(std::size_t i = 0; i < WORDS; i++){
+        borrow = sub_word(borrow, a[i], b[i], a[i]);
+    }
+    return join(a);
+}
+
+uint256_t & uint256_t::operator-=(const uint256_t & rhs){
+    *this = *this - rhs;
+    return *this;
+}
+
+uint256_t uint256_t::mul_wide(const uint256_t & lhs, const uint256_t & rhs, uint256_t *high){
+    uint64_t a[WORDS];
+    uint64_t b[WORDS];
+    uint64_t out[2 * WORDS];
+    split(lhs, a);
+    split(rhs, b);
+    multiply <2 * WORDS> (a, b, out);
+    *high = join(out + WORDS);
+    return join(out);
+}
+
+uint256_t uint256_t::operator*(const uint256_t & rhs) const{
+    uint64_t a[WORDS];
+    uint64_t b[WORDS];
+    uint64_t out[WORDS];
+    split(*this, a);
+    split(rhs, b);
+    multiply <WORDS> (a, b, out);
+    return join(out);
+}
+
+uint256_t & uint256_t::operator*=(const uint256_t & rhs){
+    *this = *this * rhs;
+    return *this;
+}
+
+std::pair <uint256_t, uint256_t> uint256_t::divmod(const uint256_t & lhs, const uint256_t & rhs){
+    uint64_t u[WORDS];
+    uint64_t v[WORDS];
+    split(lhs, u);
+    split(rhs, v);
+    const std::size_t n = length(v, WORDS);
+    if (!n){
+        throw std::domain_error("Error: division or modulus by 0");
+    }
+    if (lhs < rhs){
+        return std::pair <uint256_t, uint256_t> (uint256_0, lhs);
+    }
+    const std::size_t m = length(u, WORDS);
+
+    if (n == 1){
+        const uint64_t r = short_divide(u, m, v[0]);
+        return std::pair <uint256_t, uint256_t> (join(u), uint256_t(r));
+    }
+
+    uint64_t q[WORDS] = {0, 0, 0, 0};
+    uint64_t r[WORDS] = {0, 0, 0, 0};
+    long_divide(u, m, v, n, q, r);
+    return std::pair <uint256_t, uint256_t> (join(q), join(r));
+}
+
+uint256_t uint256_t::operator/(const uint256_t & rhs) const{
+    return divmod(*this, rhs).first;
+}
+
+uint256_t & uint256_t::operator/=(const uint256_t & rhs){
+    *this = *this / rhs;
+    return *this;
+}
+
+uint256_t uint256_t::operator%(const uint256_t & rhs) const{
+    return divmod(*this, rhs).second;
+}
+
+uint256_t & uint256_t::operator%=(const uint256_t & rhs){
+    *this = *this % rhs;
+    return *this;
+}
+
+uint256_t & uint256_t::operator++(){
+    return *this += uint256_1;
+}
+
+uint256_t uint256_t::operator++(int){
+    uint256_t temp(*this);
+    ++*this;
+    return temp;
+}
+
+uint256_t & uint256_t::operator--(){
+    return *this -= uint256_1;
+}
+
+uint256_t uint256_t::operator--(int){
+    uint256_t temp(*this);
+    --*this;
+    return temp;
+}
+
+uint256_t uint256_t::operator+() const{
+    return *this;
+}
+
+uint256_t uint256_t::operator-() const{
+    return ~*this + uint256_1;
+}
+
+uint16_t uint256_t::bits() const{
+    uint64_t w[WORDS];
+    split(*this, w);
+    const std::size_t n = length(w, WORDS);
+    return n?static_cast <uint16_t> (64 * n - leading_zeros(w[n - 1])):0;
+}
+
+std::string uint256_t::str(uint8_t base, const unsigned int & len) const{
+    if ((base < 2) || (base > 16)){
+        throw std::invalid_argument("Base must be in the range [2, 16]");
+    }
+
+    // the largest power of the base that fits in a word
+    uint64_t chunk = base;
+    unsigned chunk_digits = 1;
+    while (chunk <= ~0ULL / base){
+        chunk *= base;
+        chunk_digits++;
+    }
+
+    uint64_t w[WORDS];
+    split(*this, w);
+    std::size_t n = length(w, WORDS);
+
+    // digits are written backwards from the end of the buffer
+    char buf[256];
+    char * out = buf + sizeof(buf);
+    while (n){
+        uint64_t r = short_divide(w, n, chunk);
+        n = length(w, n);
+        // every chunk below the top one has exactly chunk_digits digits
+        for(unsigned i = 0; (n && (i < chunk_digits)) || r; i++){
+            *--out = "0123456789abcdef"[r % base];
+            r /= base;
+        }
+    }
+    if (out == buf + sizeof(buf)){
+        *--out = '0';
+    }
+
+    std::string digits(out, buf + sizeof(buf));
+    if (digits.size() < len){
+        digits = std::string(len - digits.size(), '0') + digits;
+    }
+    return digits;
+}
+
+uint64_t uint256_t::hash(const uint64_t seed) const{
+    return UPPER.hash(LOWER.hash(seed));
+}
+
+std::ostream & operator<<(std::ostream & stream, const uint256_t & rhs){
+    if (stream.flags() & stream.oct){
+        stream << rhs.str(8);
+    }
+    else if (stream.flags() & stream.dec){
+        stream << rhs.str(10);
+    }
+    else if (stream.flags() & stream.hex){
+        stream << rhs.str(16);
+    }
+    return stream;
+}
@@ -0,0 +1,6 @@
+// PUBLIC IMPORT HEADER
+#ifndef _UINT256_H_
+#define _UINT256_H_
+#include "uint128_t.h"
+#include "uint256_t.include"
+#endif